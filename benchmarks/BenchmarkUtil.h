@@ -0,0 +1,97 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef BENCHMARKUTIL_H
+#define BENCHMARKUTIL_H
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+// Benchmarks are ordinary gtest cases in the `benchmarks` target. They are not registered with ctest,
+// run them with `./benchmarks [--gtest_filter=...]`. KAHWA_BENCH_SCALE multiplies the workload sizes.
+
+namespace bench {
+
+inline std::size_t scale(const std::size_t n) {
+    static const double factor = [] {
+        const char* env = std::getenv("KAHWA_BENCH_SCALE");
+        return env ? std::atof(env) : 1.0;
+    }();
+    return std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(n) * factor));
+}
+
+class Stopwatch {
+public:
+    Stopwatch(): start(std::chrono::steady_clock::now()) {}
+
+    [[nodiscard]] double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Runs `fn` `iterations` times and returns the fastest run in seconds.
+template <typename Fn>
+double timeBest(const int iterations, Fn&& fn) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; i++) {
+        Stopwatch stopwatch;
+        fn();
+        best = std::min(best, stopwatch.seconds());
+    }
+    return best;
+}
+
+// Resident set size of this process, 0 where /proc is not available
+inline std::size_t residentBytes() {
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * 4096;
+}
+
+inline void report(const std::string& name, const double value, const std::string& unit) {
+    std::cout << "[ BENCH    ] " << std::left << std::setw(48) << name << std::right << std::setw(16)
+              << std::fixed << std::setprecision(2) << value << " " << unit << std::endl;
+    testing::Test::RecordProperty(name, std::to_string(value));
+}
+
+// Generated Kahwa source in the shape of our code generators' output: mostly typedefs and
+// identifiers, with comments, literals and operators mixed in.
+inline std::string generateSource(const std::size_t decls) {
+    std::string src;
+    src.reserve(decls * 96);
+    for (std::size_t i = 0; i < decls; i++) {
+        const std::string n = std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                src += "// generated declaration " + n + "\n";
+                src += "public typedef Base" + n + " Alias" + n + ";\n";
+                break;
+            case 1:
+                src += "private static typedef some_type_" + std::to_string(i % 97) + " value_" + n + ";\n";
+                break;
+            case 2:
+                src += "/* block comment for " + n + " */ typedef Map Lookup" + n + ";\n";
+                break;
+            default:
+                src += "x" + n + " = \"literal " + n + "\" + " + n + " * 3.25 <<= y" + n + ";\n";
+                break;
+        }
+    }
+    return src;
+}
+
+}
+
+
+
+#endif //BENCHMARKUTIL_H
@@ -0,0 +1,81 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/arena/Arena.h"
+#include "../../include/parser/ClassDecl.h"
+#include "../../include/parser/KahwaFile.h"
+#include "../../include/parser/TypedefDecl.h"
+
+namespace {
+
+// Stand-ins with the size and alignment of the AST nodes, without the heap-allocated members
+template <typename T>
+struct Shaped {
+    alignas(T) char bytes[sizeof(T)];
+};
+
+// What parsing one generated file allocates: mostly typedefs, each with a TypeRef, and the odd class
+template <typename Allocate>
+void allocateFile(const std::size_t decls, Allocate&& allocate) {
+    for (std::size_t i = 0; i < decls; i++) {
+        allocate.template operator()<Shaped<TypeRef>>();
+        if (i % 8 == 0) {
+            allocate.template operator()<Shaped<ClassDecl>>();
+        } else {
+            allocate.template operator()<Shaped<TypedefDecl>>();
+        }
+    }
+    allocate.template operator()<Shaped<KahwaFile>>();
+}
+
+}
+
+TEST(ArenaBenchmark, ArenaVersusNewDelete) {
+    const std::size_t requests = bench::scale(200);
+    const std::size_t decls = 10'000;
+    std::size_t nodes = 0;
+    allocateFile(decls, [&]<typename T> { nodes++; });
+    const double total = static_cast<double>(nodes * requests);
+
+    // Every variant keeps its nodes reachable until the end of the request, as the parser does
+    std::vector<void*> live;
+    live.reserve(nodes);
+    const double new_delete_s = bench::timeBest(3, [&] {
+        for (std::size_t r = 0; r < requests; r++) {
+            allocateFile(decls, [&]<typename T> { live.push_back(new T); });
+            for (void* node : live) ::operator delete(node);
+            live.clear();
+        }
+    });
+
+    // An arena per request, as a service that throws its arenas away would do
+    const double fresh_arena_s = bench::timeBest(3, [&] {
+        for (std::size_t r = 0; r < requests; r++) {
+            Arena arena;
+            allocateFile(decls, [&]<typename T> { live.push_back(arena.make<T>()); });
+            live.clear();
+        }
+    });
+
+    Arena arena;
+    const double reset_arena_s = bench::timeBest(3, [&] {
+        for (std::size_t r = 0; r < requests; r++) {
+            arena.reset();
+            allocateFile(decls, [&]<typename T> { live.push_back(arena.make<T>()); });
+            live.clear();
+        }
+    });
+    const Arena::Stats stats = arena.stats();
+
+    bench::report("nodes per request", static_cast<double>(nodes), "nodes");
+    bench::report("new/delete", total / new_delete_s / 1e6, "Mnodes/s");
+    bench::report("arena per request", total / fresh_arena_s / 1e6, "Mnodes/s");
+    bench::report("arena reset between requests", total / reset_arena_s / 1e6, "Mnodes/s");
+    bench::report("arena: bytes used per request", static_cast<double>(stats.bytes_used) / 1e3, "KB");
+    bench::report("arena: alignment padding", static_cast<double>(stats.bytes_padding), "B");
+    bench::report("arena: reserved", static_cast<double>(stats.bytes_reserved) / 1e3, "KB");
+    bench::report("arena: blocks", static_cast<double>(stats.block_count), "blocks");
+    bench::report("arena: high-water mark", static_cast<double>(stats.high_water_mark) / 1e3, "KB");
+}
@@ -0,0 +1,60 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <mutex>
+#include <thread>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/arena/Arena.h"
+#include "../../include/arena/ConcurrentArena.h"
+#include "../../include/parser/ClassDecl.h"
+#include "../../include/parser/TypedefDecl.h"
+
+namespace {
+
+// Stand-in with the size and alignment of a typedef node, without the heap-allocated members
+struct Node {
+    alignas(TypedefDecl) char bytes[sizeof(TypedefDecl)];
+};
+
+// Runs `work` on `threads` threads at once, after `reset`, and returns the best wall time
+template <typename Reset, typename Work>
+double runThreads(const std::size_t threads, Reset&& reset, Work&& work) {
+    return bench::timeBest(3, [&] {
+        reset();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; t++) workers.emplace_back(work);
+        for (auto& worker : workers) worker.join();
+    });
+}
+
+}
+
+TEST(ConcurrentArenaBenchmark, ContentionByThreadCount) {
+    const std::size_t per_thread = bench::scale(50'000);
+
+    for (const std::size_t threads : {1, 2, 4, 8, 16, 32}) {
+        const double total = static_cast<double>(per_thread * threads);
+
+        // What sharing an Arena between threads takes without ConcurrentArena
+        Arena arena;
+        std::mutex mutex;
+        const double locked_s = runThreads(threads, [&] { arena.reset(); }, [&] {
+            for (std::size_t i = 0; i < per_thread; i++) {
+                std::lock_guard lock{mutex};
+                arena.make<Node>();
+            }
+        });
+
+        ConcurrentArena concurrent;
+        const double concurrent_s = runThreads(threads, [&] { concurrent.reset(); }, [&] {
+            for (std::size_t i = 0; i < per_thread; i++) concurrent.make<Node>();
+        });
+
+        const std::string prefix = std::to_string(threads) + " threads: ";
+        bench::report(prefix + "mutex + Arena", total / locked_s / 1e6, "Mnodes/s");
+        bench::report(prefix + "ConcurrentArena", total / concurrent_s / 1e6, "Mnodes/s");
+        bench::report(prefix + "ConcurrentArena chunks", static_cast<double>(concurrent.chunkCount()), "chunks");
+    }
+}
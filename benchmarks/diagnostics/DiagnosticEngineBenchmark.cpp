@@ -0,0 +1,110 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/diagnostics/DiagnosticEngine.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// Runs `work` on `threads` threads at once, after `reset`, and returns the best wall time
+template <typename Reset, typename Work>
+double runThreads(const std::size_t threads, Reset&& reset, Work&& work) {
+    return bench::timeBest(3, [&] {
+        reset();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; t++) workers.emplace_back(work);
+        for (auto& worker : workers) worker.join();
+    });
+}
+
+}
+
+TEST(DiagnosticEngineBenchmark, ContentionByThreadCount) {
+    const std::size_t per_thread = bench::scale(50'000);
+
+    for (const std::size_t threads : {1, 2, 4, 8, 16}) {
+        const double total = static_cast<double>(per_thread * threads);
+
+        // What sharing one engine takes without the shards
+        std::vector<Diagnostic> diagnostics;
+        std::mutex mutex;
+        const double locked_s = runThreads(threads, [&] { diagnostics.clear(); }, [&] {
+            for (std::size_t i = 0; i < per_thread; i++) {
+                std::lock_guard lock{mutex};
+                diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{i}});
+            }
+        });
+
+        auto engine = std::make_unique<DiagnosticEngine>();
+        const double sharded_s = runThreads(threads, [&] { engine = std::make_unique<DiagnosticEngine>(); }, [&] {
+            for (std::size_t i = 0; i < per_thread; i++) {
+                engine->reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+            }
+        });
+        const double merge_s = bench::timeBest(1, [&] { ASSERT_EQ(engine->getAll().size(), per_thread * threads); });
+
+        const std::string prefix = std::to_string(threads) + " threads: ";
+        bench::report(prefix + "mutex + vector", total / locked_s / 1e6, "Mdiagnostics/s");
+        bench::report(prefix + "DiagnosticEngine", total / sharded_s / 1e6, "Mdiagnostics/s");
+        bench::report(prefix + "DiagnosticEngine getAll", merge_s * 1e3, "ms");
+    }
+}
+
+TEST(DiagnosticEngineBenchmark, GarbageInputFloodsUnrecognisedTokens) {
+    // Several MB of characters the lexer does not know, each one an UNRECOGNISED_TOKEN
+    const std::size_t bytes = bench::scale(4 * 1024 * 1024);
+    std::string garbage;
+    garbage.reserve(bytes);
+    constexpr std::string_view unknown = "#$@`?\\";
+    for (std::size_t i = 0; garbage.size() < bytes; i++) {
+        garbage += unknown[i % unknown.size()];
+        if (i % 2 == 1) garbage += ' ';
+    }
+
+    // What a batch build does with them: count the errors
+    std::size_t reported = 0;
+    const auto run = [&] {
+        DiagnosticEngine engine;
+        const auto tokens = Tokeniser{engine}.tokenise(SourceLocation{0}, garbage);
+        reported = std::ranges::count(engine.getAll(), DiagnosticSeverity::ERROR, &Diagnostic::severity);
+        return bench::residentBytes();
+    };
+
+    // Measured on the first run, before later ones can reuse the memory it freed
+    const std::size_t before = bench::residentBytes();
+    const std::size_t resident = run() - before;
+    const double seconds = bench::timeBest(3, run);
+    ASSERT_GT(reported, bytes / 2);
+
+    bench::report("garbage: reports", static_cast<double>(reported) / 1e6, "M");
+    bench::report("garbage: tokenise and count errors", static_cast<double>(reported) / seconds / 1e6, "Mdiagnostics/s");
+    bench::report("garbage: resident growth per diagnostic", static_cast<double>(resident) / static_cast<double>(reported), "bytes");
+    bench::report("garbage: sizeof(Diagnostic)", static_cast<double>(sizeof(Diagnostic)), "bytes");
+
+    // The same input with runs a byte apart coalesced. The '?'s are valid tokens, so runs are 4 long.
+    std::size_t kept = 0;
+    const double coalesced_s = bench::timeBest(3, [&] {
+        DiagnosticEngine engine{DiagnosticOptions{.coalesce_gap = 1}};
+        const auto tokens = Tokeniser{engine}.tokenise(SourceLocation{0}, garbage);
+        kept = engine.getAll().size();
+    });
+    EXPECT_LT(kept, reported / 4);
+    bench::report("garbage coalesced: kept", static_cast<double>(kept), "diagnostics");
+    bench::report("garbage coalesced: tokenise", static_cast<double>(bytes) / coalesced_s / 1e6, "MB/s");
+
+    // And as the command line reports it, which also stops at 100 errors
+    const double bounded_s = bench::timeBest(3, [&] {
+        DiagnosticEngine engine{DiagnosticOptions{.error_limit = 100, .coalesce_gap = 1, .suppress_cascades = true}};
+        const auto tokens = Tokeniser{engine}.tokenise(SourceLocation{0}, garbage);
+        kept = engine.getAll().size();
+    });
+    EXPECT_EQ(kept, 100);
+    bench::report("garbage bounded: kept", static_cast<double>(kept), "diagnostics");
+    bench::report("garbage bounded: time", bounded_s * 1e6, "us");
+}
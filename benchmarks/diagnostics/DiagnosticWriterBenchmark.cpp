@@ -0,0 +1,134 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/diagnostics/DiagnosticEngine.h"
+#include "../../include/diagnostics/JsonLinesWriter.h"
+#include "../../include/diagnostics/SarifWriter.h"
+
+namespace {
+
+// Counts what is written to it and keeps none of it, so only the writers are measured
+class NullBuffer final : public std::streambuf {
+public:
+    std::size_t bytes = 0;
+
+protected:
+    int overflow(const int c) override {
+        bytes++;
+        return c;
+    }
+
+    std::streamsize xsputn(const char*, const std::streamsize n) override {
+        bytes += static_cast<std::size_t>(n);
+        return n;
+    }
+};
+
+class DiagnosticWriterBenchmark : public testing::Test {
+protected:
+    static constexpr std::size_t LINE_BYTES = 40;
+
+    std::filesystem::path path;
+    SourceManager source_manager;
+    std::size_t diagnostics = bench::scale(1'000'000);
+
+    // A file with a line per diagnostic, so every one resolves to a different position
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() / ("kahwa_diagnostic_writer_benchmark_" + std::to_string(getpid()) + ".kahwa");
+        {
+            std::ofstream out{path};
+            const std::string line = "typedef A B; # stray" + std::string(LINE_BYTES - 21, ' ') + "\n";
+            for (std::size_t i = 0; i < diagnostics; i++) out << line;
+        }
+        source_manager.addFile(path);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    [[nodiscard]] SourceRange range(const std::size_t i) const {
+        const SourceLocation begin = source_manager.getLocation(0, i * LINE_BYTES + 13);
+        return {begin, SourceLocation{begin.offset + 1}};
+    }
+
+    // Reports every diagnostic from `threads` threads into a streaming engine, returning the bytes written
+    template <typename Writer>
+    std::size_t run(const std::size_t threads) {
+        NullBuffer buffer;
+        std::ostream out{&buffer};
+        {
+            Writer writer{out, source_manager};
+            DiagnosticEngine engine{DiagnosticOptions{.sink = &writer}};
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; t++) {
+                workers.emplace_back([&, t] {
+                    for (std::size_t i = t; i < diagnostics; i += threads) {
+                        engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(i));
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            engine.flush();
+        }
+        return buffer.bytes;
+    }
+
+    template <typename Writer>
+    void measure(const std::string& name) {
+        // Warms up the line tables, which are built on first use
+        (void) source_manager.getLineColumn(range(0).begin);
+        const std::size_t before = bench::residentBytes();
+        std::size_t bytes = run<Writer>(1);
+        const std::size_t resident = bench::residentBytes() - before;
+
+        for (const std::size_t threads : {1, 4}) {
+            const double seconds = bench::timeBest(3, [&] { bytes = run<Writer>(threads); });
+            const std::string prefix = name + ", " + std::to_string(threads) + " threads: ";
+            bench::report(prefix + "throughput", static_cast<double>(diagnostics) / seconds / 1e6, "Mdiagnostics/s");
+            bench::report(prefix + "output", static_cast<double>(bytes) / seconds / 1e6, "MB/s");
+        }
+        bench::report(name + ": bytes per diagnostic", static_cast<double>(bytes) / static_cast<double>(diagnostics), "bytes");
+        bench::report(name + ": resident growth", static_cast<double>(resident) / 1024, "KiB");
+    }
+};
+
+}
+
+TEST_F(DiagnosticWriterBenchmark, JsonLines) {
+    measure<JsonLinesWriter>("jsonl");
+}
+
+TEST_F(DiagnosticWriterBenchmark, Sarif) {
+    measure<SarifWriter>("sarif");
+}
+
+TEST_F(DiagnosticWriterBenchmark, CollectThenWriteText) {
+    // What the command line did before writers: keep everything, then print it a diagnostic at a time
+    NullBuffer buffer;
+    std::ostream out{&buffer};
+    (void) source_manager.getLineColumn(range(0).begin);
+    const std::size_t before = bench::residentBytes();
+    std::size_t resident = 0;
+    const double seconds = bench::timeBest(3, [&] {
+        DiagnosticEngine engine;
+        for (std::size_t i = 0; i < diagnostics; i++) {
+            engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(i));
+        }
+        for (const auto& diagnostic : engine.getAll()) {
+            const SourceLocation location = diagnostic.source_range.begin;
+            const auto [line, column] = source_manager.getLineColumn(location);
+            out << source_manager.getPath(source_manager.getFileId(location)).string() << ":" << line << ":" << column << ": "
+                << magic_enum::enum_name(diagnostic.severity) << ": " << diagnostic.msg() << std::endl;
+        }
+        resident = std::max(resident, bench::residentBytes() - before);
+    });
+    bench::report("collect then text: throughput", static_cast<double>(diagnostics) / seconds / 1e6, "Mdiagnostics/s");
+    bench::report("collect then text: resident growth", static_cast<double>(resident) / 1024, "KiB");
+}
@@ -0,0 +1,48 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/driver/Driver.h"
+
+TEST(DriverBenchmark, FilesPerSecondByThreadCount) {
+    // Files of varying size, as in a real project, so the later ones need stealing to balance
+    std::vector<std::string> storage;
+    for (std::size_t i = 0; i < bench::scale(4000); i++) {
+        storage.push_back(bench::generateSource(50 + i * 7919 % 400));
+    }
+    const std::vector<std::string_view> sources{storage.begin(), storage.end()};
+
+    double single_thread_s = 0;
+    for (const std::size_t threads : {1, 2, 4, 8, 16}) {
+        Driver driver{threads};
+        std::size_t diagnostics = 0;
+        const double seconds = bench::timeBest(3, [&] { diagnostics = driver.parse(sources).diagnostics.size(); });
+        if (threads == 1) single_thread_s = seconds;
+
+        const std::string label = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        bench::report(label + ": files/s", static_cast<double>(sources.size()) / seconds, "files/s");
+        bench::report(label + ": speedup", single_thread_s / seconds, "x");
+    }
+    bench::report("hardware threads", std::thread::hardware_concurrency(), "threads");
+}
+
+TEST(DriverBenchmark, SingleLargeFileByThreadCount) {
+    // About 6 MB in one file
+    const std::string source = bench::generateSource(bench::scale(100'000));
+    bench::report("file size", static_cast<double>(source.size()) / 1e6, "MB");
+
+    Driver sequential{1};
+    const double sequential_s = bench::timeBest(3, [&] { ASSERT_EQ(sequential.parse(std::vector<std::string_view>{source}).files.size(), 1); });
+    bench::report("sequential parse", sequential_s * 1e3, "ms");
+
+    for (const std::size_t threads : {1, 2, 4, 8, 16}) {
+        Driver driver{threads};
+        const double seconds = bench::timeBest(3, [&] { ASSERT_EQ(driver.parseFileParallel(source).files.size(), 1); });
+
+        const std::string label = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        bench::report(label + ": parse", seconds * 1e3, "ms");
+        bench::report(label + ": speedup", sequential_s / seconds, "x");
+    }
+    bench::report("hardware threads", std::thread::hardware_concurrency(), "threads");
+}
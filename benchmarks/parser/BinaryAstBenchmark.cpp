@@ -0,0 +1,83 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <fstream>
+
+#include <unistd.h>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/parser/BinaryAst.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// What a tool that only reads the declarations does with a file: visit each one's name and type
+std::size_t walk(const BinaryAst& ast) {
+    std::size_t sum = 0;
+    for (const auto& decl : ast.file().typedef_decls) {
+        sum += ast.str(decl->decl.name).size() + decl->decl.name_range.begin;
+        if (decl->referred_type) sum += ast.str(decl->referred_type->identifier).size();
+    }
+    return sum;
+}
+
+std::size_t walk(const KahwaFile& file) {
+    std::size_t sum = 0;
+    for (const auto* decl : file.typedefDecls) {
+        sum += decl->name.str().size() + decl->nameSourceRange.begin.offset;
+        if (decl->referredType) sum += decl->referredType->identifier.str().size();
+    }
+    return sum;
+}
+
+}
+
+TEST(BinaryAstBenchmark, LoadVersusReparse) {
+    const std::string source = bench::generateSource(bench::scale(400'000));
+    const auto path = std::filesystem::temp_directory_path() / ("kahwa_binary_ast_benchmark_" + std::to_string(getpid()) + ".kast");
+
+    Arena parse_arena;
+    const KahwaFile* parsed = nullptr;
+    const double parse_s = bench::timeBest(3, [&] {
+        parse_arena.reset();
+        DiagnosticEngine engine;
+        parsed = Parser{parse_arena, engine}.parseFile(Tokeniser{engine}.tokenise(SourceLocation{0}, source));
+    });
+
+    std::string image;
+    const double serialise_s = bench::timeBest(3, [&] { image = BinaryAst::serialise(*parsed, SourceLocation{0}); });
+    std::ofstream{path, std::ios::binary} << image;
+
+    // Mapping, checking the header and walking the declarations, straight from the page cache
+    std::size_t walked = 0;
+    const double view_s = bench::timeBest(3, [&] {
+        const MappedAst mapped{path};
+        walked = walk(*mapped.ast());
+    });
+    EXPECT_EQ(walked, walk(*parsed));
+
+    // Rebuilding the pointer tree, for code that needs one
+    Arena load_arena;
+    const KahwaFile* loaded = nullptr;
+    const double load_s = bench::timeBest(3, [&] {
+        load_arena.reset();
+        TypeTable types{load_arena};
+        const MappedAst mapped{path};
+        loaded = mapped.ast()->load(load_arena, types, SourceLocation{0});
+    });
+    EXPECT_EQ(*loaded, *parsed);
+    std::filesystem::remove(path);
+
+    const double decls = static_cast<double>(parsed->typedefDecls.size());
+    bench::report("binary ast: typedefs", decls, "");
+    bench::report("binary ast: source size", static_cast<double>(source.size()) / 1e6, "MB");
+    bench::report("binary ast: image size", static_cast<double>(image.size()) / 1e6, "MB");
+    bench::report("binary ast: tokenise and parse", parse_s * 1e3, "ms");
+    bench::report("binary ast: serialise", serialise_s * 1e3, "ms");
+    bench::report("binary ast: mmap and walk in place", view_s * 1e3, "ms");
+    bench::report("binary ast: mmap and load", load_s * 1e3, "ms");
+    bench::report("binary ast: walk in place vs reparse", parse_s / view_s, "x");
+    bench::report("binary ast: load vs reparse", parse_s / load_s, "x");
+}
@@ -0,0 +1,149 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/arena/ArenaVector.h"
+#include "../../include/parser/FlatAst.h"
+
+namespace {
+
+// What a pass visiting every node reads: the kind, the name and the location
+struct Checksum {
+    std::size_t nodes = 0;
+    std::uint64_t sum = 0;
+
+    void visit(const NodeKind kind, const std::optional<Symbol> name, const SourceLocation location) {
+        nodes++;
+        sum += static_cast<std::uint64_t>(kind) + (name ? name->id : 0) + location.offset;
+    }
+
+    bool operator==(const Checksum&) const = default;
+};
+
+class PointerWalker {
+public:
+    Checksum checksum;
+
+    void walk(const KahwaFile& file) {
+        checksum.visit(NodeKind::FILE, std::nullopt, file.typedefDecls.empty() ? SourceLocation{0} : file.typedefDecls[0]->nameSourceRange.begin);
+        for (const auto* decl : file.typedefDecls) walk(*decl);
+        for (const auto* decl : file.classDecls) walk(*decl);
+    }
+
+private:
+    void walk(const TypedefDecl& decl) {
+        checksum.visit(NodeKind::TYPEDEF, decl.name, decl.nameSourceRange.begin);
+        walk(*decl.referredType, decl.nameSourceRange.begin);
+    }
+
+    void walk(const ClassDecl& decl) {
+        const SourceLocation location = decl.nameSourceRange.begin;
+        checksum.visit(NodeKind::CLASS, decl.name, location);
+        for (const auto* type : decl.superClasses) walk(*type, location);
+        for (const auto* field : decl.fields) {
+            checksum.visit(NodeKind::FIELD, field->name, field->nameSourceRange.begin);
+            walk(*field->type, field->nameSourceRange.begin);
+        }
+        for (const auto* method : decl.methods) {
+            const SourceLocation method_location = method->nameSourceRange.begin;
+            checksum.visit(NodeKind::METHOD, method->name, method_location);
+            walk(*method->returnType, method_location);
+            for (const auto& [type, name] : method->parameters) walk(*type, method_location);
+            checksum.visit(NodeKind::BLOCK, std::nullopt, method_location);
+        }
+    }
+
+    void walk(const TypeRef& type, const SourceLocation location) {
+        checksum.visit(NodeKind::TYPE_REF, type.identifier, location);
+        for (const auto* arg : type.args) walk(*arg, location);
+    }
+};
+
+// A file of classes with generic fields and methods, built children first as the parser does
+const KahwaFile* buildFile(Arena& arena, const std::size_t classes) {
+    const auto symbol = [](const std::string& prefix, const std::size_t i) { return Symbol::intern(prefix + std::to_string(i % 1000)); };
+    const auto range = [](const std::size_t offset) { return SourceRange{SourceLocation{offset}}; };
+    const auto type = [&](const Symbol identifier, const std::initializer_list<TypeRef*> args = {}) {
+        return arena.make<TypeRef>(identifier, ArenaSpan<TypeRef*>::copyOf(arena, args));
+    };
+
+    ArenaVector<TypedefDecl*> typedefs{arena};
+    ArenaVector<ClassDecl*> class_decls{arena};
+    std::size_t offset = 0;
+    for (std::size_t c = 0; c < classes; c++) {
+        typedefs.push_back(arena.make<TypedefDecl>(symbol("Alias", c), ArenaSpan<Modifier>{}, type(symbol("Map", c), {type(symbol("K", c)), type(symbol("V", c))}), range(offset), range(offset + 8), range(offset)));
+        offset += 32;
+
+        ArenaVector<FieldDecl*> fields{arena};
+        ArenaVector<MethodDecl*> methods{arena};
+        for (std::size_t m = 0; m < 4; m++) {
+            fields.push_back(arena.make<FieldDecl>(symbol("field", m), ArenaSpan<Modifier>{}, type(symbol("List", c), {type(symbol("T", m))}), range(offset), range(offset + 8), range(offset)));
+            offset += 24;
+        }
+        for (std::size_t m = 0; m < 4; m++) {
+            const auto parameters = ArenaSpan<std::pair<TypeRef*, Symbol>>::copyOf(arena, {
+                std::pair{type(symbol("int", m)), symbol("a", m)},
+                std::pair{type(symbol("String", m)), symbol("b", m)},
+            });
+            methods.push_back(arena.make<MethodDecl>(symbol("method", m), ArenaSpan<Modifier>{}, type(symbol("void", m)), parameters,
+                arena.make<Block>(ArenaSpan<Stmt*>{}), range(offset), range(offset + 5), range(offset)));
+            offset += 64;
+        }
+        class_decls.push_back(arena.make<ClassDecl>(symbol("Class", c), range(offset), range(offset + 6), range(offset), ArenaSpan<Modifier>{},
+            ArenaSpan<TypeRef*>::copyOf(arena, {type(symbol("Base", c))}), fields.span(), methods.span()));
+        offset += 16;
+    }
+    return arena.make<KahwaFile>(typedefs.span(), class_decls.span());
+}
+
+}
+
+TEST(FlatAstBenchmark, FullTreeWalk) {
+    // 4 typedef nodes and 34 class nodes per class, about a million nodes in all
+    const std::size_t classes = bench::scale(26'000);
+    Arena arena;
+    const KahwaFile* file = buildFile(arena, classes);
+
+    bench::Stopwatch build_stopwatch;
+    const FlatAst ast{*file};
+    const double build_s = build_stopwatch.seconds();
+    const double nodes = static_cast<double>(ast.size());
+
+    Checksum pointer_checksum;
+    const double pointer_s = bench::timeBest(5, [&] {
+        PointerWalker walker;
+        walker.walk(*file);
+        pointer_checksum = walker.checksum;
+    });
+
+    // Every node in id order, no recursion needed
+    Checksum scan_checksum;
+    const double scan_s = bench::timeBest(5, [&] {
+        Checksum checksum;
+        for (NodeId id = 0; id < ast.size(); id++) checksum.visit(ast.kind(id), ast.name(id), ast.location(id));
+        scan_checksum = checksum;
+    });
+
+    // Depth first through the child ranges, for passes that need the nesting
+    Checksum recursive_checksum;
+    const double recursive_s = bench::timeBest(5, [&] {
+        Checksum checksum;
+        const auto walk = [&](const auto& self, const NodeId id) -> void {
+            checksum.visit(ast.kind(id), ast.name(id), ast.location(id));
+            for (const NodeId child : ast.children(id)) self(self, child);
+        };
+        walk(walk, FlatAst::ROOT);
+        recursive_checksum = checksum;
+    });
+
+    EXPECT_EQ(pointer_checksum, scan_checksum);
+    EXPECT_EQ(pointer_checksum.nodes, recursive_checksum.nodes);
+    EXPECT_EQ(pointer_checksum.sum, recursive_checksum.sum);
+
+    bench::report("nodes", nodes, "nodes");
+    bench::report("flatten", build_s * 1e3, "ms");
+    bench::report("pointer tree walk", pointer_s * 1e9 / nodes, "ns/node");
+    bench::report("flat linear scan", scan_s * 1e9 / nodes, "ns/node");
+    bench::report("flat depth-first walk", recursive_s * 1e9 / nodes, "ns/node");
+}
@@ -0,0 +1,56 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <algorithm>
+#include <random>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/parser/IncrementalParser.h"
+
+TEST(IncrementalParserBenchmark, SingleCharacterEdits) {
+    // 1.25 lines per declaration, 50k lines
+    std::string source = bench::generateSource(40'000);
+    const std::size_t lines = std::ranges::count(source, '\n');
+    const std::size_t edits = bench::scale(200);
+
+    Arena full_arena;
+    const double full_s = bench::timeBest(3, [&] {
+        full_arena.reset();
+        IncrementalParser full{full_arena, SourceLocation{0}};
+        ASSERT_NE(full.parse(source), nullptr);
+    });
+
+    Arena arena;
+    IncrementalParser parser{arena, SourceLocation{0}};
+    const KahwaFile* file = parser.parse(source);
+
+    // Typing a character somewhere, then deleting it again
+    std::mt19937 random{7};
+    std::vector<double> latencies;
+    std::size_t tokens_relexed = 0;
+    std::size_t declarations_reparsed = 0;
+    for (std::size_t i = 0; i < edits; i++) {
+        const std::size_t offset = random() % source.size();
+        const TextEdit insert{offset, 0, "x"};
+        const TextEdit remove{offset, 1, ""};
+        for (const TextEdit& edit : {insert, remove}) {
+            source.replace(edit.offset, edit.removed, edit.inserted);
+            const bench::Stopwatch stopwatch;
+            file = parser.reparse(file, source, edit);
+            latencies.push_back(stopwatch.seconds());
+            tokens_relexed += parser.stats().tokens_relexed;
+            declarations_reparsed += parser.stats().declarations_reparsed;
+        }
+    }
+    std::ranges::sort(latencies);
+
+    const auto count = static_cast<double>(latencies.size());
+    bench::report("lines", static_cast<double>(lines), "lines");
+    bench::report("full parse", full_s * 1e3, "ms");
+    bench::report("edit, median", latencies[latencies.size() / 2] * 1e6, "us");
+    bench::report("edit, p99", latencies[latencies.size() * 99 / 100] * 1e6, "us");
+    bench::report("tokens relexed per edit", static_cast<double>(tokens_relexed) / count, "tokens");
+    bench::report("declarations reparsed per edit", static_cast<double>(declarations_reparsed) / count, "decls");
+    bench::report("arena after edits", static_cast<double>(arena.stats().bytes_used) / 1e6, "MB");
+}
@@ -0,0 +1,39 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+TEST(ParserBenchmark, TokeniseAndParseThroughput) {
+    // Well-formed declarations, and the same with every other one broken so recovery runs all the time
+    std::string broken;
+    for (std::size_t i = 0; i < bench::scale(100'000); i++) {
+        broken += i % 2 == 0 ? "typedef Base ; { } ( ) = 1 ; ;\n" : "public typedef Base" + std::to_string(i) + " Alias\n";
+    }
+    const std::vector<std::pair<std::string, std::string>> inputs{
+        {"generated", bench::generateSource(bench::scale(100'000))},
+        {"error-heavy", std::move(broken)},
+    };
+
+    for (const auto& [name, source] : inputs) {
+        const double megabytes = static_cast<double>(source.size()) / 1e6;
+
+        std::vector<Token> tokens;
+        const double tokenise_s = bench::timeBest(3, [&] {
+            DiagnosticEngine engine;
+            tokens = Tokeniser{engine}.tokenise(SourceLocation{0}, source);
+        });
+
+        Arena arena;
+        const double parse_s = bench::timeBest(5, [&] {
+            arena.reset();
+            DiagnosticEngine engine;
+            (void) Parser{arena, engine}.parseFile(tokens);
+        });
+
+        bench::report(name + ": tokenise", megabytes / tokenise_s, "MB/s");
+        bench::report(name + ": parse", static_cast<double>(tokens.size()) / parse_s / 1e6, "Mtokens/s");
+    }
+}
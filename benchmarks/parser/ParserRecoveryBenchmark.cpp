@@ -0,0 +1,42 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+TEST(ParserRecoveryBenchmark, ErrorHeavyInputStaysLinear) {
+    // Every other declaration is broken, and the junk after it has to be skipped to the next safe point
+    const auto source = [](const std::size_t lines) {
+        std::string src;
+        for (std::size_t i = 0; i < lines; i++) {
+            src += i % 2 == 0 ? "typedef Base ; { } ( ) = 1 ; ;\n" : "public typedef Base" + std::to_string(i) + " Alias\n";
+        }
+        return src;
+    };
+
+    double smallest_ns = 0;
+    for (const std::size_t lines : {bench::scale(10'000), bench::scale(40'000), bench::scale(160'000)}) {
+        const std::string src = source(lines);
+        DiagnosticEngine lexer_engine;
+        const auto tokens = Tokeniser{lexer_engine}.tokenise(SourceLocation{0}, src);
+
+        Arena arena;
+        std::size_t diagnostics = 0;
+        const double seconds = bench::timeBest(3, [&] {
+            arena.reset();
+            DiagnosticEngine diagnostic_engine;
+            (void) Parser{arena, diagnostic_engine}.parseFile(tokens);
+            diagnostics = diagnostic_engine.getAll().size();
+        });
+        const double ns = seconds * 1e9 / static_cast<double>(tokens.size());
+        if (smallest_ns == 0) smallest_ns = ns;
+
+        const std::string label = std::to_string(tokens.size()) + " tokens";
+        bench::report(label + ": diagnostics", static_cast<double>(diagnostics), "diags");
+        bench::report(label + ": parse", ns, "ns/token");
+        // Stays near 1 if recovery is linear in the size of the input
+        bench::report(label + ": relative to smallest", ns / smallest_ns, "x");
+    }
+}
@@ -0,0 +1,36 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+TEST(TypeTableBenchmark, UniqueTypesInCorpus) {
+    const std::size_t files = bench::scale(64);
+    const std::size_t decls = 10'000;
+    const std::string source = bench::generateSource(decls);
+
+    DiagnosticEngine diagnostic_engine;
+    const Tokeniser tokeniser{diagnostic_engine};
+    std::vector<std::vector<Token>> tokens;
+    for (std::size_t f = 0; f < files; f++) {
+        tokens.push_back(tokeniser.tokenise(SourceLocation{f * (source.size() + 1)}, source));
+    }
+
+    Arena arena;
+    const Parser parser{arena, diagnostic_engine};
+    const bench::Stopwatch stopwatch;
+    for (const auto& file_tokens : tokens) {
+        ASSERT_NE(parser.parseFile(file_tokens), nullptr);
+    }
+    const double parse_s = stopwatch.seconds();
+
+    const auto [total, unique] = parser.typeStats();
+    bench::report("type mentions", static_cast<double>(total), "types");
+    bench::report("unique types", static_cast<double>(unique), "types");
+    bench::report("unique / total", 100.0 * static_cast<double>(unique) / static_cast<double>(total), "%");
+    bench::report("TypeRef bytes, one node per mention", static_cast<double>(total * sizeof(TypeRef)) / 1e3, "KB");
+    bench::report("TypeRef bytes, interned", static_cast<double>(unique * sizeof(TypeRef)) / 1e3, "KB");
+    bench::report("parse", static_cast<double>(total) / parse_s / 1e6, "Mtypes/s");
+}
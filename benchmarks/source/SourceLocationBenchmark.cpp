@@ -0,0 +1,101 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <fstream>
+
+#include <unistd.h>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/driver/Driver.h"
+#include "../../include/parser/TypedefDecl.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// Locations as they were: a word-sized file id and position per location, and a length per range
+struct LegacySourceLocation {
+    std::size_t file_id;
+    std::size_t pos;
+};
+
+struct LegacySourceRange {
+    std::size_t file_id;
+    std::size_t pos;
+    std::size_t length;
+};
+
+// The 16 byte token, with a 24-bit file id next to its position
+struct LegacyToken {
+    TokenType type;
+    std::uint32_t file_id : 24;
+    std::uint32_t pos;
+    std::uint32_t length;
+    std::uint32_t payload;
+};
+
+constexpr std::size_t RANGE_SAVING = sizeof(LegacySourceRange) - sizeof(SourceRange);
+
+}
+
+TEST(SourceLocationBenchmark, PackedVersusFileRelativeLocations) {
+    const auto dir = std::filesystem::temp_directory_path() / ("kahwa_location_bench_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    const std::size_t files = bench::scale(256);
+    SourceManager source_manager;
+    for (std::size_t i = 0; i < files; i++) {
+        const auto path = dir / ("file" + std::to_string(i) + ".kahwa");
+        std::ofstream{path} << bench::generateSource(2'000 + i % 7 * 100);
+        source_manager.addFile(path);
+    }
+
+    std::size_t tokens = 0;
+    std::size_t bytes = 0;
+    for (std::size_t file_id = 0; file_id < files; file_id++) {
+        DiagnosticEngine diagnostic_engine;
+        tokens += Tokeniser{diagnostic_engine}.tokenise(source_manager.getFileStart(file_id), source_manager.getSource(file_id)).size();
+        bytes += source_manager.getSource(file_id).length();
+    }
+
+    const Project project = Driver{1}.parse(source_manager);
+    std::size_t typedefs = 0;
+    for (const KahwaFile* file : project.files) typedefs += file->typedefDecls.size();
+    const std::size_t diagnostics = project.diagnostics.size();
+
+    // Every TypedefDecl holds three ranges, for its name, body and `typedef` keyword
+    const double legacy_mb = static_cast<double>(tokens * sizeof(LegacyToken)
+        + typedefs * (sizeof(TypedefDecl) + 3 * RANGE_SAVING)
+        + diagnostics * (sizeof(Diagnostic) + RANGE_SAVING)) / 1e6;
+    const double packed_mb = static_cast<double>(tokens * sizeof(Token)
+        + typedefs * sizeof(TypedefDecl)
+        + diagnostics * sizeof(Diagnostic)) / 1e6;
+
+    // Resolving a location to its file is a binary search over the file starts
+    std::vector<SourceLocation> locations;
+    for (std::size_t i = 0; i < bench::scale(1'000'000); i++) {
+        locations.emplace_back(i * 7919 % source_manager.endOffset());
+    }
+    std::size_t checksum = 0;
+    const double lookup_s = bench::timeBest(3, [&] {
+        checksum = 0;
+        for (const SourceLocation location : locations) checksum += source_manager.getFileId(location);
+    });
+    EXPECT_GT(checksum, 0);
+
+    std::filesystem::remove_all(dir);
+
+    bench::report("files", static_cast<double>(files), "files");
+    bench::report("corpus size", static_cast<double>(bytes) / 1e6, "MB");
+    bench::report("location: file-relative", sizeof(LegacySourceLocation), "B");
+    bench::report("location: packed", sizeof(SourceLocation), "B");
+    bench::report("range: file-relative", sizeof(LegacySourceRange), "B");
+    bench::report("range: packed", sizeof(SourceRange), "B");
+    bench::report("token: file-relative", sizeof(LegacyToken), "B");
+    bench::report("token: packed", sizeof(Token), "B");
+    bench::report("TypedefDecl: file-relative", sizeof(TypedefDecl) + 3 * RANGE_SAVING, "B");
+    bench::report("TypedefDecl: packed", sizeof(TypedefDecl), "B");
+    bench::report("tokens + decls + diagnostics: file-relative", legacy_mb, "MB");
+    bench::report("tokens + decls + diagnostics: packed", packed_mb, "MB");
+    bench::report("location to file lookup", lookup_s / static_cast<double>(locations.size()) * 1e9, "ns");
+}
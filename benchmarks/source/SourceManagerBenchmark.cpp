@@ -0,0 +1,170 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <algorithm>
+#include <fstream>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/source/SourceManager.h"
+
+namespace {
+
+// SourceManager as it was: ifstream into a std::string per file, duplicates found by a linear scan
+class LegacySourceManager {
+public:
+    std::size_t addFile(const std::filesystem::path& path) {
+        auto canonical_path = std::filesystem::canonical(path);
+        if (const auto it = std::ranges::find_if(source_files, [canonical_path](const LegacySourceFile& file) { return file.path == canonical_path; }); it != source_files.end()) {
+            return std::distance(source_files.begin(), it);
+        }
+
+        std::ifstream in(canonical_path);
+        std::string contents{std::istreambuf_iterator(in), std::istreambuf_iterator<char>()};
+
+        std::size_t id = source_files.size();
+        source_files.push_back({canonical_path, contents});
+        return id;
+    }
+
+    [[nodiscard]] std::string_view getSource(const std::size_t file_id) const {
+        return source_files[file_id].contents;
+    }
+
+private:
+    struct LegacySourceFile {
+        std::filesystem::path path;
+        std::string contents;
+    };
+
+    std::vector<LegacySourceFile> source_files;
+};
+
+struct LoadResult {
+    double load_s;
+    std::size_t rss_loaded;
+    std::size_t rss_read;
+    std::size_t newlines;
+};
+
+template <typename Manager>
+LoadResult load(const std::vector<std::filesystem::path>& paths) {
+    const std::size_t rss_before = bench::residentBytes();
+    bench::Stopwatch stopwatch;
+
+    Manager manager;
+    for (const auto& path : paths) manager.addFile(path);
+    const double load_s = stopwatch.seconds();
+    const std::size_t rss_loaded = bench::residentBytes();
+
+    // Every byte read once, the way the tokeniser will
+    std::size_t newlines = 0;
+    for (std::size_t id = 0; id < paths.size(); id++) {
+        for (const char c : manager.getSource(id)) newlines += c == '\n';
+    }
+    const std::size_t rss_read = bench::residentBytes();
+
+    return {load_s, rss_loaded - std::min(rss_loaded, rss_before), rss_read - std::min(rss_read, rss_before), newlines};
+}
+
+// In a forked child, so neither implementation starts with heap the other has freed
+template <typename Manager>
+void loadAndReport(const std::string& name, const std::vector<std::filesystem::path>& paths) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    if (fork() == 0) {
+        const LoadResult result = load<Manager>(paths);
+        write(fds[1], &result, sizeof(result));
+        _exit(0);
+    }
+    LoadResult result{};
+    ASSERT_EQ(read(fds[0], &result, sizeof(result)), sizeof(result));
+    wait(nullptr);
+    close(fds[0]);
+    close(fds[1]);
+    EXPECT_GT(result.newlines, 0);
+
+    bench::report(name + ": load wall time", result.load_s * 1e3, "ms");
+    bench::report(name + ": RSS growth after load", static_cast<double>(result.rss_loaded) / 1e6, "MB");
+    bench::report(name + ": RSS growth after reading", static_cast<double>(result.rss_read) / 1e6, "MB");
+}
+
+}
+
+TEST(SourceManagerBenchmark, Load10kFiles) {
+    const auto dir = std::filesystem::temp_directory_path() / ("kahwa_source_manager_bench_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::filesystem::path> paths;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < bench::scale(10'000); i++) {
+        const std::string src = bench::generateSource(20 + i % 60);
+        paths.push_back(dir / ("file" + std::to_string(i) + ".kahwa"));
+        std::ofstream{paths.back()} << src;
+        bytes += src.size();
+    }
+    bench::report("files", static_cast<double>(paths.size()), "files");
+    bench::report("total size", static_cast<double>(bytes) / 1e6, "MB");
+
+    loadAndReport<SourceManager>("SourceManager", paths);
+    loadAndReport<LegacySourceManager>("ifstream", paths);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(SourceManagerBenchmark, LineColumnFor50kDiagnostics) {
+    const auto dir = std::filesystem::temp_directory_path() / ("kahwa_line_table_bench_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    const auto path = dir / "large.kahwa";
+    std::ofstream{path} << bench::generateSource(bench::scale(200'000));
+
+    SourceManager source_manager;
+    const std::size_t id = source_manager.addFile(path);
+    const std::string_view source = source_manager.getSource(id);
+
+    std::vector<std::size_t> offsets;
+    for (std::size_t i = 0; i < bench::scale(50'000); i++) {
+        offsets.push_back(i * 7919 % source.size());
+    }
+
+    // Before: every diagnostic rescans the file up to its offset. Too slow to run 50k times, so time a
+    // sample and scale up.
+    const std::size_t sample = std::min<std::size_t>(offsets.size(), 500);
+    std::size_t rescan_sum = 0;
+    const double rescan_sample_s = bench::timeBest(1, [&] {
+        for (std::size_t i = 0; i < sample; i++) {
+            rescan_sum += std::count(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(offsets[i]), '\n') + 1;
+        }
+    });
+    const double rescan_s = rescan_sample_s * static_cast<double>(offsets.size()) / static_cast<double>(sample);
+
+    bench::Stopwatch build;
+    const std::size_t lines = source_manager.lineCount(id);
+    const double build_s = build.seconds();
+
+    std::size_t checksum = 0;
+    const double table_s = bench::timeBest(3, [&] {
+        checksum = 0;
+        for (const std::size_t offset : offsets) {
+            checksum += source_manager.getLineColumn(source_manager.getLocation(id, offset)).line;
+        }
+    });
+    EXPECT_GT(checksum, 0);
+
+    std::size_t table_sample_sum = 0;
+    for (std::size_t i = 0; i < sample; i++) {
+        table_sample_sum += source_manager.getLineColumn(source_manager.getLocation(id, offsets[i])).line;
+    }
+    EXPECT_EQ(rescan_sum, table_sample_sum);
+
+    bench::report("file size", static_cast<double>(source.size()) / 1e6, "MB");
+    bench::report("lines", static_cast<double>(lines), "lines");
+    bench::report("rescan per diagnostic: 50k lookups (est.)", rescan_s * 1e3, "ms");
+    bench::report("line table: build", build_s * 1e3, "ms");
+    bench::report("line table: 50k lookups", table_s * 1e3, "ms");
+
+    std::filesystem::remove_all(dir);
+}
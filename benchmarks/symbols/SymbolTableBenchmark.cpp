@@ -0,0 +1,92 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <unordered_map>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/symbols/SymbolTable.h"
+
+namespace {
+
+// Identifier stream with the repetition we see in generated code: a million occurrences
+// drawn from a much smaller vocabulary.
+std::vector<std::string_view> identifierStream(const std::string& storage, const std::size_t count) {
+    std::vector<std::string_view> views;
+    std::size_t start = 0;
+    while (views.size() < count) {
+        const std::size_t end = storage.find(' ', start);
+        views.push_back(std::string_view{storage}.substr(start, end - start));
+        start = end + 1;
+        if (start >= storage.size()) start = 0;
+    }
+    return views;
+}
+
+std::size_t heapBytes(const std::string& str) {
+    return str.capacity() > std::string{}.capacity() ? str.capacity() + 1 : 0;
+}
+
+}
+
+TEST(SymbolTableBenchmark, PerMillionIdentifiers) {
+    const std::size_t count = bench::scale(1'000'000);
+    std::string storage;
+    for (int i = 0; i < 50'000; i++) {
+        storage += (i % 3 == 0 ? "generated_identifier_" : "v") + std::to_string(i * 7919 % 50'000) + " ";
+    }
+    const auto identifiers = identifierStream(storage, count);
+
+    // Before: a std::string per identifier, looked up in a string-keyed keyword map and copied into the AST
+    static const std::unordered_map<std::string, TokenType> keyword_map = [] {
+        std::unordered_map<std::string, TokenType> map;
+        for (const auto type : KEYWORD_TYPES) map.emplace(keywordToString(type), type);
+        return map;
+    }();
+
+    std::vector<std::string> names;
+    const double before_s = bench::timeBest(3, [&] {
+        names.clear();
+        names.reserve(identifiers.size());
+        for (const auto identifier : identifiers) {
+            std::string str{identifier};
+            if (!keyword_map.contains(str)) names.push_back(std::move(str));
+        }
+    });
+    std::size_t before_bytes = names.capacity() * sizeof(std::string);
+    for (const auto& name : names) before_bytes += heapBytes(name);
+
+    // After: one hash of the source view, keywords resolved by the same lookup, 4 bytes per occurrence
+    SymbolTable symbols;
+    std::vector<Symbol> handles;
+    const double after_s = bench::timeBest(3, [&] {
+        handles.clear();
+        handles.reserve(identifiers.size());
+        for (const auto identifier : identifiers) {
+            const Symbol symbol = symbols.intern(identifier);
+            if (!symbols.keyword(symbol)) handles.push_back(symbol);
+        }
+    });
+    const std::size_t after_bytes = handles.capacity() * sizeof(Symbol) + symbols.memoryUsage();
+
+    std::size_t equal_strings = 0;
+    const double compare_strings_s = bench::timeBest(3, [&] {
+        equal_strings = 0;
+        for (std::size_t i = 1; i < names.size(); i++) equal_strings += names[i] == names[i - 1];
+    });
+    std::size_t equal_symbols = 0;
+    const double compare_symbols_s = bench::timeBest(3, [&] {
+        equal_symbols = 0;
+        for (std::size_t i = 1; i < handles.size(); i++) equal_symbols += handles[i] == handles[i - 1];
+    });
+    EXPECT_EQ(equal_strings, equal_symbols);
+
+    const double millions = static_cast<double>(count) / 1e6;
+    bench::report("distinct identifiers", static_cast<double>(symbols.size()), "symbols");
+    bench::report("std::string: time per 1M identifiers", before_s / millions * 1e3, "ms");
+    bench::report("Symbol: time per 1M identifiers", after_s / millions * 1e3, "ms");
+    bench::report("std::string: memory per 1M identifiers", static_cast<double>(before_bytes) / millions / 1e6, "MB");
+    bench::report("Symbol: memory per 1M identifiers", static_cast<double>(after_bytes) / millions / 1e6, "MB");
+    bench::report("std::string: equality per 1M pairs", compare_strings_s / millions * 1e3, "ms");
+    bench::report("Symbol: equality per 1M pairs", compare_symbols_s / millions * 1e3, "ms");
+}
@@ -0,0 +1,41 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <algorithm>
+#include <random>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+TEST(RelexBenchmark, SingleCharacterEdits) {
+    std::string source = bench::generateSource(40'000);
+    const std::size_t edits = bench::scale(500);
+
+    DiagnosticEngine engine;
+    const Tokeniser tokeniser{engine};
+    std::vector<Token> tokens;
+    const double full_s = bench::timeBest(3, [&] { tokens = tokeniser.tokenise(SourceLocation{0}, source); });
+    std::vector<Diagnostic> diagnostics = engine.getAll();
+
+    // Typing a character somewhere, then deleting it again
+    std::mt19937 random{7};
+    std::vector<double> latencies;
+    std::size_t relexed = 0;
+    for (std::size_t i = 0; i < edits; i++) {
+        const std::size_t offset = random() % source.size();
+        for (const TextEdit& edit : {TextEdit{offset, 0, "x"}, TextEdit{offset, 1, ""}}) {
+            source.replace(edit.offset, edit.removed, edit.inserted);
+            const bench::Stopwatch stopwatch;
+            relexed += Tokeniser::relex(SourceLocation{0}, source, edit, tokens, diagnostics).count;
+            latencies.push_back(stopwatch.seconds());
+        }
+    }
+    std::ranges::sort(latencies);
+
+    bench::report("tokens", static_cast<double>(tokens.size()), "tokens");
+    bench::report("full tokenise", full_s * 1e3, "ms");
+    bench::report("relex, median", latencies[latencies.size() / 2] * 1e6, "us");
+    bench::report("relex, p99", latencies[latencies.size() * 99 / 100] * 1e6, "us");
+    bench::report("tokens relexed per edit", static_cast<double>(relexed) / static_cast<double>(latencies.size()), "tokens");
+}
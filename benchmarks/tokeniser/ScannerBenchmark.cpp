@@ -0,0 +1,105 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../BenchmarkUtil.h"
+#include "../../include/tokeniser/Scanner.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+constexpr std::string_view LEVEL_NAMES[] = {"scalar", "sse2", "avx2"};
+
+// Long line and block comments between short declarations, the shape of documented generated headers
+std::string commentHeavySource(const std::size_t bytes) {
+    std::string src;
+    src.reserve(bytes + 256);
+    for (std::size_t i = 0; src.size() < bytes; i++) {
+        src += "    // " + std::string(60 + i % 40, 'c') + "\n";
+        src += "    /* " + std::string(120 + i % 50, 'b') + "\n       * " + std::string(80, 'd') + " */\n";
+        src += "    typedef T" + std::to_string(i) + " U;\n";
+    }
+    return src;
+}
+
+std::string identifierHeavySource(const std::size_t bytes) {
+    std::string src;
+    src.reserve(bytes + 256);
+    for (std::size_t i = 0; src.size() < bytes; i++) {
+        src += "some_rather_long_generated_identifier_" + std::to_string(i) + " = another_generated_name_" + std::to_string(i * 31) + ";\n";
+    }
+    return src;
+}
+
+// Bytes per second of the scanner loop alone: alternate whitespace and comment/identifier runs the way the
+// tokeniser does, without building tokens
+std::size_t scanComments(const Scanner::Functions& functions, const std::string& src) {
+    const char* p = src.data();
+    const char* end = p + src.size();
+    std::size_t comments = 0;
+    while (p < end) {
+        p = functions.skipWhitespace(p, end);
+        if (end - p >= 2 && p[0] == '/' && p[1] == '/') {
+            p = functions.findNewline(p + 2, end);
+            comments++;
+        } else if (end - p >= 2 && p[0] == '/' && p[1] == '*') {
+            p = std::min(functions.findCommentEnd(p + 2, end) + 2, end);
+            comments++;
+        } else if (p < end) {
+            p = functions.skipIdentifierChars(p + 1, end);
+        }
+    }
+    return comments;
+}
+
+std::size_t scanIdentifiers(const Scanner::Functions& functions, const std::string& src) {
+    const char* p = src.data();
+    const char* end = p + src.size();
+    std::size_t identifiers = 0;
+    while (p < end) {
+        p = functions.skipWhitespace(p, end);
+        if (p == end) break;
+        const char* next = functions.skipIdentifierChars(p, end);
+        identifiers += next != p;
+        p = next == p ? p + 1 : next;
+    }
+    return identifiers;
+}
+
+template <typename Fn>
+void reportLevels(const std::string& input, const std::string& src, Fn&& scan) {
+    const double gigabytes = static_cast<double>(src.size()) / 1e9;
+    std::size_t expected = 0;
+    for (const auto level : {Scanner::Level::SCALAR, Scanner::Level::SSE2, Scanner::Level::AVX2}) {
+        if (!Scanner::isSupported(level)) continue;
+        const Scanner::Functions& functions = Scanner::functionsFor(level);
+        std::size_t found = 0;
+        const double seconds = bench::timeBest(5, [&] { found = scan(functions, src); });
+        if (level == Scanner::Level::SCALAR) expected = found;
+        EXPECT_EQ(found, expected);
+        bench::report(input + ": " + std::string{LEVEL_NAMES[static_cast<int>(level)]}, gigabytes / seconds, "GB/s");
+    }
+}
+
+}
+
+TEST(ScannerBenchmark, CommentHeavy) {
+    const std::string src = commentHeavySource(bench::scale(64'000'000));
+    reportLevels("comments", src, scanComments);
+}
+
+TEST(ScannerBenchmark, IdentifierHeavy) {
+    const std::string src = identifierHeavySource(bench::scale(64'000'000));
+    reportLevels("identifiers", src, scanIdentifiers);
+}
+
+TEST(ScannerBenchmark, TokeniseCommentHeavy) {
+    const std::string src = commentHeavySource(bench::scale(16'000'000));
+    DiagnosticEngine diagnostic_engine;
+    const Tokeniser tokeniser{diagnostic_engine};
+
+    std::size_t tokens = 0;
+    const double seconds = bench::timeBest(3, [&] { tokens = tokeniser.tokenise(SourceLocation{0}, src).size(); });
+    bench::report("tokenise comment-heavy source", static_cast<double>(src.size()) / 1e9 / seconds, "GB/s");
+    bench::report("tokens", static_cast<double>(tokens), "tokens");
+}
@@ -0,0 +1,107 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <memory>
+#include <typeindex>
+
+#include "../BenchmarkUtil.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// Counts heap bytes requested through it, so the payload cost of the old layout can be measured.
+std::size_t allocated_bytes = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U> explicit CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(const std::size_t n) {
+        allocated_bytes += n * sizeof(T);
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, const std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    template <typename U> bool operator==(const CountingAllocator<U>&) const { return true; }
+};
+
+// Source ranges as they were when tokens were first made compact: a file id and a position, word-sized
+struct LegacySourceRange {
+    std::size_t file_id;
+    std::size_t pos;
+    std::size_t length;
+
+    explicit LegacySourceRange(const SourceRange& range): file_id(0), pos(range.begin.offset), length(range.length()) {}
+};
+
+// The token layout before it was made trivially copyable
+struct LegacyToken {
+    struct AuxDataBase { virtual ~AuxDataBase() = default; };
+    template <typename T> struct AuxData final : AuxDataBase { explicit AuxData(T data): data(std::move(data)) {} T data; };
+
+    TokenType type;
+    LegacySourceRange source_range;
+    std::type_index type_index;
+    std::shared_ptr<const AuxDataBase> data;
+
+    template <typename T>
+    LegacyToken(TokenType type, const SourceRange& source_range, T value):
+    type(type), source_range(source_range), type_index(typeid(T)),
+    data(std::allocate_shared<AuxData<T>>(CountingAllocator<AuxData<T>>{}, std::move(value))) {}
+
+    LegacyToken(TokenType type, const SourceRange& source_range):
+    type(type), source_range(source_range), type_index(typeid(nullptr)) {}
+};
+
+std::vector<LegacyToken> toLegacy(const std::vector<Token>& tokens) {
+    std::vector<LegacyToken> legacy;
+    legacy.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        if (const auto* str = token.getIf<std::string>()) {
+            legacy.emplace_back(token.type, token.getSourceRange(), *str);
+        } else if (const auto* i = token.getIf<int>()) {
+            legacy.emplace_back(token.type, token.getSourceRange(), *i);
+        } else if (const auto* f = token.getIf<float>()) {
+            legacy.emplace_back(token.type, token.getSourceRange(), *f);
+        } else {
+            legacy.emplace_back(token.type, token.getSourceRange());
+        }
+    }
+    return legacy;
+}
+
+}
+
+TEST(TokenBenchmark, CompactVersusLegacyLayout) {
+    DiagnosticEngine diagnostic_engine;
+    Tokeniser tokeniser{diagnostic_engine};
+    const std::string src = bench::generateSource(bench::scale(100'000));
+
+    std::vector<Token> tokens;
+    const double tokenise_s = bench::timeBest(3, [&] { tokens = tokeniser.tokenise(SourceLocation{0}, src); });
+    const auto n = static_cast<double>(tokens.size());
+
+    // Payload bytes of the new layout: every distinct string is stored once in the symbol table
+    const std::size_t pool_bytes = SymbolTable::global().memoryUsage();
+
+    allocated_bytes = 0;
+    std::vector<LegacyToken> legacy;
+    const double legacy_build_s = bench::timeBest(1, [&] { legacy = toLegacy(tokens); });
+    const std::size_t legacy_heap_bytes = allocated_bytes;
+
+    const double compact_copy_s = bench::timeBest(3, [&] { auto copy = tokens; ASSERT_EQ(copy.size(), tokens.size()); });
+    const double legacy_copy_s = bench::timeBest(3, [&] { auto copy = legacy; ASSERT_EQ(copy.size(), legacy.size()); });
+
+    bench::report("tokens", n, "tokens");
+    bench::report("compact: bytes/token (inline)", sizeof(Token), "B");
+    bench::report("compact: bytes/token (incl. symbol table)", sizeof(Token) + pool_bytes / n, "B");
+    bench::report("legacy: bytes/token (inline)", sizeof(LegacyToken), "B");
+    bench::report("legacy: bytes/token (incl. payloads)", sizeof(LegacyToken) + legacy_heap_bytes / n, "B");
+    bench::report("tokenise throughput", n / tokenise_s / 1e6, "Mtok/s");
+    bench::report("legacy: payload construction", n / legacy_build_s / 1e6, "Mtok/s");
+    bench::report("compact: vector copy", n / compact_copy_s / 1e6, "Mtok/s");
+    bench::report("legacy: vector copy", n / legacy_copy_s / 1e6, "Mtok/s");
+}
@@ -4,47 +4,125 @@
 
 #ifndef ARENA_H
 #define ARENA_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
+// Bump allocator. Blocks grow geometrically from `block_size` up to `max_block_size`, and an allocation
+// larger than that gets a block of its own.
+//
+// Objects made with make() are destroyed, in reverse order, when the arena is reset, cleared or destroyed.
+// Only types that are not trivially destructible are tracked, so the rest cost nothing extra. Memory from
+// allocate() is raw, nothing is destroyed in it.
 class Arena {
 public:
-    explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size(block_size) { addBlock(block_size); }
+    struct Options {
+        std::size_t block_size = DEFAULT_BLOCK_SIZE;
+        std::size_t max_block_size = DEFAULT_MAX_BLOCK_SIZE;
+        // Align blocks of HUGE_PAGE_SIZE or more to it and madvise them for transparent huge pages
+        bool huge_pages = false;
+    };
+
+    struct Stats {
+        std::size_t bytes_used;      // requested since the last reset
+        std::size_t bytes_padding;   // lost to alignment since the last reset
+        std::size_t bytes_reserved;  // held in blocks
+        std::size_t block_count;
+        std::size_t high_water_mark; // most bytes ever in use, padding included
+    };
+
+    explicit Arena(const std::size_t block_size = DEFAULT_BLOCK_SIZE) : Arena(Options{.block_size = block_size}) {}
 
-    ~Arena() { clear(); }
+    explicit Arena(Options options);
+
+    ~Arena();
 
     Arena(const Arena&) = delete;
     Arena& operator=(const Arena&) = delete;
 
-    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void* allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+        const auto cur = reinterpret_cast<std::uintptr_t>(current);
+        const std::size_t padding = align_up(cur, alignment) - cur;
+        if (padding + size > remaining) {
+            return allocateSlow(size, alignment);
+        }
+
+        char* ptr = current + padding;
+        current = ptr + size;
+        remaining -= padding + size;
+        bytes_used += size;
+        bytes_padding += padding;
+        return ptr;
+    }
 
     template <typename T, typename... Args>
     requires std::constructible_from<T, Args...>
     T* make(Args&&... args) {
-        void* mem = allocate(sizeof(T), alignof(T));
-        return new (mem) T(std::forward<Args>(args)...);
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            void* mem = allocate(sizeof(T), alignof(T));
+            return new (mem) T(std::forward<Args>(args)...);
+        } else {
+            // The record is allocated first so that nothing can fail once the object exists
+            auto* finalizer = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+            void* mem = allocate(sizeof(T), alignof(T));
+            T* object = new (mem) T(std::forward<Args>(args)...);
+            *finalizer = {[](void* p) { static_cast<T*>(p)->~T(); }, object, finalizers};
+            finalizers = finalizer;
+            return object;
+        }
     }
 
+    // Destroys every object and forgets every allocation but keeps the blocks, so refilling the arena does
+    // not go back to malloc
+    void reset() noexcept;
+
+    // Destroys every object, forgets every allocation and frees every block but the first
     void clear() noexcept;
 
+    [[nodiscard]] Stats stats() const;
+
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    static constexpr std::size_t DEFAULT_MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
 private:
     struct Block {
         char* data;
         std::size_t size;
     };
 
+    // Intrusive list in the arena itself, newest first
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    Options options;
     std::vector<Block> blocks;
-    std::size_t block_size;
+    std::size_t current_block = 0;
+    Finalizer* finalizers = nullptr;
+
+    char* current = nullptr;   // bump pointer inside blocks[current_block]
+    size_t remaining = 0;      // bytes left in blocks[current_block]
 
-    char* current = nullptr;   // bump pointer inside latest block
-    size_t remaining = 0;      // bytes left in latest block
+    std::size_t bytes_used = 0;
+    std::size_t bytes_padding = 0;
+    std::size_t high_water_mark = 0;
 
-    void addBlock(size_t size);
+    void* allocateSlow(std::size_t size, std::size_t alignment);
+
+    void runFinalizers() noexcept;
+
+    void addBlock(std::size_t size);
+
+    void useBlock(std::size_t index);
 
     static uintptr_t align_up(const std::uintptr_t n, const std::size_t alignment) {
         return (n + (alignment - 1)) & ~(alignment - 1);
     }
-
-    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
 };
 
 
@@ -0,0 +1,65 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef ARENASPAN_H
+#define ARENASPAN_H
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+
+#include "Arena.h"
+
+// Fixed-size sequence whose elements live in an Arena, the arena-backed stand-in for a const std::vector
+// in AST nodes. Copying one copies the view, not the elements. Its elements are never finalized, so only
+// trivially destructible ones are allowed.
+template <typename T>
+class ArenaSpan {
+    static_assert(std::is_trivially_destructible_v<T>);
+
+public:
+    ArenaSpan() = default;
+
+    ArenaSpan(const T* data, const std::size_t size): elements(data), count(size) {}
+
+    // Copies `values` into `arena`
+    template <std::ranges::sized_range R>
+    static ArenaSpan copyOf(Arena& arena, R&& values) {
+        const std::size_t size = std::ranges::size(values);
+        if (size == 0) return {};
+        T* data = static_cast<T*>(arena.allocate(sizeof(T) * size, alignof(T)));
+        std::ranges::uninitialized_copy(values, std::ranges::subrange(data, data + size));
+        return {data, size};
+    }
+
+    static ArenaSpan copyOf(Arena& arena, const std::initializer_list<T> values) {
+        return copyOf<const std::initializer_list<T>&>(arena, values);
+    }
+
+    [[nodiscard]] const T* data() const { return elements; }
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] const T* begin() const { return elements; }
+    [[nodiscard]] const T* end() const { return elements + count; }
+
+    const T& operator[](const std::size_t i) const { return elements[i]; }
+    [[nodiscard]] const T& front() const { return elements[0]; }
+    [[nodiscard]] const T& back() const { return elements[count - 1]; }
+
+    // Element-wise, like std::vector
+    bool operator==(const ArenaSpan& other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    const T* elements = nullptr;
+    std::size_t count = 0;
+};
+
+
+
+#endif //ARENASPAN_H
@@ -0,0 +1,65 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef ARENAVECTOR_H
+#define ARENAVECTOR_H
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "Arena.h"
+#include "ArenaSpan.h"
+
+// Growable sequence for building an ArenaSpan. Storage comes from the arena: growing copies the elements
+// into a buffer twice the size and leaves the old one behind, so nothing ever goes through malloc. The
+// finished span is a view of the final buffer, no copy is made.
+template <typename T>
+class ArenaVector {
+    static_assert(std::is_trivially_destructible_v<T>);
+
+public:
+    explicit ArenaVector(Arena& arena): arena(arena) {}
+
+    ArenaVector(const ArenaVector&) = delete;
+    ArenaVector& operator=(const ArenaVector&) = delete;
+
+    void push_back(const T& value) { emplace_back(value); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == capacity) grow();
+        return *std::construct_at(elements + count++, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] T* begin() { return elements; }
+    [[nodiscard]] T* end() { return elements + count; }
+
+    T& operator[](const std::size_t i) { return elements[i]; }
+
+    // The elements so far. Adding more afterwards does not change the span.
+    [[nodiscard]] ArenaSpan<T> span() const { return {elements, count}; }
+
+private:
+    Arena& arena;
+    T* elements = nullptr;
+    std::size_t count = 0;
+    std::size_t capacity = 0;
+
+    void grow() {
+        const std::size_t new_capacity = capacity == 0 ? INITIAL_CAPACITY : capacity * 2;
+        T* grown = static_cast<T*>(arena.allocate(sizeof(T) * new_capacity, alignof(T)));
+        std::uninitialized_move(elements, elements + count, grown);
+        elements = grown;
+        capacity = new_capacity;
+    }
+
+    static constexpr std::size_t INITIAL_CAPACITY = 4;
+};
+
+
+
+#endif //ARENAVECTOR_H
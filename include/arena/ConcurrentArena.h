@@ -0,0 +1,125 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef CONCURRENTARENA_H
+#define CONCURRENTARENA_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Arena that any number of threads can allocate from at once. Each thread bumps through a chunk of its
+// own, so the common case touches no shared state. A thread that runs out pops a fresh chunk off a
+// lock-free free list, and only goes to malloc when that is empty.
+//
+// A thread caches the chunk of one arena at a time: allocating from two arenas in turn on the same thread
+// works, but abandons the rest of a chunk at every switch.
+//
+// Objects made with make() are destroyed, in reverse order of creation, by reset(), clear() and the
+// destructor. Those, unlike allocation, must not run concurrently with anything else on the arena.
+class ConcurrentArena {
+public:
+    explicit ConcurrentArena(std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    ~ConcurrentArena();
+
+    ConcurrentArena(const ConcurrentArena&) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+    void* allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+        ThreadCache& thread_cache = cache;
+        if (thread_cache.owner == generation) {
+            const auto cur = reinterpret_cast<std::uintptr_t>(thread_cache.current);
+            const std::size_t padding = ((cur + alignment - 1) & ~(alignment - 1)) - cur;
+            if (padding + size <= thread_cache.remaining) {
+                char* ptr = thread_cache.current + padding;
+                thread_cache.current = ptr + size;
+                thread_cache.remaining -= padding + size;
+                return ptr;
+            }
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    requires std::constructible_from<T, Args...>
+    T* make(Args&&... args) {
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            void* mem = allocate(sizeof(T), alignof(T));
+            return new (mem) T(std::forward<Args>(args)...);
+        } else {
+            // The record is allocated first so that nothing can fail once the object exists
+            auto* finalizer = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+            void* mem = allocate(sizeof(T), alignof(T));
+            T* object = new (mem) T(std::forward<Args>(args)...);
+            *finalizer = {[](void* p) { static_cast<T*>(p)->~T(); }, object, finalizers.load(std::memory_order_relaxed)};
+            while (!finalizers.compare_exchange_weak(finalizer->next, finalizer, std::memory_order_release, std::memory_order_relaxed)) {}
+            return object;
+        }
+    }
+
+    // Destroys every object and forgets every allocation, keeping the chunks for reuse
+    void reset() noexcept;
+
+    // Destroys every object and frees every chunk, all in one call
+    void clear() noexcept;
+
+    // Chunks held by the arena, in use or free
+    [[nodiscard]] std::size_t chunkCount() const { return chunk_count.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+private:
+    struct Chunk {
+        Chunk* next_free; // in the free list
+        Chunk* next_all;  // in the list of every chunk, or of every oversized allocation
+        std::size_t size;
+
+        [[nodiscard]] char* data() { return reinterpret_cast<char*>(this) + HEADER_SIZE; }
+    };
+
+    // Intrusive list in the arena itself, newest first
+    struct Finalizer {
+        void (*destroy)(void*);
+        void* object;
+        Finalizer* next;
+    };
+
+    // The chunk a thread is bumping through, valid while `owner` is the generation of the arena using it
+    struct ThreadCache {
+        std::uint64_t owner;
+        char* current;
+        std::size_t remaining;
+    };
+
+    static inline thread_local ThreadCache cache{}; // owner 0 matches no arena
+
+    // Unique across every arena and every reset, so a stale cache can never match
+    static inline std::atomic<std::uint64_t> next_generation{1};
+
+    static constexpr std::size_t HEADER_SIZE = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    const std::size_t chunk_size;
+    std::uint64_t generation;
+
+    std::atomic<Chunk*> free_chunks{nullptr};
+    std::atomic<Chunk*> all_chunks{nullptr};
+    std::atomic<Chunk*> oversized{nullptr};
+    std::atomic<Finalizer*> finalizers{nullptr};
+    std::atomic<std::size_t> chunk_count{0};
+
+    void* allocateSlow(std::size_t size, std::size_t alignment);
+
+    // Pops a chunk off the free list, or mallocs one
+    Chunk* takeChunk();
+
+    static Chunk* newChunk(std::size_t size);
+
+    static void push(std::atomic<Chunk*>& list, Chunk* chunk, Chunk* Chunk::* next);
+
+    void runFinalizers() noexcept;
+};
+
+
+#endif //CONCURRENTARENA_H
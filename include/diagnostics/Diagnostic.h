@@ -6,23 +6,32 @@
 #define DIAGNOSTIC_H
 #include <string>
 
+#include "DiagnosticArgs.h"
 #include "DiagnosticKind.h"
 #include "DiagnosticSeverity.h"
 #include "../source/SourceLocation.h"
 #include "../source/SourceRange.h"
 
 
+// The message is not stored, only what it is made from: msg() renders it when the diagnostic is shown
 struct Diagnostic {
     const DiagnosticSeverity severity;
     const DiagnosticKind kind;
     const SourceRange source_range;
-    const std::string msg;
+    const DiagnosticArgs args{};
+
+    [[nodiscard]] std::string msg() const { return toMsg(kind, args); }
+
+    // The same diagnostic `delta` bytes later, or earlier if it is negative
+    [[nodiscard]] Diagnostic shiftedBy(const std::ptrdiff_t delta) const {
+        return {severity, kind, source_range.shiftedBy(delta), args};
+    }
 
     bool operator==(const Diagnostic& other) const {
         return severity == other.severity &&
                kind == other.kind &&
                source_range == other.source_range &&
-                   msg == other.msg;
+                   args == other.args;
     }
 };
 
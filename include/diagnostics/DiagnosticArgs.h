@@ -0,0 +1,109 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef DIAGNOSTICARGS_H
+#define DIAGNOSTICARGS_H
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+#include "../symbols/Symbol.h"
+#include "../tokeniser/Token.h"
+
+
+// One value a diagnostic's message mentions. Stored as a 4 byte word, and only turned into text when the
+// message is rendered.
+class DiagnosticArg {
+public:
+    enum class Type : std::uint8_t { SYMBOL, TOKEN_TYPE, INTEGER };
+
+    DiagnosticArg(const Symbol symbol): arg_type(Type::SYMBOL), value(symbol.id) {}
+
+    DiagnosticArg(const TokenType token_type): arg_type(Type::TOKEN_TYPE), value(static_cast<std::uint32_t>(token_type)) {}
+
+    DiagnosticArg(const std::int32_t integer): arg_type(Type::INTEGER), value(static_cast<std::uint32_t>(integer)) {}
+
+    [[nodiscard]] Type type() const { return arg_type; }
+
+    [[nodiscard]] Symbol symbol() const { assert(arg_type == Type::SYMBOL); return Symbol{value}; }
+
+    [[nodiscard]] TokenType tokenType() const { assert(arg_type == Type::TOKEN_TYPE); return static_cast<TokenType>(value); }
+
+    [[nodiscard]] std::int32_t integer() const { assert(arg_type == Type::INTEGER); return static_cast<std::int32_t>(value); }
+
+    [[nodiscard]] std::string toString() const {
+        switch (arg_type) {
+            case Type::SYMBOL: return symbol().str();
+            case Type::TOKEN_TYPE: return tokenTypeToString(tokenType());
+            case Type::INTEGER: return std::to_string(integer());
+        }
+        return {};
+    }
+
+    bool operator==(const DiagnosticArg& other) const = default;
+
+private:
+    Type arg_type;
+    std::uint32_t value;
+};
+
+// The arguments of one diagnostic, up to MAX_ARGS of them, stored inline
+class DiagnosticArgs {
+public:
+    static constexpr std::size_t MAX_ARGS = 2;
+
+    DiagnosticArgs() = default;
+
+    DiagnosticArgs(const std::initializer_list<DiagnosticArg> args): count(static_cast<std::uint8_t>(args.size())) {
+        assert(args.size() <= MAX_ARGS);
+        std::size_t i = 0;
+        for (const DiagnosticArg arg : args) {
+            types[i] = arg.type();
+            values[i] = raw(arg);
+            i++;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] DiagnosticArg operator[](const std::size_t index) const {
+        assert(index < count);
+        switch (types[index]) {
+            case DiagnosticArg::Type::SYMBOL: return Symbol{values[index]};
+            case DiagnosticArg::Type::TOKEN_TYPE: return static_cast<TokenType>(values[index]);
+            case DiagnosticArg::Type::INTEGER: break;
+        }
+        return static_cast<std::int32_t>(values[index]);
+    }
+
+    bool operator==(const DiagnosticArgs& other) const {
+        for (std::size_t i = 0; i < count; i++) {
+            if (i >= other.count || types[i] != other.types[i] || values[i] != other.values[i]) return false;
+        }
+        return count == other.count;
+    }
+
+private:
+    // Types and values apart, so the pack is 12 bytes rather than 16
+    std::array<std::uint32_t, MAX_ARGS> values{};
+    std::array<DiagnosticArg::Type, MAX_ARGS> types{};
+    std::uint8_t count = 0;
+
+    static std::uint32_t raw(const DiagnosticArg arg) {
+        switch (arg.type()) {
+            case DiagnosticArg::Type::SYMBOL: return arg.symbol().id;
+            case DiagnosticArg::Type::TOKEN_TYPE: return static_cast<std::uint32_t>(arg.tokenType());
+            case DiagnosticArg::Type::INTEGER: break;
+        }
+        return static_cast<std::uint32_t>(arg.integer());
+    }
+};
+
+
+
+#endif //DIAGNOSTICARGS_H
@@ -4,27 +4,186 @@
 
 #ifndef DIAGNOSTICENGINE_H
 #define DIAGNOSTICENGINE_H
-#include <string>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
 #include "Diagnostic.h"
+#include "DiagnosticSink.h"
 #include "../source/SourceLocation.h"
 
 
+// What a DiagnosticEngine keeps. By default, everything.
+struct DiagnosticOptions {
+    static constexpr std::size_t NO_LIMIT = SIZE_MAX;
+
+    // Past this many errors, further errors are dropped and workers are told to stop
+    std::size_t error_limit = NO_LIMIT;
+
+    // Merge a diagnostic into the one its thread reported just before, when they have the same severity, kind
+    // and args and it begins at most this many bytes after the other ends
+    std::optional<std::size_t> coalesce_gap = std::nullopt;
+
+    // Drop the parser errors a thread reports between beginRecovery() and endRecovery(). Lexical errors are
+    // always kept, the tokeniser may run lazily inside the parser on the same thread.
+    bool suppress_cascades = false;
+
+    // Where diagnostics are streamed to instead of being kept. A thread's diagnostic is handed over once the
+    // next one cannot be coalesced into it, or at beginFile() or flush(). The sink must outlive the engine.
+    DiagnosticSink* sink = nullptr;
+};
+
+// Collects the problems found by any number of threads at once. Each thread appends to a shard of its own, a
+// list of fixed-size chunks that is never reallocated, so reporting takes no lock and touches no shared state
+// besides two counters. getAll() merges the shards back into the order the problems were reported in.
+//
+// What the options drop is counted in stats(). Coalescing and recovery regions are per thread, so they never
+// merge or suppress one thread's diagnostics because of another's.
 class DiagnosticEngine {
 public:
-    void reportProblem(DiagnosticSeverity severity, DiagnosticKind kind, const SourceLocation location, const std::string& msg) {
-        diagnostics.emplace_back(severity, kind, SourceRange{location}, msg);
+    static constexpr std::size_t NO_LIMIT = DiagnosticOptions::NO_LIMIT;
+
+    struct Stats {
+        std::size_t coalesced;  // merged into the diagnostic before them
+        std::size_t cascades;   // parser errors reported while recovering
+        std::size_t over_limit; // errors reported past the error limit
+    };
+
+    explicit DiagnosticEngine(DiagnosticOptions options = {});
+
+    explicit DiagnosticEngine(const std::size_t error_limit): DiagnosticEngine(DiagnosticOptions{.error_limit = error_limit}) {}
+
+    ~DiagnosticEngine();
+
+    DiagnosticEngine(const DiagnosticEngine&) = delete;
+    DiagnosticEngine& operator=(const DiagnosticEngine&) = delete;
+
+    void reportProblem(DiagnosticSeverity severity, DiagnosticKind kind, const SourceLocation location, const DiagnosticArgs args = {}) {
+        reportProblem(severity, kind, SourceRange{location}, args);
+    }
+
+    void reportProblem(DiagnosticSeverity severity, DiagnosticKind kind, SourceRange range, DiagnosticArgs args = {});
+
+    // The calling thread has reported an error and is skipping tokens to resynchronise. Until it has parsed
+    // something successfully again, its parser errors are most likely caused by the first one.
+    void beginRecovery() {
+        if (options.suppress_cascades) currentShard()->recovering = true;
     }
 
-    void reportProblem(DiagnosticSeverity severity, DiagnosticKind kind, SourceRange range, const std::string& msg) {
-        diagnostics.emplace_back(severity, kind, range, msg);
+    void endRecovery() {
+        if (options.suppress_cascades) currentShard()->recovering = false;
     }
 
-    [[nodiscard]] const std::vector<Diagnostic>& getAll() const { return diagnostics; }
+    // The calling thread moves on to another file. Nothing it reports from now on is coalesced into, or
+    // suppressed because of, what it reported before.
+    void beginFile() {
+        if (!options.coalesce_gap && !options.suppress_cascades) return;
+        Shard* shard = currentShard();
+        shard->recovering = false;
+        shard->run_start = shard->published.load(std::memory_order_relaxed);
+        if (options.sink) sendPending(shard);
+    }
+
+    // Hands the diagnostics every thread is holding back for coalescing to the sink, and flushes it. It must
+    // not run while other threads report.
+    void flush();
+
+    [[nodiscard]] bool limitReached() const { return error_count.load(std::memory_order_relaxed) >= options.error_limit; }
+
+    // Errors the calling thread has reported and the engine kept or streamed, to tell how many a piece of its
+    // work reported
+    [[nodiscard]] std::size_t threadErrorCount() { return currentShard()->errors; }
+
+    [[nodiscard]] Stats stats() const;
+
+    // Diagnostics kept so far, without merging them. None are kept when streaming to a sink.
+    [[nodiscard]] std::size_t count() const;
+
+    // Every diagnostic kept so far, in the order they were reported. It may be called while other threads
+    // report, and sees what they have reported by then. The vector is rebuilt by the next call that finds
+    // more, so it must not be read while another thread calls getAll().
+    [[nodiscard]] const std::vector<Diagnostic>& getAll() const;
 
 private:
-    std::vector<Diagnostic> diagnostics;
+    struct Entry {
+        std::uint64_t sequence;
+        Diagnostic diagnostic;
+        std::atomic<std::uint32_t> end; // of its range, which grows as diagnostics are coalesced into it
+    };
+
+    struct Chunk {
+        static constexpr std::size_t CAPACITY = 64;
+
+        alignas(Entry) std::byte storage[CAPACITY * sizeof(Entry)];
+        Chunk* next = nullptr; // written before the first entry in it is published
+
+        [[nodiscard]] Entry* at(const std::size_t index) { return reinterpret_cast<Entry*>(storage) + index; }
+        [[nodiscard]] const Entry* at(const std::size_t index) const { return reinterpret_cast<const Entry*>(storage) + index; }
+    };
+
+    // Written only by the thread that owns it, read by anyone up to `published`
+    struct Shard {
+        explicit Shard(const std::thread::id owner): owner(owner) {}
+
+        const std::thread::id owner;
+        Shard* next = nullptr; // in the list of every shard, fixed once pushed
+        Chunk* head = nullptr;
+        Chunk* tail = nullptr;
+        std::atomic<std::size_t> published{0};
+        std::atomic<std::size_t> revision{0}; // bumped by every entry added or extended
+        std::atomic<std::size_t> coalesced{0};
+        std::atomic<std::size_t> cascades{0};
+        // Only ever read by the owner, or by flush()
+        bool recovering = false;
+        std::size_t errors = 0;
+        std::size_t run_start = 0; // the first entry later ones may be coalesced into
+        std::optional<Diagnostic> pending; // not yet handed to the sink
+        std::uint32_t pending_end = 0;
+
+        [[nodiscard]] Entry* last() { return tail->at((published.load(std::memory_order_relaxed) - 1) % Chunk::CAPACITY); }
+    };
+
+    // The shard a thread reports to, valid while `owner` is the generation of the engine it belongs to
+    struct ThreadCache {
+        std::uint64_t owner;
+        Shard* shard;
+    };
+
+    static inline thread_local ThreadCache cache{}; // owner 0 matches no engine
+
+    // Unique across every engine, so a cache left by a destroyed engine can never match a new one
+    static inline std::atomic<std::uint64_t> next_generation{1};
+
+    const DiagnosticOptions options;
+    const std::uint64_t generation;
+
+    std::atomic<Shard*> shards{nullptr};
+    std::atomic<std::uint64_t> next_sequence{0};
+    std::atomic<std::size_t> error_count{0};
+
+    mutable std::mutex merge_mutex;
+    mutable std::vector<Diagnostic> merged;
+    mutable std::size_t merged_revision = 0;
+
+    Shard* currentShard() { return cache.owner == generation ? cache.shard : shardForThisThread(); }
+
+    // Whether a diagnostic may be merged into `last`, which now ends at `end`
+    [[nodiscard]] bool canCoalesce(const Diagnostic& last, std::uint32_t end, DiagnosticSeverity severity, DiagnosticKind kind, SourceRange range, DiagnosticArgs args) const;
+
+    // Extends the thread's last diagnostic over `range`, if the options allow it
+    bool coalesce(Shard* shard, DiagnosticSeverity severity, DiagnosticKind kind, SourceRange range, DiagnosticArgs args) const;
+
+    // The same as reportProblem(), for an engine with a sink
+    void stream(Shard* shard, DiagnosticSeverity severity, DiagnosticKind kind, SourceRange range, DiagnosticArgs args);
+
+    void sendPending(Shard* shard) const;
+
+    // Finds this thread's shard in the list, or pushes a new one
+    Shard* shardForThisThread();
 };
 
 
@@ -5,8 +5,10 @@
 #ifndef DIAGNOSTICKIND_H
 #define DIAGNOSTICKIND_H
 
+#include <array>
 #include <magic_enum.hpp>
 #include <optional>
+#include "DiagnosticArgs.h"
 #include "../tokeniser/Token.h"
 
 
@@ -14,6 +16,7 @@
 enum class DiagnosticKind {
     UNTERMINATED_STRING_LITERAL,
     UNRECOGNISED_TOKEN,
+    TOKEN_TOO_LONG,
     EXPECTED_DECLARATION,
     EXPECTED_CLASS_NAME,
     EXPECTED_SOMETHING,
@@ -24,20 +27,30 @@ enum class DiagnosticKind {
     EXPECTED_TYPEDEF,
 };
 
-inline std::string toMsg(const DiagnosticKind kind, const std::string& aux) {
-    switch (kind) {
-        case DiagnosticKind::EXPECTED_SOMETHING:
-            return "Expected '" + aux + "'";
-        default:
-            throw std::runtime_error("Kind cannot be converted to msg with aux.");
-    }
+// Whether a kind comes from the parser, and so may be caused by an earlier parse error. Lexical errors are
+// about the text itself, whatever state the parser is in.
+inline constexpr bool isParserDiagnostic(const DiagnosticKind kind) {
+    return kind != DiagnosticKind::UNTERMINATED_STRING_LITERAL && kind != DiagnosticKind::UNRECOGNISED_TOKEN &&
+        kind != DiagnosticKind::TOKEN_TOO_LONG;
 }
 
-inline DiagnosticKind expectedTokenTypeToDiagnosticKind(const TokenType tokenType) {
-    const auto typeName = std::string{magic_enum::enum_name(tokenType)};
+// EXPECTED_<name> for every token type that has one, matched up by name at compile time so the parser's
+// error recovery does not build strings to look it up
+inline constexpr auto EXPECTED_TOKEN_KINDS = [] {
+    std::array<std::optional<DiagnosticKind>, static_cast<std::size_t>(magic_enum::enum_values<TokenType>().back()) + 1> kinds{};
+    for (const DiagnosticKind kind : magic_enum::enum_values<DiagnosticKind>()) {
+        const std::string_view name = magic_enum::enum_name(kind);
+        if (!name.starts_with("EXPECTED_")) continue;
+        if (const auto type = magic_enum::enum_cast<TokenType>(name.substr(9))) {
+            kinds[static_cast<std::size_t>(*type)] = kind;
+        }
+    }
+    return kinds;
+}();
 
+inline DiagnosticKind expectedTokenTypeToDiagnosticKind(const TokenType tokenType) {
     // TODO - Ensure each token type has one, or throw error on failure
-    return magic_enum::enum_cast<DiagnosticKind>("EXPECTED_" + typeName).value();
+    return EXPECTED_TOKEN_KINDS[static_cast<std::size_t>(tokenType)].value();
 }
 
 inline std::optional<TokenType> expectedDiagnosticToTokenType(const DiagnosticKind kind) {
@@ -85,6 +98,8 @@ inline std::string toMsg(const DiagnosticKind kind) {
             return "Unterminated string literal.";
         case DiagnosticKind::UNRECOGNISED_TOKEN:
             return "Unrecognised token.";
+        case DiagnosticKind::TOKEN_TOO_LONG:
+            return "Token is too long.";
         case DiagnosticKind::EXPECTED_DECLARATION:
             return "Expected a declaration.";
         case DiagnosticKind::EXPECTED_CLASS_NAME:
@@ -100,4 +115,16 @@ inline std::string toMsg(const DiagnosticKind kind) {
     }
 }
 
+// The message of a diagnostic with arguments. Diagnostics only keep their kind and arguments, this runs when
+// one is shown.
+inline std::string toMsg(const DiagnosticKind kind, const DiagnosticArgs& args) {
+    switch (kind) {
+        case DiagnosticKind::EXPECTED_SOMETHING:
+            if (args.empty()) throw std::runtime_error("Kind cannot be converted to msg without args.");
+            return "Expected '" + args[0].toString() + "'";
+        default:
+            return toMsg(kind);
+    }
+}
+
 #endif //DIAGNOSTICKIND_H
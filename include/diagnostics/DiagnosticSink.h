@@ -0,0 +1,43 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef DIAGNOSTICSINK_H
+#define DIAGNOSTICSINK_H
+#include <mutex>
+#include <vector>
+
+#include "Diagnostic.h"
+
+
+// Where a DiagnosticEngine streams diagnostics to while workers are still reporting them. consume() is called
+// by whichever thread reported the diagnostic, so it may run on several threads at once.
+class DiagnosticSink {
+public:
+    virtual ~DiagnosticSink() = default;
+
+    virtual void consume(const Diagnostic& diagnostic) = 0;
+
+    // No more diagnostics are coming for now, write out whatever is buffered
+    virtual void flush() {}
+};
+
+// Keeps every diagnostic in a vector, in the order they arrived
+class CollectingSink final : public DiagnosticSink {
+public:
+    void consume(const Diagnostic& diagnostic) override {
+        std::lock_guard lock{mutex};
+        diagnostics.push_back(diagnostic);
+    }
+
+    // Not to be called while diagnostics are still arriving
+    [[nodiscard]] const std::vector<Diagnostic>& getAll() const { return diagnostics; }
+
+private:
+    std::mutex mutex;
+    std::vector<Diagnostic> diagnostics;
+};
+
+
+
+#endif //DIAGNOSTICSINK_H
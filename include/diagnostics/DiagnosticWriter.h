@@ -0,0 +1,81 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef DIAGNOSTICWRITER_H
+#define DIAGNOSTICWRITER_H
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "DiagnosticSink.h"
+#include "../source/SourceManager.h"
+
+
+// A sink that writes diagnostics out as they arrive, with positions resolved through a SourceManager that
+// every diagnostic's location belongs to. Each one is formatted on the thread that reported it, then added
+// to a buffer that is written to the stream whenever it grows past `buffer_size`, so memory stays bounded
+// however many diagnostics there are.
+class DiagnosticWriter : public DiagnosticSink {
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    DiagnosticWriter(std::ostream& out, const SourceManager& source_manager, std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+    ~DiagnosticWriter() override;
+
+    DiagnosticWriter(const DiagnosticWriter&) = delete;
+    DiagnosticWriter& operator=(const DiagnosticWriter&) = delete;
+
+    void consume(const Diagnostic& diagnostic) final;
+
+    void flush() override;
+
+    [[nodiscard]] std::size_t written() const;
+
+    // How many of those written were errors
+    [[nodiscard]] std::size_t errors() const;
+
+protected:
+    const SourceManager& source_manager;
+
+    struct Position {
+        const std::filesystem::path& path;
+        LineColumn begin;
+        LineColumn end;
+    };
+
+    [[nodiscard]] Position resolve(const SourceRange& range) const;
+
+    // Appends the text of one diagnostic to `text`
+    virtual void format(const Diagnostic& diagnostic, std::string& text) const = 0;
+
+    // Written between two diagnostics
+    void setSeparator(std::string_view separator);
+
+    // Adds text outside of any diagnostic, such as a header or footer
+    void writeRaw(std::string_view text);
+
+    static void appendJsonString(std::string& text, std::string_view str);
+
+    static void appendNumber(std::string& text, std::size_t number);
+
+private:
+    std::ostream& out;
+    const std::size_t buffer_size;
+
+    mutable std::mutex mutex;
+    std::string buffer;
+    std::string separator;
+    std::size_t count = 0;
+    std::size_t error_count = 0;
+
+    // With the mutex held
+    void append(std::string_view text);
+    void flushBuffer();
+};
+
+
+
+#endif //DIAGNOSTICWRITER_H
@@ -0,0 +1,24 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef JSONLINESWRITER_H
+#define JSONLINESWRITER_H
+
+#include "DiagnosticWriter.h"
+
+
+// One JSON object per line and per diagnostic, for tools that read a build's output as it runs:
+// {"file":"a.kahwa","line":3,"column":5,"end_line":3,"end_column":6,"severity":"error","kind":"UNRECOGNISED_TOKEN","message":"Unrecognised token."}
+// Columns are 1-based and count bytes, the end is exclusive.
+class JsonLinesWriter final : public DiagnosticWriter {
+public:
+    using DiagnosticWriter::DiagnosticWriter;
+
+protected:
+    void format(const Diagnostic& diagnostic, std::string& text) const override;
+};
+
+
+
+#endif //JSONLINESWRITER_H
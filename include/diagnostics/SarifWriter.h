@@ -0,0 +1,31 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef SARIFWRITER_H
+#define SARIFWRITER_H
+
+#include "DiagnosticWriter.h"
+
+
+// A SARIF 2.1.0 log with a single run, for code scanning tools. Results are streamed as they arrive: the
+// header is written straight away and the closing brackets by finish(), or by the destructor.
+class SarifWriter final : public DiagnosticWriter {
+public:
+    SarifWriter(std::ostream& out, const SourceManager& source_manager, std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
+
+    ~SarifWriter() override;
+
+    // Completes the log, after which nothing more may be consumed
+    void finish();
+
+protected:
+    void format(const Diagnostic& diagnostic, std::string& text) const override;
+
+private:
+    bool finished = false;
+};
+
+
+
+#endif //SARIFWRITER_H
@@ -0,0 +1,57 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef DRIVER_H
+#define DRIVER_H
+#include <string_view>
+#include <vector>
+
+#include "Project.h"
+#include "ThreadPool.h"
+#include "../diagnostics/DiagnosticEngine.h"
+#include "../source/SourceManager.h"
+#include "../tokeniser/Token.h"
+
+
+// Tokenises and parses files in parallel. Each worker owns an Arena, and all of them report to one sharded
+// DiagnosticEngine with the Driver's options. The error limit keeps the first errors in file order, and the
+// files after the one holding the last of them are left empty, so the result does not depend on the thread
+// count. Once that file is known, workers start no file after it, but finish the ones they are parsing. With
+// a sink in the options, diagnostics are streamed to it in the order they are reported, the limit applies in
+// that order, and they are flushed by parse().
+class Driver {
+public:
+    explicit Driver(const std::size_t threads = std::thread::hardware_concurrency(), const DiagnosticOptions diagnostic_options = {})
+        : pool(threads), diagnostic_options(diagnostic_options) {}
+
+    // `sources[i]` is parsed as file_id `i`, at the location a SourceManager would have given it had the
+    // files been added in order
+    [[nodiscard]] Project parse(const std::vector<std::string_view>& sources);
+
+    [[nodiscard]] Project parse(const SourceManager& source_manager);
+
+    // A single large file, its top-level declarations parsed in chunks on the pool's threads. The result is
+    // the file and diagnostics parse({source}) would give with the default diagnostic options: the chunks
+    // are stitched together by diagnostic counts, so every diagnostic is kept.
+    [[nodiscard]] Project parseFileParallel(std::string_view source);
+
+    // Chunks are no smaller than these, below them the threads cost more than they save
+    static constexpr std::size_t MIN_CHUNK_BYTES = 32 * 1024;
+    static constexpr std::size_t MIN_CHUNK_TOKENS = 4096;
+
+    [[nodiscard]] std::size_t threads() const { return pool.size(); }
+
+private:
+    ThreadPool pool;
+    const DiagnosticOptions diagnostic_options;
+
+    Project parse(const std::vector<std::string_view>& sources, const std::vector<SourceLocation>& file_starts);
+
+    // What Tokeniser::tokenise() gives for `source`, and the problems it reports
+    std::vector<Token> tokeniseParallel(std::string_view source, std::vector<Diagnostic>& diagnostics);
+};
+
+
+
+#endif //DRIVER_H
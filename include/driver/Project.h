@@ -0,0 +1,27 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef PROJECT_H
+#define PROJECT_H
+#include <memory>
+#include <vector>
+
+#include "../arena/Arena.h"
+#include "../diagnostics/DiagnosticEngine.h"
+#include "../parser/ClassDecl.h"
+#include "../parser/KahwaFile.h"
+
+
+// Every file of a compilation, parsed. The ASTs live in the arenas, so they are valid for as long as the
+// Project is.
+struct Project {
+    std::vector<KahwaFile*> files; // indexed by file_id
+    std::vector<Diagnostic> diagnostics; // ordered by location, so by file_id, then position. Empty with a sink.
+    DiagnosticEngine::Stats dropped_diagnostics{}; // what the Driver's diagnostic options left out
+    std::vector<std::unique_ptr<Arena>> arenas;
+};
+
+
+
+#endif //PROJECT_H
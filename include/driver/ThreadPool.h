@@ -0,0 +1,62 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed set of worker threads running index-parallel loops. Each worker has its own queue of indices and
+// steals from the back of the others' once it runs dry, so a few large inputs do not leave the rest idle.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+    // Calls `fn(index, worker)` once for every index in [0, count) and blocks until all calls return.
+    // `worker` is in [0, size()) and no two calls with the same worker run at once, so it can index
+    // per-worker state. The first exception thrown by `fn` is rethrown here once the loop has drained.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t index, std::size_t worker)>& fn);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> indices;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    const std::function<void(std::size_t, std::size_t)>* job = nullptr;
+    std::size_t generation = 0;
+    std::size_t busy = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void workerLoop(std::size_t worker);
+
+    // Own queue from the front, then the others' from the back
+    bool nextIndex(std::size_t worker, std::size_t& index);
+};
+
+
+
+#endif //THREADPOOL_H
@@ -0,0 +1,192 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef BINARYAST_H
+#define BINARYAST_H
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "ClassDecl.h"
+#include "KahwaFile.h"
+#include "TypeTable.h"
+#include "../arena/Arena.h"
+
+
+// The layout of a serialised AST. Every field is 4 bytes and every node 4-aligned, so an image can be read
+// in place wherever it is loaded. Pointers are offsets from the field that holds them, 0 for null.
+namespace binary_ast {
+
+inline constexpr std::uint32_t MAGIC = 0x5453414b; // "KAST"
+inline constexpr std::uint32_t VERSION = 1;
+
+template <typename T>
+class RelPtr {
+public:
+    [[nodiscard]] const T* get() const {
+        if (offset == 0) return nullptr;
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(this) + offset);
+    }
+
+    const T& operator*() const { assert(offset != 0); return *get(); }
+    const T* operator->() const { assert(offset != 0); return get(); }
+    explicit operator bool() const { return offset != 0; }
+
+    std::int32_t offset;
+};
+
+template <typename T>
+class RelArray {
+public:
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] const T* begin() const { return first.get(); }
+    [[nodiscard]] const T* end() const { return first.get() + count; }
+
+    const T& operator[](const std::size_t i) const { assert(i < count); return first.get()[i]; }
+
+    std::uint32_t count;
+    RelPtr<T> first;
+};
+
+// Index into the image's string table
+using StringId = std::uint32_t;
+
+// Offsets from the start of the file the AST was parsed from, modulo 2^32
+struct Range {
+    std::uint32_t begin;
+    std::uint32_t end;
+};
+
+// Shared by every mention of the same type, as in a TypeTable
+struct TypeRef {
+    StringId identifier;
+    RelArray<RelPtr<TypeRef>> args;
+};
+
+struct Decl {
+    StringId name;
+    RelArray<Modifier> modifiers;
+    Range name_range;
+    Range body_range;
+};
+
+struct TypedefDecl {
+    Decl decl;
+    Range typedef_range;
+    RelPtr<TypeRef> referred_type;
+};
+
+struct FieldDecl {
+    Decl decl;
+    RelPtr<TypeRef> type;
+    Range type_range;
+};
+
+struct Parameter {
+    RelPtr<TypeRef> type;
+    StringId name;
+};
+
+// Statements have no contents yet, only how many there are
+struct Block {
+    std::uint32_t stmts;
+};
+
+struct MethodDecl {
+    Decl decl;
+    RelPtr<TypeRef> return_type;
+    RelArray<Parameter> parameters;
+    RelPtr<Block> block;
+    Range return_type_range;
+};
+
+struct ClassDecl {
+    Decl decl;
+    Range class_range;
+    RelArray<RelPtr<TypeRef>> super_classes;
+    RelArray<RelPtr<FieldDecl>> fields;
+    RelArray<RelPtr<MethodDecl>> methods;
+    RelArray<RelPtr<ClassDecl>> nested_classes;
+};
+
+struct KahwaFile {
+    RelArray<RelPtr<TypedefDecl>> typedef_decls;
+    RelArray<RelPtr<ClassDecl>> class_decls;
+    RelArray<RelPtr<MethodDecl>> function_decls;
+    RelArray<RelPtr<FieldDecl>> variable_decls;
+};
+
+// At offset 0
+struct Header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t size; // of the whole image
+    RelArray<RelArray<char>> strings;
+    RelPtr<KahwaFile> file;
+};
+
+}
+
+// A KahwaFile saved as a single block of bytes, so that tools can cache what they parsed instead of parsing
+// it again. Nodes are written children first and reference each other by relative offsets, so a mapped
+// image is walked in place through file() with no deserialisation pass. load() rebuilds the pointer tree
+// for code that needs one.
+//
+// Symbols are saved as strings, since their ids only mean something within one process, and locations
+// relative to the start of the file, since where a file starts depends on the files added before it.
+// Images are trusted like any other build output: view() checks the header, not every offset.
+class BinaryAst {
+public:
+    [[nodiscard]] static std::string serialise(const KahwaFile& file, SourceLocation file_start);
+
+    // An image written by this version, or nothing. `bytes` must be 4-aligned and outlive the view.
+    [[nodiscard]] static std::optional<BinaryAst> view(std::string_view bytes);
+
+    [[nodiscard]] const binary_ast::KahwaFile& file() const { return *header->file; }
+
+    [[nodiscard]] std::string_view str(const binary_ast::StringId id) const {
+        const auto& chars = header->strings[id];
+        return {chars.begin(), chars.size()};
+    }
+
+    [[nodiscard]] std::size_t size() const { return header->size; }
+
+    // The pointer tree, in `arena` and with types interned in `types`, for a file that now starts at
+    // `file_start`. It does not refer to the image.
+    [[nodiscard]] KahwaFile* load(Arena& arena, TypeTable& types, SourceLocation file_start) const;
+
+private:
+    const binary_ast::Header* header;
+
+    explicit BinaryAst(const binary_ast::Header* header): header(header) {}
+};
+
+// An image file mapped read-only for as long as this lives
+class MappedAst {
+public:
+    // Throws std::filesystem::filesystem_error if the file cannot be opened or mapped
+    explicit MappedAst(const std::filesystem::path& path);
+
+    ~MappedAst();
+
+    MappedAst(const MappedAst&) = delete;
+    MappedAst& operator=(const MappedAst&) = delete;
+
+    [[nodiscard]] std::string_view bytes() const { return {static_cast<const char*>(data), size}; }
+
+    [[nodiscard]] std::optional<BinaryAst> ast() const { return BinaryAst::view(bytes()); }
+
+private:
+    void* data = nullptr;
+    std::size_t size = 0;
+};
+
+
+
+#endif //BINARYAST_H
@@ -4,14 +4,14 @@
 
 #ifndef BLOCK_H
 #define BLOCK_H
-#include <vector>
 
 #include "Stmt.h"
+#include "../arena/ArenaSpan.h"
 
 
 struct Block {
-    explicit Block(const std::vector<Stmt*>& stmts): stmts(stmts) {}
-    const std::vector<Stmt*> stmts;
+    explicit Block(const ArenaSpan<Stmt*> stmts): stmts(stmts) {}
+    const ArenaSpan<Stmt*> stmts;
 
     bool operator==(const Block &other) const {
         if (stmts.size() != other.stmts.size()) return false;
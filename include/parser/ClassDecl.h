@@ -15,27 +15,27 @@
 #include "../tokeniser/Token.h"
 
 struct ClassDecl : Decl {
-    ClassDecl(std::string name,
+    ClassDecl(const Symbol name,
         const SourceRange &classSourceRange,
         const SourceRange &nameSourceRange,
         const SourceRange &bodyRange,
-        const std::vector<Modifier> &modifiers = {},
-        const std::vector<TypeRef*>& superClasses = {},
-        const std::vector<FieldDecl*> &fields = {},
-        const std::vector<MethodDecl*> &methods = {},
-        const std::vector<ClassDecl*> &nestedClasses = {}
+        const ArenaSpan<Modifier> modifiers = {},
+        const ArenaSpan<TypeRef*> superClasses = {},
+        const ArenaSpan<FieldDecl*> fields = {},
+        const ArenaSpan<MethodDecl*> methods = {},
+        const ArenaSpan<ClassDecl*> nestedClasses = {}
         ):
-    Decl(std::move(name), modifiers, nameSourceRange, bodyRange),
+    Decl(name, modifiers, nameSourceRange, bodyRange),
     superClasses(superClasses),
     fields(fields),
     methods(methods),
     nestedClasses(nestedClasses),
     classSourceRange(classSourceRange) {}
 
-    const std::vector<TypeRef*> superClasses;
-    const std::vector<FieldDecl*> fields;
-    const std::vector<MethodDecl*> methods;
-    const std::vector<ClassDecl*> nestedClasses;
+    const ArenaSpan<TypeRef*> superClasses;
+    const ArenaSpan<FieldDecl*> fields;
+    const ArenaSpan<MethodDecl*> methods;
+    const ArenaSpan<ClassDecl*> nestedClasses;
 
     const SourceRange classSourceRange;
 
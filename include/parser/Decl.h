@@ -7,21 +7,23 @@
 #include <utility>
 
 #include "Modifier.h"
+#include "../arena/ArenaSpan.h"
 #include "../source/SourceRange.h"
+#include "../symbols/Symbol.h"
 
 
 struct Decl {
-    Decl(std::string name,
-    const std::vector<Modifier> &modifiers,
+    Decl(const Symbol name,
+    const ArenaSpan<Modifier> modifiers,
     const SourceRange &nameSourceRange,
     const SourceRange &bodyRange):
-    name(std::move(name)),
+    name(name),
     modifiers(modifiers),
     nameSourceRange(nameSourceRange),
     bodyRange(bodyRange) {}
 
-    const std::string name;
-    const std::vector<Modifier> modifiers;
+    const Symbol name;
+    const ArenaSpan<Modifier> modifiers;
 
     const SourceRange nameSourceRange;
     const SourceRange bodyRange;
@@ -15,13 +15,13 @@
 
 struct FieldDecl : Decl {
     FieldDecl(
-    std::string name,
-    const std::vector<Modifier> &modifiers,
+    const Symbol name,
+    const ArenaSpan<Modifier> modifiers,
     TypeRef* type,
     const SourceRange &typeSourceRange,
     const SourceRange &nameSourceRange,
     const SourceRange &bodyRange):
-    Decl(std::move(name), modifiers, nameSourceRange, bodyRange),
+    Decl(name, modifiers, nameSourceRange, bodyRange),
     type(type),
     typeSourceRange(typeSourceRange) {}
 
@@ -0,0 +1,126 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef FLATAST_H
+#define FLATAST_H
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "ClassDecl.h"
+#include "KahwaFile.h"
+
+
+using NodeId = std::uint32_t;
+
+enum class NodeKind : std::uint8_t {
+    FILE,
+    TYPEDEF,
+    CLASS,
+    METHOD,
+    FIELD,
+    TYPE_REF,
+    BLOCK,
+};
+
+// The AST of one file flattened into parallel arrays indexed by NodeId, for passes that visit every node.
+//
+// Nodes are numbered breadth-first, so the children of a node are a contiguous range of ids and a walk over
+// every node is a linear scan. Only the hot fields (kind, name, location and the tree links) live in the
+// arrays. Everything else is read through node<T>(), which returns the pointer node the flat one was built
+// from, so the pointer tree must outlive the FlatAst.
+//
+// Children are in the order of the pointer node's members: a class's superclasses, fields, methods and
+// nested classes; a method's return type, parameter types and block; a type's arguments.
+class FlatAst {
+public:
+    explicit FlatAst(const KahwaFile& file);
+
+    static constexpr NodeId ROOT = 0;
+    static constexpr NodeId NO_NODE = UINT32_MAX;
+
+    [[nodiscard]] std::size_t size() const { return kinds.size(); }
+
+    [[nodiscard]] NodeKind kind(const NodeId id) const { return kinds[id]; }
+
+    // The declared name, or the type's identifier; none for files and blocks
+    [[nodiscard]] std::optional<Symbol> name(const NodeId id) const {
+        if (names[id] == NO_NAME) return std::nullopt;
+        return Symbol{names[id]};
+    }
+
+    // Where the name starts. Files, blocks and types have no range of their own and take their parent's,
+    // the file that of its first declaration.
+    [[nodiscard]] SourceLocation location(const NodeId id) const { return SourceLocation{locations[id]}; }
+
+    [[nodiscard]] NodeId parent(const NodeId id) const { return parents[id]; }
+
+    // Children as a range of ids, valid as indices into every array
+    struct Children {
+        NodeId first;
+        NodeId last;
+
+        struct Iterator {
+            NodeId id;
+
+            NodeId operator*() const { return id; }
+            Iterator& operator++() { ++id; return *this; }
+            bool operator==(const Iterator&) const = default;
+        };
+
+        [[nodiscard]] Iterator begin() const { return {first}; }
+        [[nodiscard]] Iterator end() const { return {last}; }
+        [[nodiscard]] std::size_t size() const { return last - first; }
+        [[nodiscard]] bool empty() const { return first == last; }
+    };
+
+    [[nodiscard]] Children children(const NodeId id) const {
+        return {first_children[id], first_children[id] + child_counts[id]};
+    }
+
+    template <typename T>
+    [[nodiscard]] const T& node(const NodeId id) const {
+        assert(kinds[id] == kindOf<T>());
+        return *static_cast<const T*>(nodes[id]);
+    }
+
+private:
+    static constexpr std::uint32_t NO_NAME = UINT32_MAX;
+
+    // Hot
+    std::vector<NodeKind> kinds;
+    std::vector<std::uint32_t> names;
+    std::vector<std::uint32_t> locations;
+    std::vector<NodeId> parents;
+    std::vector<NodeId> first_children;
+    std::vector<std::uint32_t> child_counts;
+
+    // Cold
+    std::vector<const void*> nodes;
+
+    NodeId append(NodeKind kind, const void* node, std::optional<Symbol> name, SourceLocation location, NodeId parent);
+
+    // Nodes are expanded in id order, which numbers them breadth-first
+    void appendChildren(NodeId id);
+
+    template <typename T>
+    static constexpr NodeKind kindOf() {
+        if constexpr (std::is_same_v<T, KahwaFile>) return NodeKind::FILE;
+        else if constexpr (std::is_same_v<T, TypedefDecl>) return NodeKind::TYPEDEF;
+        else if constexpr (std::is_same_v<T, ClassDecl>) return NodeKind::CLASS;
+        else if constexpr (std::is_same_v<T, MethodDecl>) return NodeKind::METHOD;
+        else if constexpr (std::is_same_v<T, FieldDecl>) return NodeKind::FIELD;
+        else if constexpr (std::is_same_v<T, TypeRef>) return NodeKind::TYPE_REF;
+        else {
+            static_assert(std::is_same_v<T, Block>);
+            return NodeKind::BLOCK;
+        }
+    }
+};
+
+
+
+#endif //FLATAST_H
@@ -0,0 +1,72 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef INCREMENTALPARSER_H
+#define INCREMENTALPARSER_H
+#include <string_view>
+#include <vector>
+
+#include "Parser.h"
+#include "TypeTable.h"
+#include "../source/TextEdit.h"
+
+
+// Keeps one file parsed across edits, for an editor that reparses on every keystroke.
+//
+// An edit is relexed with Tokeniser::relex(), which stops once the new tokens line up with the old ones again.
+// Parsing then resumes at the last top-level declaration boundary safely before the changed tokens, and stops
+// at the first boundary after them that the previous parse also stopped at: from there on both parses see
+// the same tokens, so the old declarations and diagnostics are spliced back in with their ranges shifted.
+// The result is the AST a full parse of the new text would give.
+//
+// Nodes of earlier versions stay in the arena. Reset it and parse() from scratch now and then to reclaim them.
+class IncrementalParser {
+public:
+    struct Stats {
+        std::size_t tokens_relexed;
+        std::size_t declarations_reparsed;
+        std::size_t declarations_reused; // whether shifted or not
+    };
+
+    IncrementalParser(Arena& arena, SourceLocation file_start): arena(arena), types(arena), file_start(file_start) {}
+
+    // Parses `source` from scratch
+    KahwaFile* parse(std::string_view source);
+
+    // `file` must be the last result of this parser, and `source` its text after `edit`
+    KahwaFile* reparse(const KahwaFile* file, std::string_view source, const TextEdit& edit);
+
+    [[nodiscard]] const std::vector<Token>& tokens() const { return current_tokens; }
+
+    // What tokenise() and then parseFile() would report: lexer diagnostics first, then parser ones
+    [[nodiscard]] std::vector<Diagnostic> diagnostics() const;
+
+    // About the last call to reparse()
+    [[nodiscard]] const Stats& stats() const { return last_stats; }
+
+private:
+    using Checkpoint = Parser::Boundary;
+
+    Arena& arena;
+    TypeTable types;
+    const SourceLocation file_start;
+
+    const KahwaFile* file = nullptr;
+    std::size_t source_size = 0;
+    std::vector<Token> current_tokens;
+    std::vector<Diagnostic> lexer_diagnostics;
+    std::vector<Diagnostic> parser_diagnostics;
+    std::vector<Checkpoint> checkpoints;
+    Stats last_stats{};
+
+    // Parses from `start` until the end of the tokens, or until `converged` accepts a checkpoint
+    template <typename Converged>
+    std::size_t parseFrom(const Checkpoint& start, Parser::Declarations& decls, std::vector<Diagnostic>& diagnostics, std::vector<Checkpoint>& reached, Converged&& converged);
+
+    [[nodiscard]] std::size_t relative(const SourceLocation location) const { return location.offset - file_start.offset; }
+};
+
+
+
+#endif //INCREMENTALPARSER_H
@@ -4,25 +4,25 @@
 
 #ifndef KAHWAFILE_H
 #define KAHWAFILE_H
-#include <vector>
 
 #include "TypedefDecl.h"
+#include "../arena/ArenaSpan.h"
 
 
 struct KahwaFile {
-    explicit KahwaFile(const std::vector<TypedefDecl*> &typedefDecls = {},
-        const std::vector<ClassDecl*> &classDecls = {},
-        const std::vector<MethodDecl*> &functionDecls = {},
-        const std::vector<FieldDecl*> &variableDecls = {}):
+    explicit KahwaFile(const ArenaSpan<TypedefDecl*> typedefDecls = {},
+        const ArenaSpan<ClassDecl*> classDecls = {},
+        const ArenaSpan<MethodDecl*> functionDecls = {},
+        const ArenaSpan<FieldDecl*> variableDecls = {}):
     typedefDecls(typedefDecls),
     classDecls(classDecls),
     functionDecls(functionDecls),
     variableDecls(variableDecls) {}
 
-    const std::vector<TypedefDecl*> typedefDecls;
-    const std::vector<ClassDecl*> classDecls;
-    const std::vector<MethodDecl*> functionDecls;
-    const std::vector<FieldDecl*> variableDecls;
+    const ArenaSpan<TypedefDecl*> typedefDecls;
+    const ArenaSpan<ClassDecl*> classDecls;
+    const ArenaSpan<MethodDecl*> functionDecls;
+    const ArenaSpan<FieldDecl*> variableDecls;
 
     bool operator==(const KahwaFile &other) const {
         if (typedefDecls.size() != other.typedefDecls.size() ||
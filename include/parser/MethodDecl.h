@@ -14,22 +14,22 @@
 
 
 struct MethodDecl : Decl {
-    MethodDecl(std::string name,
-    const std::vector<Modifier> &modifiers,
+    MethodDecl(const Symbol name,
+    const ArenaSpan<Modifier> modifiers,
     TypeRef* returnType,
-    const std::vector<std::pair<TypeRef*, std::string>>& parameters,
+    const ArenaSpan<std::pair<TypeRef*, Symbol>> parameters,
     Block* block,
     const SourceRange &returnTypeSourceRange,
     const SourceRange &nameSourceRange,
     const SourceRange &bodyRange):
-    Decl(std::move(name), modifiers, nameSourceRange, bodyRange),
+    Decl(name, modifiers, nameSourceRange, bodyRange),
     returnType(returnType),
     parameters(parameters),
     block(block),
     returnTypeSourceRange(returnTypeSourceRange) {}
 
     TypeRef* const returnType;
-    const std::vector<std::pair<TypeRef*, std::string>> parameters;
+    const ArenaSpan<std::pair<TypeRef*, Symbol>> parameters;
     Block* const block;
 
     const SourceRange returnTypeSourceRange;
@@ -7,76 +7,112 @@
 #include "ClassDecl.h"
 #include "KahwaFile.h"
 #include "TypedefDecl.h"
+#include "TypeTable.h"
 #include "../tokeniser/Token.h"
+#include "../tokeniser/TokenStream.h"
 #include "../arena/Arena.h"
+#include "../arena/ArenaVector.h"
 #include "../diagnostics/DiagnosticEngine.h"
 
+// Types are interned per Parser, so the files one Parser parses share their TypeRefs. A Parser must not
+// outlive a reset of its arena.
 class Parser {
 public:
-    explicit Parser(Arena& astArena, DiagnosticEngine& diagnostic_engine): astArena(astArena), diagnostic_engine(diagnostic_engine) {}
+    explicit Parser(Arena& astArena, DiagnosticEngine& diagnostic_engine): astArena(astArena), types(astArena), diagnostic_engine(diagnostic_engine) {}
 
     [[nodiscard]] KahwaFile* parseFile(const std::vector<Token> &tokens) const;
 
+    [[nodiscard]] KahwaFile* parseFile(TokenStream &tokens) const;
+
     [[nodiscard]] TypedefDecl* parseTypedef(const std::vector<Token> &tokens) const;
 
+    [[nodiscard]] TypeTable::Stats typeStats() const { return types.stats(); }
+
+    // The top-level declarations of a file as they are parsed
+    struct Declarations {
+        explicit Declarations(Arena& arena): typedefDecls(arena), classDecls(arena), functionDecls(arena), variableDecls(arena) {}
+
+        ArenaVector<TypedefDecl*> typedefDecls;
+        ArenaVector<ClassDecl*> classDecls;
+        ArenaVector<MethodDecl*> functionDecls;
+        ArenaVector<FieldDecl*> variableDecls;
+    };
+
+    // The state of a parse between two top-level declarations, and what it had produced by then
+    struct Boundary {
+        std::size_t token; // index of the next token
+        std::size_t diagnostics;
+        std::size_t typedefs;
+        std::size_t classes;
+        std::size_t functions;
+        std::size_t variables;
+    };
+
+    // Parses top-level declarations from `tokens[start]` on, as a parse of the whole of `tokens` would if it
+    // reached `start` between two declarations, until one ends at or past `stop`. The boundary before each
+    // declaration and the one after the last are appended to `boundaries`, with diagnostics counted in this
+    // Parser's engine and declarations in `decls`.
+    void parseDeclarations(std::span<const Token> tokens, std::size_t start, std::size_t stop, Declarations& decls, std::vector<Boundary>& boundaries) const;
+
     class ParserWorker {
     public:
-        explicit ParserWorker(const std::vector<Token> &tokens, Arena& astArena, DiagnosticEngine& diagnostic_engine): tokens(tokens), astArena(astArena), diagnostic_engine(diagnostic_engine) {}
+        explicit ParserWorker(TokenStream &tokens, Arena& astArena, TypeTable& types, DiagnosticEngine& diagnostic_engine): tokens(tokens), astArena(astArena), types(types), diagnostic_engine(diagnostic_engine) {}
 
-        std::vector<Modifier> getModifierList();
+        ArenaSpan<Modifier> getModifierList();
 
         KahwaFile* parseFile();
 
-        TypedefDecl* parseTypedef();
+        // Parses the next top-level declaration, or skips past what cannot be one, into `decls`. The
+        // stream must not be at its end. Between calls the only state is the stream and the previous token.
+        void parseDeclaration(Declarations& decls);
 
-        ClassDecl* parseClass();
+        // Continues a parse that stopped after `token`, as if it had just been consumed
+        void resumeAfter(const Token& token) { previous = token; }
+
+        TypedefDecl* parseTypedef();
 
         MethodDecl* parseMethod();
 
         Block* parseBlock();
 
     private:
-        const std::vector<Token> tokens;
-        std::size_t idx = 0;
+        TokenStream& tokens;
+        std::optional<Token> previous;
 
         Arena& astArena;
+        TypeTable& types;
         DiagnosticEngine& diagnostic_engine;
 
-        [[nodiscard]] bool next_is(TokenType expected) const;
-
-        [[nodiscard]] bool next_is(const std::vector<TokenType>& expected) const;
-
-        std::vector<Token> next(const std::function<bool(const Token&)> &until) const;
-
-        std::vector<Token> next(std::size_t count, const std::function<bool(const Token&)> &until = [](const Token& token){ return false; }) const;
+        // `firstToken` is the first token of the declaration, `typedefToken` the already consumed "typedef"
+        TypedefDecl* parseTypedef(ArenaSpan<Modifier> modifiers, const Token& firstToken, const Token& typedefToken);
 
-        [[nodiscard]] Token next() const;
+        // `classToken` is the already consumed "class"
+        ClassDecl* parseClass(ArenaSpan<Modifier> modifiers, const Token& classToken);
 
-        void syncTo(const std::function<bool(const Token&)> &isSafePoint);
+        [[nodiscard]] bool next_is(TokenType expected);
 
-        std::optional<Token> expect(TokenType tokenType, DiagnosticKind kind, const std::function<bool(const Token&)> &isSafePoint);
+        [[nodiscard]] bool next_is(std::initializer_list<TokenType> expected);
 
-        std::optional<Token> expect(TokenType tokenType, const std::function<bool(const Token&)> &isSafePoint);
+        Token advance();
 
-        std::optional<std::vector<Token>> expect(const std::vector<TokenType>& tokenTypes, const std::vector<DiagnosticKind>& kinds, const std::vector<std::function<bool(const Token&)>>& isSafePoints);
+        void syncTo(TokenMask safePoints);
 
-        std::optional<std::vector<Token>> expect(const std::vector<TokenType>& tokenTypes, const std::vector<std::function<bool(const Token&)>>& isSafePoints);
+        std::optional<Token> expect(TokenType tokenType, DiagnosticKind kind, TokenMask safePoints);
 
-        [[nodiscard]] SourceRange getPrevTokSourceRange() const;
+        std::optional<Token> expect(TokenType tokenType, TokenMask safePoints);
 
-        const std::function<bool(const Token&)> isSafePointForFile = [](const Token& token) {
-            return token.type == TokenType::IDENTIFIER || token.type == TokenType::TYPEDEF || MODIFIER_TYPES.contains(token.type);
-        };
+        [[nodiscard]] SourceRange getPrevTokSourceRange();
 
-        const std::function<bool(const Token&)> isSafePointForClass = [](const Token& token) {
-            return token.type == TokenType::IDENTIFIER || MODIFIER_TYPES.contains(token.type);
-        };
+        // Where recovery from an error stops skipping tokens, at file and at class member level
+        static constexpr TokenMask SAFE_POINTS_FOR_FILE = MODIFIER_TYPES | TokenMask{TokenType::IDENTIFIER, TokenType::TYPEDEF};
+        static constexpr TokenMask SAFE_POINTS_FOR_CLASS = MODIFIER_TYPES | TokenMask{TokenType::IDENTIFIER};
 
-        void assertTokenSequence(std::size_t count, const std::vector<TokenType> &expectedTypes) const;
+        void assertTokenSequence(std::initializer_list<TokenType> expectedTypes);
     };
 
 private:
     Arena& astArena;
+    mutable TypeTable types;
     DiagnosticEngine& diagnostic_engine;
 };
 
@@ -4,16 +4,20 @@
 
 #ifndef TYPEREF_H
 #define TYPEREF_H
-#include <vector>
+
+#include "../symbols/Symbol.h"
+#include "../arena/ArenaSpan.h"
 
 
 struct TypeRef {
-    explicit TypeRef(std::string identifier, const std::vector<TypeRef*> &args = {}): identifier(std::move(identifier)), args(args) {}
+    explicit TypeRef(const Symbol identifier, const ArenaSpan<TypeRef*> args = {}): identifier(identifier), args(args) {}
 
-    const std::string identifier;
-    const std::vector<TypeRef*> args;
+    const Symbol identifier;
+    const ArenaSpan<TypeRef*> args;
 
     bool operator==(const TypeRef &other) const {
+        // Types from one TypeTable are equal iff they are the same node, so this settles those at once
+        if (this == &other) return true;
         if (identifier != other.identifier || args.size() != other.args.size()) {
             return false;
         }
@@ -0,0 +1,65 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef TYPETABLE_H
+#define TYPETABLE_H
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+
+#include "TypeRef.h"
+#include "../arena/Arena.h"
+
+
+// Hash-conses TypeRefs: every mention of the same type, the same identifier with the same arguments, gets
+// the same node. Arguments must come from the same table, so two of its types are equal iff they are the
+// same pointer.
+//
+// Open addressing on a structural hash of the identifier and the argument pointers. The slots live in the
+// arena like the nodes do, so interning never goes through malloc, and the table must not outlive a reset
+// of the arena.
+class TypeTable {
+public:
+    struct Stats {
+        std::size_t total;  // calls to intern()
+        std::size_t unique; // nodes created
+    };
+
+    explicit TypeTable(Arena& arena): arena(arena) {}
+
+    TypeTable(const TypeTable&) = delete;
+    TypeTable& operator=(const TypeTable&) = delete;
+    TypeTable(TypeTable&&) = default;
+
+    TypeRef* intern(Symbol identifier, std::span<TypeRef* const> args = {});
+
+    TypeRef* intern(const Symbol identifier, const std::initializer_list<TypeRef*> args) {
+        return intern(identifier, std::span{args.begin(), args.size()});
+    }
+
+    [[nodiscard]] Stats stats() const { return {total, unique}; }
+
+private:
+    struct Slot {
+        std::uint64_t hash;
+        TypeRef* type; // nullptr if unused
+    };
+
+    Arena& arena;
+    Slot* slots = nullptr;
+    std::size_t capacity = 0; // a power of two
+    std::size_t total = 0;
+    std::size_t unique = 0;
+
+    void grow();
+
+    static std::uint64_t hashOf(Symbol identifier, std::span<TypeRef* const> args);
+
+    static constexpr std::size_t INITIAL_CAPACITY = 64;
+};
+
+
+
+#endif //TYPETABLE_H
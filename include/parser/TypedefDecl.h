@@ -11,8 +11,8 @@
 
 struct TypedefDecl : Decl {
     TypedefDecl(
-        const std::string &name,
-        const std::vector<Modifier>& modifiers,
+        const Symbol name,
+        const ArenaSpan<Modifier> modifiers,
         TypeRef* referredType,
         const SourceRange &typedefSourceRange,
         const SourceRange &nameSourceRange,
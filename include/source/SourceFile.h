@@ -5,11 +5,12 @@
 #ifndef SOURCEFILE_H
 #define SOURCEFILE_H
 #include <filesystem>
+#include <string_view>
 
 
 struct SourceFile {
     const std::filesystem::path path;
-    const std::string contents;
+    const std::string_view contents; // owned by the SourceManager, never moves
 };
 
 
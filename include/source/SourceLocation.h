@@ -5,15 +5,26 @@
 #ifndef SOURCELOCATION_H
 #define SOURCELOCATION_H
 
+#include <cassert>
+#include <compare>
 #include <cstddef>
+#include <cstdint>
 
 struct SourceRange;
 
+// A byte offset in the global location space. The SourceManager lays every file out in its own contiguous
+// slice of that space, so a single 32-bit offset identifies both the file and the position within it.
 struct SourceLocation {
-    const std::size_t file_id;
-    const std::size_t pos;
+    const std::uint32_t offset;
+
+    constexpr explicit SourceLocation(const std::size_t offset): offset(static_cast<std::uint32_t>(offset)) {
+        assert(offset <= UINT32_MAX);
+    }
 
     static SourceLocation getEndOf(SourceRange source_range);
+
+    bool operator==(const SourceLocation& other) const = default;
+    auto operator<=>(const SourceLocation& other) const = default;
 };
 
 
@@ -6,21 +6,110 @@
 #define SOURCEMANAGER_H
 
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <filesystem>
-#include <fstream>
+#include <unordered_map>
+#include <vector>
 
 #include "SourceFile.h"
+#include "SourceLocation.h"
+#include "../arena/Arena.h"
 
 
+// 1-based, columns count bytes
+struct LineColumn {
+    std::size_t line;
+    std::size_t column;
+
+    bool operator==(const LineColumn&) const = default;
+};
+
+// Owns the contents of every source file. Large regular files are memory-mapped read-only. Small ones,
+// where a mapping would waste most of a page, and pipes, FIFOs and stdin (the path "-") are read into
+// buffers in an arena. Either way a file's contents never move once added, so the string_views handed
+// out stay valid for the lifetime of the SourceManager.
+//
+// Files are also laid out back to back in a 32-bit location space, in the order they were added. A file
+// of n bytes gets n + 1 offsets so that its end is a location too, and the file a location belongs to is
+// found by binary search over the start offsets.
 class SourceManager {
 public:
+    SourceManager() = default;
+
+    ~SourceManager();
+
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+
+    // Adding the same file twice, under any path that resolves to it, returns the same id.
+    // Throws std::filesystem::filesystem_error if the file cannot be opened or read, and std::length_error
+    // if it does not fit in what is left of the location space.
     std::size_t addFile(const std::filesystem::path& path);
 
-    [[nodiscard]] const std::string& getSource(std::size_t file_id) const;
+    [[nodiscard]] std::string_view getSource(std::size_t file_id) const;
+
+    [[nodiscard]] const std::filesystem::path& getPath(std::size_t file_id) const;
+
+    [[nodiscard]] std::size_t fileCount() const { return source_files.size(); }
+
+    // Location of the first byte of a file
+    [[nodiscard]] SourceLocation getFileStart(std::size_t file_id) const;
+
+    // Location of byte `pos` of a file, which may be its end
+    [[nodiscard]] SourceLocation getLocation(std::size_t file_id, std::size_t pos) const;
+
+    [[nodiscard]] std::size_t getFileId(SourceLocation location) const;
+
+    // Byte offset of a location within its file
+    [[nodiscard]] std::size_t getFileOffset(SourceLocation location) const;
+
+    // Where the next file added will start. Offsets from here on belong to no file yet.
+    [[nodiscard]] std::size_t endOffset() const { return end_offset; }
+
+    // The offset that the file after one of `size` bytes starting at `start` starts at
+    static constexpr std::size_t nextFileStart(const std::size_t start, const std::size_t size) { return start + size + 1; }
+
+    // Line and column of a location, by binary search over its file's line starts. The end of a file is on
+    // its last line.
+    [[nodiscard]] LineColumn getLineColumn(SourceLocation location) const;
+
+    // Text of a 1-based line, without its line terminator
+    [[nodiscard]] std::string_view getLineText(std::size_t file_id, std::size_t line) const;
+
+    [[nodiscard]] std::size_t lineCount(std::size_t file_id) const;
 
 private:
+    struct Mapping {
+        void* data;
+        std::size_t size;
+    };
+
+    // Offsets of the first byte of every line, built on first use. Safe to build from several threads.
+    struct LineTable {
+        std::once_flag built;
+        std::vector<std::uint32_t> starts;
+    };
+
     std::vector<SourceFile> source_files;
+    std::vector<std::uint32_t> file_starts;
+    std::size_t end_offset = 0;
+    std::vector<std::unique_ptr<LineTable>> line_tables;
+    std::unordered_map<std::string, std::size_t> ids_by_path; // keyed by canonical path
+    std::vector<Mapping> mappings;
+    Arena buffers;
+
+    std::size_t addContents(const std::filesystem::path& path, std::string_view contents);
+
+    const std::vector<std::uint32_t>& lineStarts(std::size_t file_id) const;
+
+    // Reads `fd` to the end into an arena buffer, `size_hint` is the expected size if known
+    std::string_view readAll(int fd, const std::filesystem::path& path, std::size_t size_hint);
+
+    static constexpr std::size_t MMAP_THRESHOLD = 16 * 1024;
 };
 
 
@@ -5,23 +5,30 @@
 #ifndef SOURCERANGE_H
 #define SOURCERANGE_H
 #include <cstddef>
+#include <cstdint>
+
+#include "SourceLocation.h"
 
 class Token;
-struct SourceLocation;
 
+// Half-open range [begin, end) of global offsets, always within a single file
 struct SourceRange {
-    const std::size_t file_id;
-    const std::size_t pos;
-    const std::size_t length;
-
-    SourceRange(std::size_t file_id, std::size_t pos, std::size_t length = 1);
+    const SourceLocation begin;
+    const SourceLocation end;
 
-    explicit SourceRange(SourceLocation source_location);
+    explicit SourceRange(SourceLocation begin, std::size_t length = 1);
 
-    SourceRange(SourceLocation start_source_location, SourceLocation end_source_location);
+    SourceRange(SourceLocation begin, SourceLocation end);
 
     SourceRange(const Token& first, const Token& last);
 
+    SourceRange(const SourceRange& first, const SourceRange& last);
+
+    [[nodiscard]] std::uint32_t length() const { return end.offset - begin.offset; }
+
+    // The same range `delta` bytes later, or earlier if it is negative
+    [[nodiscard]] SourceRange shiftedBy(std::ptrdiff_t delta) const;
+
     bool operator==(const SourceRange &other) const;
 };
 
@@ -0,0 +1,25 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef TEXTEDIT_H
+#define TEXTEDIT_H
+#include <cstddef>
+#include <string_view>
+
+
+// A change to the text of a file, in offsets relative to the start of the file before the change
+struct TextEdit {
+    std::size_t offset;
+    std::size_t removed;
+    std::string_view inserted;
+
+    // How far the text after the change moved
+    [[nodiscard]] std::ptrdiff_t delta() const {
+        return static_cast<std::ptrdiff_t>(inserted.size()) - static_cast<std::ptrdiff_t>(removed);
+    }
+};
+
+
+
+#endif //TEXTEDIT_H
@@ -0,0 +1,38 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef SYMBOL_H
+#define SYMBOL_H
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+
+// Handle to a string interned in the global SymbolTable. Two symbols are equal iff their strings are.
+struct Symbol {
+    std::uint32_t id;
+
+    static Symbol intern(std::string_view str);
+
+    [[nodiscard]] const std::string& str() const;
+
+    bool operator==(const Symbol &other) const = default;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Symbol symbol) {
+    return os << symbol.str();
+}
+
+template <>
+struct std::hash<Symbol> {
+    std::size_t operator()(const Symbol symbol) const noexcept {
+        return std::hash<std::uint32_t>{}(symbol.id);
+    }
+};
+
+
+
+#endif //SYMBOL_H
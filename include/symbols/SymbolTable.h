@@ -0,0 +1,85 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Symbol.h"
+#include "../tokeniser/TokenType.h"
+
+
+// Interns strings into 32-bit Symbols. Keywords are seeded first, so the tokeniser resolves a keyword
+// with the same single lookup it uses for identifiers.
+//
+// Thread-safe: lookups take a shared lock on the hash index, inserts an exclusive one. Interned strings
+// live in fixed-size chunks that never move, so get() does not lock at all.
+class SymbolTable {
+public:
+    SymbolTable();
+
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    static SymbolTable& global();
+
+    Symbol intern(std::string_view str);
+
+    [[nodiscard]] std::optional<Symbol> find(std::string_view str) const;
+
+    [[nodiscard]] const std::string& get(const Symbol symbol) const {
+        return chunks[symbol.id >> CHUNK_BITS].load(std::memory_order_acquire)[symbol.id & (CHUNK_SIZE - 1)];
+    }
+
+    [[nodiscard]] std::optional<TokenType> keyword(const Symbol symbol) const {
+        if (symbol.id < keywords.size()) return keywords[symbol.id];
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::size_t size() const { return count.load(std::memory_order_acquire); }
+
+    // Bytes held by the table: string storage plus the hash index
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+private:
+    struct Slot {
+        std::uint32_t hash;
+        std::uint32_t id; // EMPTY if unused
+    };
+
+    static constexpr std::uint32_t EMPTY = UINT32_MAX;
+    static constexpr std::size_t CHUNK_BITS = 12;
+    static constexpr std::size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    static constexpr std::size_t MAX_CHUNKS = 4096; // 16M symbols
+
+    mutable std::shared_mutex mutex;
+    std::vector<Slot> slots;
+    std::atomic<std::uint32_t> count = 0;
+    std::array<std::atomic<std::string*>, MAX_CHUNKS> chunks{};
+    std::vector<TokenType> keywords;
+
+    [[nodiscard]] std::optional<Symbol> findLocked(std::string_view str, std::uint32_t hash) const;
+
+    Symbol insertLocked(std::string_view str, std::uint32_t hash);
+
+    void grow();
+
+    static std::uint32_t hashOf(const std::string_view str) {
+        const auto h = std::hash<std::string_view>{}(str);
+        return static_cast<std::uint32_t>(h ^ (h >> 32));
+    }
+};
+
+
+
+#endif //SYMBOLTABLE_H
@@ -0,0 +1,149 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef LEXERTABLES_H
+#define LEXERTABLES_H
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "TokenType.h"
+
+
+// Recognisers for punctuation and keywords, built at compile time from TOKEN_SPELLINGS. Adding a spelling
+// there is all it takes to have the tokeniser recognise it.
+
+struct OperatorMatch {
+    TokenType type;
+    std::size_t length; // 0 if no operator starts here
+};
+
+// Maximal-munch DFA over the operator spellings. States are the nodes of the trie of spellings, bytes are
+// first mapped to one of a handful of classes so the transition table stays a few hundred bytes.
+struct OperatorDfa {
+    static constexpr std::size_t MAX_STATES = 64;
+    static constexpr std::size_t MAX_CLASSES = 32;
+    static constexpr std::uint8_t DEAD = 0; // also the start state, no transition ever leads back to it
+
+    std::array<std::uint8_t, 256> byte_class{};
+    std::array<std::array<std::uint8_t, MAX_CLASSES>, MAX_STATES> next{};
+    std::array<TokenType, MAX_STATES> accepts{}; // BAD if the state is not accepting
+    std::size_t states = 1;
+    std::size_t classes = 1; // class 0 is every byte that appears in no operator
+};
+
+constexpr OperatorDfa buildOperatorDfa() {
+    OperatorDfa dfa;
+    dfa.accepts.fill(TokenType::BAD);
+
+    for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+        if (isKeywordSpelling(spelling)) continue;
+        for (const char c : spelling) {
+            auto& cls = dfa.byte_class[static_cast<unsigned char>(c)];
+            if (cls == 0) {
+                if (dfa.classes == OperatorDfa::MAX_CLASSES) throw "too many operator characters";
+                cls = static_cast<std::uint8_t>(dfa.classes++);
+            }
+        }
+
+        std::uint8_t state = 0;
+        for (const char c : spelling) {
+            auto& target = dfa.next[state][dfa.byte_class[static_cast<unsigned char>(c)]];
+            if (target == OperatorDfa::DEAD) {
+                if (dfa.states == OperatorDfa::MAX_STATES) throw "too many operator states";
+                target = static_cast<std::uint8_t>(dfa.states++);
+            }
+            state = target;
+        }
+        if (dfa.accepts[state] != TokenType::BAD) throw "duplicate operator spelling";
+        dfa.accepts[state] = type;
+    }
+    return dfa;
+}
+
+inline constexpr OperatorDfa OPERATOR_DFA = buildOperatorDfa();
+
+// Longest operator starting at `pos`
+constexpr OperatorMatch matchOperator(const std::string_view str, const std::size_t pos) {
+    OperatorMatch match{TokenType::BAD, 0};
+    std::uint8_t state = 0;
+    for (std::size_t i = pos; i < str.length(); i++) {
+        state = OPERATOR_DFA.next[state][OPERATOR_DFA.byte_class[static_cast<unsigned char>(str[i])]];
+        if (state == OperatorDfa::DEAD) break;
+        if (OPERATOR_DFA.accepts[state] != TokenType::BAD) {
+            match = {OPERATOR_DFA.accepts[state], i - pos + 1};
+        }
+    }
+    return match;
+}
+
+// Perfect hash over the keyword spellings: (first * a + second * b + length) mod SIZE, with a and b
+// searched for at compile time. A lookup is one hash and at most one comparison.
+struct KeywordTable {
+    static constexpr std::size_t SIZE = 32;
+
+    struct Entry {
+        std::string_view spelling;
+        TokenType type = TokenType::BAD;
+    };
+
+    std::size_t a = 0;
+    std::size_t b = 0;
+    std::size_t min_length = 0;
+    std::size_t max_length = 0;
+    std::array<Entry, SIZE> entries{};
+
+    [[nodiscard]] constexpr std::size_t hash(const std::string_view str) const {
+        return (static_cast<unsigned char>(str[0]) * a + static_cast<unsigned char>(str[1]) * b + str.length()) % SIZE;
+    }
+};
+
+constexpr KeywordTable buildKeywordTable() {
+    KeywordTable table;
+    table.min_length = static_cast<std::size_t>(-1);
+    for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+        if (!isKeywordSpelling(spelling)) continue;
+        table.min_length = std::min(table.min_length, spelling.length());
+        table.max_length = std::max(table.max_length, spelling.length());
+    }
+    if (table.min_length < 2) throw "keyword hash reads the first two characters";
+
+    for (table.a = 1; table.a < 64; table.a++) {
+        for (table.b = 0; table.b < 64; table.b++) {
+            table.entries = {};
+            bool collision = false;
+            for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+                if (!isKeywordSpelling(spelling)) continue;
+                auto& entry = table.entries[table.hash(spelling)];
+                if (entry.type != TokenType::BAD) {
+                    collision = true;
+                    break;
+                }
+                entry = {spelling, type};
+            }
+            if (!collision) return table;
+        }
+    }
+    throw "no perfect hash for the keywords, grow KeywordTable::SIZE";
+}
+
+inline constexpr KeywordTable KEYWORD_TABLE = buildKeywordTable();
+
+constexpr std::optional<TokenType> matchKeyword(const std::string_view str) {
+    if (str.length() < KEYWORD_TABLE.min_length || str.length() > KEYWORD_TABLE.max_length) return std::nullopt;
+    const auto& entry = KEYWORD_TABLE.entries[KEYWORD_TABLE.hash(str)];
+    if (entry.spelling != str) return std::nullopt;
+    return entry.type;
+}
+
+static_assert(matchOperator("<<=x", 0).type == TokenType::LEFT_SHIFT_EQUALS && matchOperator("<<=x", 0).length == 3);
+static_assert(matchOperator("a", 0).length == 0);
+static_assert(matchKeyword("protected") == TokenType::PROTECTED && !matchKeyword("protect"));
+
+
+
+#endif //LEXERTABLES_H
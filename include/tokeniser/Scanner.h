@@ -0,0 +1,78 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef SCANNER_H
+#define SCANNER_H
+#include <cstddef>
+#include <string_view>
+
+
+// Byte-run scanning primitives for the tokeniser. Each function returns the index of the first byte at or
+// after `pos` that ends the run, or `str.length()` if the run reaches the end of the input.
+//
+// On x86-64 the SSE2 or AVX2 implementation is picked at startup, classifying 16 or 32 bytes per step.
+// Everything else uses the scalar implementation.
+class Scanner {
+public:
+    enum class Level { SCALAR, SSE2, AVX2 };
+
+    struct Functions {
+        const char* (*skipWhitespace)(const char* p, const char* end);
+        const char* (*findNewline)(const char* p, const char* end);
+        const char* (*findCommentEnd)(const char* p, const char* end); // points at the '*' of "*/"
+        const char* (*findQuote)(const char* p, const char* end);
+        const char* (*skipIdentifierChars)(const char* p, const char* end);
+        const char* (*skipDigits)(const char* p, const char* end);
+    };
+
+    // Whitespace as the tokeniser delimits it: ' ', '\t', '\r', '\n', '\f'
+    static std::size_t skipWhitespace(const std::string_view str, const std::size_t pos) {
+        return run(active().skipWhitespace, str, pos);
+    }
+
+    static std::size_t findNewline(const std::string_view str, const std::size_t pos) {
+        return run(active().findNewline, str, pos);
+    }
+
+    // Index of the "*/" closing a block comment
+    static std::size_t findCommentEnd(const std::string_view str, const std::size_t pos) {
+        return run(active().findCommentEnd, str, pos);
+    }
+
+    static std::size_t findQuote(const std::string_view str, const std::size_t pos) {
+        return run(active().findQuote, str, pos);
+    }
+
+    // [A-Za-z0-9_]
+    static std::size_t skipIdentifierChars(const std::string_view str, const std::size_t pos) {
+        return run(active().skipIdentifierChars, str, pos);
+    }
+
+    static std::size_t skipDigits(const std::string_view str, const std::size_t pos) {
+        return run(active().skipDigits, str, pos);
+    }
+
+    // The best level supported by this CPU
+    static Level bestLevel();
+
+    static bool isSupported(Level level);
+
+    // Implementation for a specific level. The level must be supported.
+    static const Functions& functionsFor(Level level);
+
+    static const Functions& active() {
+        static const Functions& functions = functionsFor(bestLevel());
+        return functions;
+    }
+
+private:
+    static std::size_t run(const char* (*fn)(const char*, const char*), const std::string_view str, const std::size_t pos) {
+        if (pos >= str.length()) return str.length();
+        return fn(str.data() + pos, str.data() + str.length()) - str.data();
+    }
+};
+
+
+
+#endif //SCANNER_H
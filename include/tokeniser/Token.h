@@ -4,10 +4,12 @@
 
 #ifndef TOKEN_H
 #define TOKEN_H
+#include <cstdint>
 #include <string>
-#include <typeindex>
+#include <string_view>
 
 #include "TokenType.h"
+#include "../symbols/SymbolTable.h"
 #include "../source/SourceRange.h"
 #include <magic_enum.hpp>
 
@@ -16,55 +18,101 @@ class Token;
 
 std::string toString(const Token& token);
 
+// Trivially copyable, 12 byte token. Numeric payloads are stored inline, textual payloads
+// are interned in the global SymbolTable and stored as a Symbol. The type shares a word with the length.
 class Token {
 public:
-    Token(const TokenType type, const SourceRange &source_range): type(type), source_range(source_range), type_index(typeid(nullptr)) {
-        if (std::unordered_set{TokenType::IDENTIFIER, TokenType::STRING_LITERAL, TokenType::CHAR_LITERAL, TokenType::INTEGER, TokenType::FLOAT}.contains(type)) {
+    Token(const TokenType type, const SourceRange &source_range): type(type) {
+        if (hasData(type)) {
             throw std::invalid_argument("Token of type " + std::string(magic_enum::enum_name<TokenType>(type)) + " must have data associated with it.");
         }
+        setSourceRange(source_range);
+        payload.symbol = Symbol{0};
     }
 
-    Token(const TokenType type, std::string data, const SourceRange &source_range) : type(type), source_range(source_range), type_index(typeid(data)), data(std::make_shared<AuxData<std::string>>(std::move(data))) {
-        if (type != TokenType::IDENTIFIER && type != TokenType::STRING_LITERAL && type != TokenType::BAD) {
+    Token(const TokenType type, const std::string_view data, const SourceRange &source_range) : Token(type, Symbol::intern(data), source_range) {}
+
+    Token(const TokenType type, const Symbol data, const SourceRange &source_range) : type(type) {
+        if (!hasStringData(type)) {
             throw std::invalid_argument("Token of type " + std::string(magic_enum::enum_name<TokenType>(type)) + " cannot have string data.");
         }
+        setSourceRange(source_range);
+        payload.symbol = data;
     }
 
     template <typename T>
     requires (std::is_same_v<T, int> || std::is_same_v<T, float>)
-    Token(const TokenType type, T data, const SourceRange &source_range) : type(type), source_range(source_range), type_index(typeid(data)), data(std::make_shared<AuxData<T>>(data)) {
-        if (!(std::is_same_v<T, int> ? type == TokenType::INTEGER : type == TokenType::FLOAT) && type != TokenType::BAD) {
+    Token(const TokenType type, T data, const SourceRange &source_range) : type(type) {
+        if (!(std::is_same_v<T, int> ? type == TokenType::INTEGER : type == TokenType::FLOAT)) {
             throw std::invalid_argument("Token of type " + std::string(magic_enum::enum_name<TokenType>(type)) + " cannot store integers or floats.");
         }
+        setSourceRange(source_range);
+        if constexpr (std::is_same_v<T, int>) {
+            payload.int_value = data;
+        } else {
+            payload.float_value = data;
+        }
     }
 
-    const TokenType type;
+    TokenType type : 8;
 
     template <typename T>
     [[nodiscard]] const T* getIf() const {
-        if (type_index != typeid(T)) return nullptr;
-        auto derived = std::dynamic_pointer_cast<const AuxData<T>>(data);
-        return derived ? &derived->data : nullptr;
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (hasStringData(type)) return &payload.symbol.str();
+        } else if constexpr (std::is_same_v<T, Symbol>) {
+            if (hasStringData(type)) return &payload.symbol;
+        } else if constexpr (std::is_same_v<T, int>) {
+            if (type == TokenType::INTEGER) return &payload.int_value;
+        } else if constexpr (std::is_same_v<T, float>) {
+            if (type == TokenType::FLOAT) return &payload.float_value;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] SourceRange getSourceRange() const {
+        return SourceRange{SourceLocation{begin}, length};
+    }
+
+    // Moves the token `delta` bytes later, or earlier if it is negative
+    void shiftBy(const std::ptrdiff_t delta) {
+        begin = static_cast<std::uint32_t>(begin + delta);
     }
 
-    const SourceRange source_range;
+    // The tokeniser reports longer tokens and cuts them to this
+    static constexpr std::size_t MAX_LENGTH = (1u << 24) - 1;
 
 private:
-    struct AuxDataBase {
-        virtual ~AuxDataBase() = default;
-    };
+    std::uint32_t length : 24;
+    std::uint32_t begin;
 
-    template<typename T>
-    struct AuxData final : AuxDataBase {
-        explicit AuxData(T data) : data(std::move(data)) {}
+    union {
+        Symbol symbol;
+        int int_value;
+        float float_value;
+    } payload;
 
-        T data;
-    };
+    static bool hasStringData(const TokenType type) {
+        return type == TokenType::IDENTIFIER || type == TokenType::STRING_LITERAL || type == TokenType::BAD;
+    }
+
+    static bool hasData(const TokenType type) {
+        return type == TokenType::IDENTIFIER || type == TokenType::STRING_LITERAL || type == TokenType::CHAR_LITERAL
+            || type == TokenType::INTEGER || type == TokenType::FLOAT;
+    }
 
-    const std::type_index type_index;
-    const std::shared_ptr<const AuxDataBase> data;
+    void setSourceRange(const SourceRange &source_range) {
+        if (source_range.length() > MAX_LENGTH) {
+            throw std::out_of_range("Source range does not fit in a token.");
+        }
+        begin = source_range.begin.offset;
+        length = source_range.length();
+    }
 };
 
+static_assert(std::is_trivially_copyable_v<Token>);
+static_assert(sizeof(Token) == 12);
+
 
 
 #endif //TOKEN_H
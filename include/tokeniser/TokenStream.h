@@ -0,0 +1,90 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+#include <array>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include "Token.h"
+#include "Tokeniser.h"
+
+
+// Pull-based sequence of tokens with a fixed lookahead window.
+//
+// When constructed over source text, tokens are lexed only as they are peeked, into a ring buffer of
+// LOOKAHEAD tokens, so memory does not grow with the size of the file. When constructed over already
+// materialised tokens, it is a cursor into them.
+class TokenStream {
+public:
+    static constexpr std::size_t LOOKAHEAD = 16;
+
+    TokenStream(SourceLocation file_start, std::string_view str, DiagnosticEngine& diagnostic_engine):
+    lexer(std::in_place, file_start, str, diagnostic_engine) {}
+
+    explicit TokenStream(const std::span<const Token> tokens): tokens(tokens) {}
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    // The token `n` positions ahead of the cursor, or nullptr if the file ends before it. A stream that lexes
+    // as it goes throws std::out_of_range for `n` of LOOKAHEAD or more.
+    [[nodiscard]] const Token* peek(const std::size_t n = 0) {
+        if (!lexer) {
+            return consumed + n < tokens.size() ? &tokens[consumed + n] : nullptr;
+        }
+
+        if (n >= LOOKAHEAD) {
+            throw std::out_of_range("Peeked past the token stream's lookahead.");
+        }
+        while (buffered <= n) {
+            auto token = lexer->lexToken();
+            if (!token) return nullptr;
+            std::construct_at(&ring[(head + buffered++) & (LOOKAHEAD - 1)].token, *token);
+        }
+        return &ring[(head + n) & (LOOKAHEAD - 1)].token;
+    }
+
+    [[nodiscard]] bool atEnd() { return peek() == nullptr; }
+
+    // Consumes the next token. The stream must not be at its end.
+    Token advance() {
+        const Token* token = peek();
+        assert(token != nullptr);
+        const Token result = *token;
+        if (lexer) {
+            head = (head + 1) & (LOOKAHEAD - 1);
+            buffered--;
+        }
+        consumed++;
+        return result;
+    }
+
+    // Number of tokens consumed so far
+    [[nodiscard]] std::size_t position() const { return consumed; }
+
+private:
+    static_assert((LOOKAHEAD & (LOOKAHEAD - 1)) == 0, "LOOKAHEAD must be a power of two");
+
+    union Slot {
+        Slot() {}
+        Token token;
+    };
+
+    std::optional<Tokeniser::TokeniserWorker> lexer;
+    std::array<Slot, LOOKAHEAD> ring;
+    std::size_t head = 0;
+    std::size_t buffered = 0;
+
+    std::span<const Token> tokens;
+    std::size_t consumed = 0;
+};
+
+
+
+#endif //TOKENSTREAM_H
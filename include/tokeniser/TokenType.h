@@ -5,10 +5,13 @@
 #ifndef TOKENTYPE_H
 #define TOKENTYPE_H
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <magic_enum.hpp>
-#include <unordered_set>
+#include <string_view>
 
-enum class TokenType {
+enum class TokenType : std::uint8_t {
     COLON, // ":"
     SEMI_COLON, // ";"
     COMMA, // ","
@@ -86,32 +89,150 @@ enum class TokenType {
     BAD,
 };
 
-inline const auto KEYWORD_TYPES = std::unordered_set{
-    TokenType::CLASS, // "class"
-    TokenType::STATIC, // "static"
-    TokenType::PUBLIC, // "public"
-    TokenType::PRIVATE, // "private"
-    TokenType::PROTECTED, // "protected"
-    TokenType::OPEN, // "open"
-    TokenType::FINAL, // "final"
-    TokenType::ABSTRACT, // "abstract"
-    TokenType::INTERFACE, // "interface"
-    TokenType::TYPEDEF, // "typedef"
-
-    TokenType::RETURN, // "return"
-    TokenType::IF, // "if"
-    TokenType::ELSE, // "else"
-    TokenType::FOR, // "for"
-    TokenType::WHILE, // "while"
-    TokenType::BREAK, // "break"
-    TokenType::CONTINUE, // "continue"
-
-    TokenType::TRUE, // "true"
-    TokenType::FALSE, // "false"
-    TokenType::NULL_LITERAL, // "null"
+struct TokenSpelling {
+    TokenType type;
+    std::string_view spelling;
+};
+
+// Source spelling of every punctuation and keyword token, in enum order. The lexer tables, the symbol
+// table's keyword seeding and tokenTypeToString are all generated from this list.
+inline constexpr TokenSpelling TOKEN_SPELLINGS[] = {
+    {TokenType::COLON, ":"},
+    {TokenType::SEMI_COLON, ";"},
+    {TokenType::COMMA, ","},
+    {TokenType::LEFT_CURLY_BRACE, "{"},
+    {TokenType::RIGHT_CURLY_BRACE, "}"},
+    {TokenType::LEFT_PAREN, "("},
+    {TokenType::RIGHT_PAREN, ")"},
+    {TokenType::LEFT_BRACKET, "["},
+    {TokenType::RIGHT_BRACKET, "]"},
+
+    {TokenType::EQUALS, "="},
+    {TokenType::DOUBLE_EQUALS, "=="},
+    {TokenType::LESS, "<"},
+    {TokenType::GREATER, ">"},
+    {TokenType::LESS_EQUALS, "<="},
+    {TokenType::GREATER_EQUALS, ">="},
+    {TokenType::NOT, "!"},
+    {TokenType::NOT_EQUALS, "!="},
+    {TokenType::PLUS, "+"},
+    {TokenType::MINUS, "-"},
+    {TokenType::STAR, "*"},
+    {TokenType::SLASH, "/"},
+    {TokenType::MODULO, "%"},
+    {TokenType::PLUS_EQUALS, "+="},
+    {TokenType::MINUS_EQUALS, "-="},
+    {TokenType::STAR_EQUALS, "*="},
+    {TokenType::SLASH_EQUALS, "/="},
+    {TokenType::MODULO_EQUALS, "%="},
+    {TokenType::LEFT_SHIFT_EQUALS, "<<="},
+    {TokenType::RIGHT_SHIFT_EQUALS, ">>="},
+    {TokenType::BITWISE_AND_EQUALS, "&="},
+    {TokenType::BITWISE_OR_EQUALS, "|="},
+    {TokenType::BITWISE_XOR_EQUALS, "^="},
+    {TokenType::INCREMENT, "++"},
+    {TokenType::DECREMENT, "--"},
+    {TokenType::LOGICAL_AND, "&&"},
+    {TokenType::LOGICAL_OR, "||"},
+    {TokenType::BITWISE_AND, "&"},
+    {TokenType::BITWISE_OR, "|"},
+    {TokenType::BITWISE_XOR, "^"},
+    {TokenType::LEFT_SHIFT, "<<"},
+    {TokenType::RIGHT_SHIFT, ">>"},
+    {TokenType::QUESTION, "?"},
+    {TokenType::DOT, "."},
+
+    {TokenType::CLASS, "class"},
+    {TokenType::STATIC, "static"},
+    {TokenType::PUBLIC, "public"},
+    {TokenType::PRIVATE, "private"},
+    {TokenType::PROTECTED, "protected"},
+    {TokenType::OPEN, "open"},
+    {TokenType::FINAL, "final"},
+    {TokenType::ABSTRACT, "abstract"},
+    {TokenType::INTERFACE, "interface"},
+    {TokenType::TYPEDEF, "typedef"},
+
+    {TokenType::RETURN, "return"},
+    {TokenType::IF, "if"},
+    {TokenType::ELSE, "else"},
+    {TokenType::FOR, "for"},
+    {TokenType::WHILE, "while"},
+    {TokenType::BREAK, "break"},
+    {TokenType::CONTINUE, "continue"},
+
+    {TokenType::TRUE, "true"},
+    {TokenType::FALSE, "false"},
+    {TokenType::NULL_LITERAL, "null"},
 };
 
-inline const auto MODIFIER_TYPES = std::unordered_set{
+constexpr bool isKeywordSpelling(const std::string_view spelling) {
+    const char c = spelling.front();
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+// Every token type before IDENTIFIER has exactly one spelling, listed at its own index
+static_assert([] {
+    if (std::size(TOKEN_SPELLINGS) != static_cast<std::size_t>(TokenType::IDENTIFIER)) return false;
+    for (std::size_t i = 0; i < std::size(TOKEN_SPELLINGS); i++) {
+        if (TOKEN_SPELLINGS[i].type != static_cast<TokenType>(i) || TOKEN_SPELLINGS[i].spelling.empty()) return false;
+    }
+    return true;
+}(), "TOKEN_SPELLINGS is out of sync with TokenType");
+
+constexpr std::string_view spellingOf(const TokenType type) {
+    const auto i = static_cast<std::size_t>(type);
+    return i < std::size(TOKEN_SPELLINGS) ? TOKEN_SPELLINGS[i].spelling : std::string_view{};
+}
+
+constexpr bool isKeyword(const TokenType type) {
+    const std::string_view spelling = spellingOf(type);
+    return !spelling.empty() && isKeywordSpelling(spelling);
+}
+
+// Every keyword token type in enum order, taken from TOKEN_SPELLINGS
+inline constexpr auto KEYWORD_TYPES = [] {
+    constexpr std::size_t count = [] {
+        std::size_t n = 0;
+        for (const auto& [type, spelling] : TOKEN_SPELLINGS) n += isKeywordSpelling(spelling);
+        return n;
+    }();
+    std::array<TokenType, count> types{};
+    std::size_t i = 0;
+    for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+        if (isKeywordSpelling(spelling)) types[i++] = type;
+    }
+    return types;
+}();
+
+// A set of token types as a bit mask, so testing membership is a shift and an and
+class TokenMask {
+public:
+    constexpr TokenMask(const std::initializer_list<TokenType> types) {
+        for (const TokenType type : types) {
+            const auto i = static_cast<std::size_t>(type);
+            words[i / 64] |= std::uint64_t{1} << i % 64;
+        }
+    }
+
+    [[nodiscard]] constexpr bool contains(const TokenType type) const {
+        const auto i = static_cast<std::size_t>(type);
+        return words[i / 64] >> i % 64 & 1;
+    }
+
+    [[nodiscard]] constexpr TokenMask operator|(const TokenMask& other) const {
+        TokenMask mask{};
+        for (std::size_t i = 0; i < words.size(); i++) mask.words[i] = words[i] | other.words[i];
+        return mask;
+    }
+
+private:
+    std::array<std::uint64_t, 2> words{};
+};
+
+static_assert(static_cast<std::size_t>(TokenType::BAD) < 128, "TokenMask is too small for TokenType");
+
+inline constexpr TokenMask MODIFIER_TYPES{
     TokenType::STATIC, // "static"
     TokenType::PUBLIC, // "public"
     TokenType::PRIVATE, // "private"
@@ -122,12 +243,8 @@ inline const auto MODIFIER_TYPES = std::unordered_set{
 };
 
 inline std::string keywordToString(TokenType tokenType) {
-    if (!KEYWORD_TYPES.contains(tokenType)) return "Not a keyword";
-    if (tokenType == TokenType::NULL_LITERAL) return "null";
-    std::string s = std::string{magic_enum::enum_name(tokenType)};
-    std::ranges::transform(s, s.begin(),
-                           [](unsigned char c){ return std::tolower(c); });
-    return s;
+    if (!isKeyword(tokenType)) return "Not a keyword";
+    return std::string{spellingOf(tokenType)};
 }
 
 
@@ -7,51 +7,70 @@
 
 #include <ostream>
 #include <string>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "Token.h"
 #include "../diagnostics/DiagnosticEngine.h"
 #include "../source/SourceManager.h"
+#include "../source/TextEdit.h"
+
+class TokenStream;
 
 class Tokeniser {
 public:
     explicit Tokeniser(DiagnosticEngine& diagnostic_engine): diagnostic_engine(diagnostic_engine) {}
 
-    [[nodiscard]] std::vector<Token> tokenise(const std::size_t file_id, const std::string_view str) const {
-        return TokeniserWorker(file_id, str, diagnostic_engine).tokenise();
-    }
+    // Materialises the whole stream. `file_start` is the location of the first byte of `str`.
+    [[nodiscard]] std::vector<Token> tokenise(SourceLocation file_start, std::string_view str) const;
+
+    // Lexes tokens on demand as they are pulled from the stream. `str` must outlive the stream.
+    [[nodiscard]] TokenStream stream(SourceLocation file_start, std::string_view str) const;
+
+    // The old tokens [first, last) that relex() replaced, and how many new ones took their place
+    struct Relexed {
+        std::size_t first;
+        std::size_t last;
+        std::size_t count;
+    };
+
+    // Brings `tokens` and `diagnostics`, what tokenising the text before `edit` gave, up to date with `str`, the
+    // text after it. Lexing restarts a little before the edit and stops once it lines up with the old tokens
+    // again; the ones after that are shifted. New problems go into `diagnostics`, not this Tokeniser's engine.
+    static Relexed relex(SourceLocation file_start, std::string_view str, const TextEdit& edit, std::vector<Token>& tokens, std::vector<Diagnostic>& diagnostics);
+
+    // How far past its end lexing a token may look: "1." is an integer only if no digit follows the '.'
+    static constexpr std::size_t LOOKAHEAD = 2;
 
     class TokeniserWorker {
     public:
-        TokeniserWorker(const std::size_t file_id, const std::string_view str, DiagnosticEngine& diagnostic_engine): file_id(file_id), str(str), diagnostic_engine(diagnostic_engine) {}
+        TokeniserWorker(const SourceLocation file_start, const std::string_view str, DiagnosticEngine& diagnostic_engine): file_start(file_start), str(str), diagnostic_engine(diagnostic_engine) {}
 
-        std::vector<Token> tokenise();
+        // The next token in the file, or nullopt once it is exhausted
+        std::optional<Token> lexToken();
     private:
         std::size_t idx = 0;
 
-        std::vector<Token> tokens;
-
-        const std::size_t file_id;
+        const SourceLocation file_start;
         const std::string_view str;
         DiagnosticEngine& diagnostic_engine;
+        SymbolTable& symbols = SymbolTable::global();
 
         std::optional<Token> tokeniseString(std::size_t curr_idx);
 
-        std::string getNumberString(std::size_t curr_idx);
-
-        std::string extractIdentifierLike();
-
-        bool next_is(const std::string& expected, const std::function<bool(char)>& until = [](char c){ return false; }) const;
+        std::string_view getNumberString();
 
-        std::string next(const std::function<bool(char)>& until) const;
+        std::string_view extractIdentifierLike();
 
-        std::string next(std::size_t count = 1, const std::function<bool(char)>& until = [](char c){ return false; }) const;
+        bool next_is(char expected) const;
 
-        static const std::unordered_set<char> DELIMITERS;
+        [[nodiscard]] SourceRange rangeAt(std::size_t pos, std::size_t length = 1) const {
+            return SourceRange{SourceLocation{file_start.offset + pos}, length};
+        }
 
-        static const std::unordered_map<std::string, TokenType> TOKEN_MAP;
+        // The range of a token, cut to the most a Token can hold. A longer one is reported, and its token
+        // covers only its start.
+        SourceRange tokenRangeAt(std::size_t pos, std::size_t length);
     };
 
 private:
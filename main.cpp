@@ -1,6 +1,89 @@
+#include <charconv>
 #include <iostream>
+#include <memory>
+#include <string_view>
 
-int main() {
-    std::cout << "Hello, World!" << std::endl;
-    return 0;
-}
\ No newline at end of file
+#include "include/diagnostics/JsonLinesWriter.h"
+#include "include/diagnostics/SarifWriter.h"
+#include "include/driver/Driver.h"
+
+namespace {
+
+int usage() {
+    std::cerr << "usage: kahwa_lang [-j threads] [--error-limit n] [--format text|jsonl|sarif] file.kahwa..." << std::endl;
+    return 2;
+}
+
+}
+
+int main(const int argc, char* argv[]) {
+    std::size_t threads = std::thread::hardware_concurrency();
+    // Bounded output for broken or generated files: runs of one problem are reported once, and so are the
+    // errors that follow one while the parser resynchronises. 0 means no limit.
+    std::size_t error_limit = 100;
+    // text goes to stderr once everything is parsed, jsonl and sarif are streamed to stdout while parsing
+    std::string_view format = "text";
+    SourceManager source_manager;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "-j") {
+            if (++i == argc) return usage();
+            const std::string_view value = argv[i];
+            if (std::from_chars(value.data(), value.data() + value.size(), threads).ec != std::errc{} || threads == 0) {
+                return usage();
+            }
+        } else if (arg == "--error-limit") {
+            if (++i == argc) return usage();
+            const std::string_view value = argv[i];
+            if (std::from_chars(value.data(), value.data() + value.size(), error_limit).ec != std::errc{}) {
+                return usage();
+            }
+        } else if (arg == "--format") {
+            if (++i == argc) return usage();
+            format = argv[i];
+            if (format != "text" && format != "jsonl" && format != "sarif") return usage();
+        } else {
+            try {
+                source_manager.addFile(arg);
+            } catch (const std::filesystem::filesystem_error& e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (source_manager.fileCount() == 0) return usage();
+
+    std::unique_ptr<DiagnosticWriter> writer;
+    if (format == "jsonl") writer = std::make_unique<JsonLinesWriter>(std::cout, source_manager);
+    if (format == "sarif") writer = std::make_unique<SarifWriter>(std::cout, source_manager);
+
+    Driver driver{threads, {
+        .error_limit = error_limit == 0 ? DiagnosticOptions::NO_LIMIT : error_limit,
+        .coalesce_gap = 1,
+        .suppress_cascades = true,
+        .sink = writer.get(),
+    }};
+    const Project project = driver.parse(source_manager);
+    if (writer) {
+        const bool has_errors = writer->errors() > 0;
+        writer.reset();
+        return has_errors ? 1 : 0;
+    }
+
+    bool has_errors = false;
+    for (const auto& diagnostic : project.diagnostics) {
+        has_errors |= diagnostic.severity == DiagnosticSeverity::ERROR;
+        const SourceLocation location = diagnostic.source_range.begin;
+        const auto [line, column] = source_manager.getLineColumn(location);
+        std::cerr << source_manager.getPath(source_manager.getFileId(location)).string() << ":" << line << ":" << column << ": "
+                  << magic_enum::enum_name(diagnostic.severity) << ": " << diagnostic.msg() << std::endl;
+    }
+    const auto [coalesced, cascades, over_limit] = project.dropped_diagnostics;
+    if (over_limit > 0) std::cerr << "too many errors emitted, stopping now" << std::endl;
+    if (coalesced + cascades + over_limit > 0) {
+        std::cerr << "not shown: " << coalesced << " merged into the one before, " << cascades << " caused by an earlier error, "
+                  << over_limit << " past the error limit" << std::endl;
+    }
+    return has_errors ? 1 : 0;
+}
@@ -4,51 +4,89 @@
 
 #include "../../include/arena/Arena.h"
 
-void *Arena::allocate(const size_t size, const size_t alignment) {
-    auto cur = reinterpret_cast<std::uintptr_t>(current);
-    uintptr_t aligned = align_up(cur, alignment);
-    size_t padding = aligned - cur;
-
-    if (padding + size <= remaining) {
-        auto ptr = reinterpret_cast<char*>(aligned);
-        current = ptr + size;
-        remaining -= padding + size;
-        return ptr;
-    }
+#include <cstdlib>
+#include <new>
+
+#include <sys/mman.h>
 
-    addBlock(std::max(block_size, size + alignment));
+Arena::Arena(const Options options) : options(options) {
+    addBlock(options.block_size);
+}
 
-    cur = reinterpret_cast<uintptr_t>(current);
-    aligned = align_up(cur, alignment);
-    padding = aligned - cur;
+Arena::~Arena() {
+    runFinalizers();
+    for (auto& [data, size] : blocks) {
+        std::free(data);
+    }
+}
 
-    const auto ptr = reinterpret_cast<char*>(aligned);
-    current = ptr + size;
-    remaining -= padding + size;
+void *Arena::allocateSlow(const size_t size, const size_t alignment) {
+    // The first later block with room for the allocation, whatever its alignment, or a new one. Blocks
+    // that are skipped over stay empty until the next reset.
+    std::size_t next = current_block + 1;
+    while (next < blocks.size() && blocks[next].size < size + alignment) next++;
+    if (next < blocks.size()) {
+        useBlock(next);
+    } else {
+        const std::size_t grown = std::min(blocks.back().size * 2, options.max_block_size);
+        addBlock(std::max({grown, options.block_size, size + alignment}));
+    }
+    return allocate(size, alignment);
+}
 
-    return ptr;
+void Arena::reset() noexcept {
+    runFinalizers();
+    high_water_mark = std::max(high_water_mark, bytes_used + bytes_padding);
+    bytes_used = 0;
+    bytes_padding = 0;
+    useBlock(0);
 }
 
 void Arena::clear() noexcept {
-    for (auto& [data, size] : blocks) {
-        std::free(data);
+    // Objects may live in any block, so they are destroyed before the blocks are freed
+    reset();
+    for (std::size_t i = 1; i < blocks.size(); i++) {
+        std::free(blocks[i].data);
     }
-    blocks.clear();
+    blocks.resize(1);
+}
 
-    current = nullptr;
-    remaining = 0;
+void Arena::runFinalizers() noexcept {
+    for (const Finalizer* finalizer = finalizers; finalizer != nullptr; finalizer = finalizer->next) {
+        finalizer->destroy(finalizer->object);
+    }
+    finalizers = nullptr;
+}
 
-    addBlock(block_size);
+Arena::Stats Arena::stats() const {
+    std::size_t bytes_reserved = 0;
+    for (const auto& block : blocks) bytes_reserved += block.size;
+    return {
+        .bytes_used = bytes_used,
+        .bytes_padding = bytes_padding,
+        .bytes_reserved = bytes_reserved,
+        .block_count = blocks.size(),
+        .high_water_mark = std::max(high_water_mark, bytes_used + bytes_padding),
+    };
 }
 
 void Arena::addBlock(size_t size) {
-    size = align_up(size, alignof(std::max_align_t));
-    const auto data = static_cast<char*>(std::malloc(size));
+    const bool huge = options.huge_pages && size >= HUGE_PAGE_SIZE;
+    const std::size_t alignment = huge ? HUGE_PAGE_SIZE : alignof(std::max_align_t);
+    size = align_up(size, alignment);
+    const auto data = static_cast<char*>(huge ? std::aligned_alloc(alignment, size) : std::malloc(size));
     if (!data) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    // Only a hint, the block is usable either way
+    if (huge) madvise(data, size, MADV_HUGEPAGE);
+#endif
 
     blocks.push_back({ data, size });
-
-    current = data;
-    remaining = size;
+    useBlock(blocks.size() - 1);
 }
 
+void Arena::useBlock(const std::size_t index) {
+    current_block = index;
+    current = blocks[index].data;
+    remaining = blocks[index].size;
+}
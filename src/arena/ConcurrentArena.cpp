@@ -0,0 +1,91 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/arena/ConcurrentArena.h"
+
+#include <cstdlib>
+#include <new>
+
+ConcurrentArena::ConcurrentArena(const std::size_t chunk_size)
+    : chunk_size(chunk_size), generation(next_generation.fetch_add(1, std::memory_order_relaxed)) {}
+
+ConcurrentArena::~ConcurrentArena() {
+    clear();
+}
+
+void* ConcurrentArena::allocateSlow(const std::size_t size, const std::size_t alignment) {
+    // Big allocations get a chunk of their own rather than wasting most of a shared one
+    if (size + alignment > chunk_size / 4) {
+        Chunk* chunk = newChunk(size + alignment);
+        push(oversized, chunk, &Chunk::next_all);
+        const auto data = reinterpret_cast<std::uintptr_t>(chunk->data());
+        return reinterpret_cast<void*>((data + alignment - 1) & ~(alignment - 1));
+    }
+
+    // Whatever was left of the old chunk is abandoned until the next reset
+    Chunk* chunk = takeChunk();
+    cache = {generation, chunk->data(), chunk->size};
+    return allocate(size, alignment);
+}
+
+ConcurrentArena::Chunk* ConcurrentArena::takeChunk() {
+    // Chunks only return to the free list in reset(), never while threads are popping, so there is no ABA
+    Chunk* chunk = free_chunks.load(std::memory_order_acquire);
+    while (chunk && !free_chunks.compare_exchange_weak(chunk, chunk->next_free, std::memory_order_acquire, std::memory_order_acquire)) {}
+    if (chunk) return chunk;
+
+    chunk = newChunk(chunk_size);
+    push(all_chunks, chunk, &Chunk::next_all);
+    chunk_count.fetch_add(1, std::memory_order_relaxed);
+    return chunk;
+}
+
+ConcurrentArena::Chunk* ConcurrentArena::newChunk(const std::size_t size) {
+    auto* chunk = static_cast<Chunk*>(std::malloc(HEADER_SIZE + size));
+    if (!chunk) throw std::bad_alloc();
+    *chunk = {nullptr, nullptr, size};
+    return chunk;
+}
+
+void ConcurrentArena::push(std::atomic<Chunk*>& list, Chunk* chunk, Chunk* Chunk::* next) {
+    chunk->*next = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(chunk->*next, chunk, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void ConcurrentArena::reset() noexcept {
+    runFinalizers();
+    // Every cache still pointing into a chunk goes stale at once
+    generation = next_generation.fetch_add(1, std::memory_order_relaxed);
+
+    for (Chunk* chunk = oversized.exchange(nullptr); chunk != nullptr;) {
+        Chunk* next = chunk->next_all;
+        std::free(chunk);
+        chunk = next;
+    }
+
+    Chunk* free_list = nullptr;
+    for (Chunk* chunk = all_chunks.load(); chunk != nullptr; chunk = chunk->next_all) {
+        chunk->next_free = free_list;
+        free_list = chunk;
+    }
+    free_chunks.store(free_list);
+}
+
+void ConcurrentArena::clear() noexcept {
+    // Objects may live in any chunk, so they are destroyed before the chunks are freed
+    reset();
+    free_chunks.store(nullptr);
+    for (Chunk* chunk = all_chunks.exchange(nullptr); chunk != nullptr;) {
+        Chunk* next = chunk->next_all;
+        std::free(chunk);
+        chunk = next;
+    }
+    chunk_count.store(0);
+}
+
+void ConcurrentArena::runFinalizers() noexcept {
+    for (const Finalizer* finalizer = finalizers.exchange(nullptr); finalizer != nullptr; finalizer = finalizer->next) {
+        finalizer->destroy(finalizer->object);
+    }
+}
@@ -0,0 +1,178 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/diagnostics/DiagnosticEngine.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+DiagnosticEngine::DiagnosticEngine(const DiagnosticOptions options)
+    : options(options), generation(next_generation.fetch_add(1, std::memory_order_relaxed)) {}
+
+DiagnosticEngine::~DiagnosticEngine() {
+    for (Shard* shard = shards.load(); shard != nullptr; shard = shard->next) {
+        if (options.sink) sendPending(shard);
+    }
+    for (Shard* shard = shards.load(); shard != nullptr;) {
+        const std::size_t size = shard->published.load();
+        std::size_t index = 0;
+        for (Chunk* chunk = shard->head; chunk != nullptr; index += Chunk::CAPACITY) {
+            for (std::size_t i = 0; i < Chunk::CAPACITY && index + i < size; i++) chunk->at(i)->~Entry();
+            Chunk* next = chunk->next;
+            delete chunk;
+            chunk = next;
+        }
+        Shard* next = shard->next;
+        delete shard;
+        shard = next;
+    }
+}
+
+void DiagnosticEngine::reportProblem(const DiagnosticSeverity severity, const DiagnosticKind kind, const SourceRange range, const DiagnosticArgs args) {
+    Shard* shard = currentShard();
+    const bool error = severity == DiagnosticSeverity::ERROR;
+    // Neither a cascade nor a coalesced diagnostic counts towards the limit, they are part of an earlier error
+    if (error && shard->recovering && isParserDiagnostic(kind)) {
+        shard->cascades.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (options.sink) {
+        stream(shard, severity, kind, range, args);
+        return;
+    }
+    if (coalesce(shard, severity, kind, range, args)) return;
+    if (error && error_count.fetch_add(1, std::memory_order_relaxed) >= options.error_limit) return;
+    if (error) shard->errors++;
+
+    const std::size_t size = shard->published.load(std::memory_order_relaxed);
+    const std::size_t index = size % Chunk::CAPACITY;
+    if (index == 0) {
+        auto* chunk = new Chunk;
+        (shard->tail ? shard->tail->next : shard->head) = chunk;
+        shard->tail = chunk;
+    }
+
+    new (shard->tail->at(index)) Entry{next_sequence.fetch_add(1, std::memory_order_relaxed), Diagnostic{severity, kind, range, args}, {range.end.offset}};
+    shard->published.store(size + 1, std::memory_order_release);
+    shard->revision.fetch_add(1, std::memory_order_release);
+}
+
+bool DiagnosticEngine::canCoalesce(const Diagnostic& last, const std::uint32_t end, const DiagnosticSeverity severity, const DiagnosticKind kind, const SourceRange range, const DiagnosticArgs args) const {
+    return options.coalesce_gap && last.severity == severity && last.kind == kind && last.args == args &&
+        range.begin.offset >= last.source_range.begin.offset && range.begin.offset <= end + *options.coalesce_gap;
+}
+
+bool DiagnosticEngine::coalesce(Shard* shard, const DiagnosticSeverity severity, const DiagnosticKind kind, const SourceRange range, const DiagnosticArgs args) const {
+    if (!options.coalesce_gap || shard->published.load(std::memory_order_relaxed) <= shard->run_start) return false;
+
+    Entry* last = shard->last();
+    const std::uint32_t end = last->end.load(std::memory_order_relaxed);
+    if (!canCoalesce(last->diagnostic, end, severity, kind, range, args)) return false;
+
+    if (range.end.offset > end) last->end.store(range.end.offset, std::memory_order_release);
+    shard->coalesced.fetch_add(1, std::memory_order_relaxed);
+    shard->revision.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+void DiagnosticEngine::stream(Shard* shard, const DiagnosticSeverity severity, const DiagnosticKind kind, const SourceRange range, const DiagnosticArgs args) {
+    // Only the thread's last diagnostic is held back, so memory stays bounded however many are reported
+    if (shard->pending && canCoalesce(*shard->pending, shard->pending_end, severity, kind, range, args)) {
+        shard->pending_end = std::max(shard->pending_end, range.end.offset);
+        shard->coalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (severity == DiagnosticSeverity::ERROR && error_count.fetch_add(1, std::memory_order_relaxed) >= options.error_limit) return;
+    if (severity == DiagnosticSeverity::ERROR) shard->errors++;
+
+    sendPending(shard);
+    if (options.coalesce_gap) {
+        shard->pending.emplace(severity, kind, range, args);
+        shard->pending_end = range.end.offset;
+    } else {
+        options.sink->consume(Diagnostic{severity, kind, range, args});
+    }
+}
+
+void DiagnosticEngine::sendPending(Shard* shard) const {
+    if (!shard->pending) return;
+    const Diagnostic& pending = *shard->pending;
+    options.sink->consume(Diagnostic{pending.severity, pending.kind, SourceRange{pending.source_range.begin, SourceLocation{shard->pending_end}}, pending.args});
+    shard->pending.reset();
+}
+
+void DiagnosticEngine::flush() {
+    if (!options.sink) return;
+    for (Shard* shard = shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) sendPending(shard);
+    options.sink->flush();
+}
+
+DiagnosticEngine::Shard *DiagnosticEngine::shardForThisThread() {
+    // The cache only holds one engine, a thread reporting to several finds its shard again here
+    const std::thread::id self = std::this_thread::get_id();
+    Shard* shard = shards.load(std::memory_order_acquire);
+    while (shard != nullptr && shard->owner != self) shard = shard->next;
+
+    if (shard == nullptr) {
+        shard = new Shard(self);
+        shard->next = shards.load(std::memory_order_relaxed);
+        while (!shards.compare_exchange_weak(shard->next, shard, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+    cache = {generation, shard};
+    return shard;
+}
+
+std::size_t DiagnosticEngine::count() const {
+    std::size_t total = 0;
+    for (const Shard* shard = shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        total += shard->published.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+DiagnosticEngine::Stats DiagnosticEngine::stats() const {
+    Stats stats{};
+    for (const Shard* shard = shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        stats.coalesced += shard->coalesced.load(std::memory_order_relaxed);
+        stats.cascades += shard->cascades.load(std::memory_order_relaxed);
+    }
+    const std::size_t errors = error_count.load(std::memory_order_relaxed);
+    stats.over_limit = errors > options.error_limit ? errors - options.error_limit : 0;
+    return stats;
+}
+
+const std::vector<Diagnostic> &DiagnosticEngine::getAll() const {
+    std::lock_guard lock{merge_mutex};
+    // Diagnostics are only ever added or extended, so the last merge holds until one is
+    const Shard* first = shards.load(std::memory_order_acquire);
+    std::size_t revision = 0;
+    for (const Shard* shard = first; shard != nullptr; shard = shard->next) revision += shard->revision.load(std::memory_order_acquire);
+    if (revision == merged_revision) return merged;
+
+    std::vector<const Entry*> entries;
+    for (const Shard* shard = first; shard != nullptr; shard = shard->next) {
+        const std::size_t size = shard->published.load(std::memory_order_acquire);
+        // The owner may be appending a chunk, so `next` is only followed to entries already published
+        const Chunk* chunk = shard->head;
+        for (std::size_t index = 0; index < size; index++) {
+            if (index > 0 && index % Chunk::CAPACITY == 0) chunk = chunk->next;
+            entries.push_back(chunk->at(index % Chunk::CAPACITY));
+        }
+    }
+    // A single shard is in order already
+    if (first->next != nullptr) std::ranges::sort(entries, {}, &Entry::sequence);
+
+    std::vector<Diagnostic> all;
+    all.reserve(entries.size());
+    for (const Entry* entry : entries) {
+        const Diagnostic& diagnostic = entry->diagnostic;
+        const SourceLocation end{entry->end.load(std::memory_order_acquire)};
+        all.push_back(end == diagnostic.source_range.end ? diagnostic :
+            Diagnostic{diagnostic.severity, diagnostic.kind, SourceRange{diagnostic.source_range.begin, end}, diagnostic.args});
+    }
+    merged = std::move(all);
+    merged_revision = revision;
+    return merged;
+}
@@ -0,0 +1,111 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/diagnostics/DiagnosticWriter.h"
+
+#include <charconv>
+
+DiagnosticWriter::DiagnosticWriter(std::ostream &out, const SourceManager &source_manager, const std::size_t buffer_size)
+    : source_manager(source_manager), out(out), buffer_size(buffer_size) {
+    buffer.reserve(buffer_size);
+}
+
+DiagnosticWriter::~DiagnosticWriter() {
+    std::lock_guard lock{mutex};
+    flushBuffer();
+}
+
+void DiagnosticWriter::consume(const Diagnostic &diagnostic) {
+    // Formatting is most of the work, and needs no lock
+    thread_local std::string text;
+    text.clear();
+    format(diagnostic, text);
+
+    std::lock_guard lock{mutex};
+    if (count++ > 0) append(separator);
+    append(text);
+    if (diagnostic.severity == DiagnosticSeverity::ERROR) error_count++;
+}
+
+void DiagnosticWriter::flush() {
+    std::lock_guard lock{mutex};
+    flushBuffer();
+    out.flush();
+}
+
+std::size_t DiagnosticWriter::written() const {
+    std::lock_guard lock{mutex};
+    return count;
+}
+
+std::size_t DiagnosticWriter::errors() const {
+    std::lock_guard lock{mutex};
+    return error_count;
+}
+
+DiagnosticWriter::Position DiagnosticWriter::resolve(const SourceRange &range) const {
+    return {
+        source_manager.getPath(source_manager.getFileId(range.begin)),
+        source_manager.getLineColumn(range.begin),
+        source_manager.getLineColumn(range.end),
+    };
+}
+
+void DiagnosticWriter::setSeparator(const std::string_view separator) {
+    std::lock_guard lock{mutex};
+    this->separator = separator;
+}
+
+void DiagnosticWriter::writeRaw(const std::string_view text) {
+    std::lock_guard lock{mutex};
+    append(text);
+}
+
+void DiagnosticWriter::append(const std::string_view text) {
+    if (buffer.size() + text.size() > buffer_size) flushBuffer();
+    // Text bigger than the whole buffer goes straight out
+    if (text.size() > buffer_size) {
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+    buffer += text;
+}
+
+void DiagnosticWriter::flushBuffer() {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void DiagnosticWriter::appendJsonString(std::string &text, const std::string_view str) {
+    text += '"';
+    // Runs of characters that need no escaping are copied in one go, which is nearly all of them
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < str.size(); i++) {
+        const char c = str[i];
+        if (c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20) continue;
+        text.append(str.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': text += "\\\""; break;
+            case '\\': text += "\\\\"; break;
+            case '\n': text += "\\n"; break;
+            case '\r': text += "\\r"; break;
+            case '\t': text += "\\t"; break;
+            default: {
+                constexpr char hex[] = "0123456789abcdef";
+                text += "\\u00";
+                text += hex[c >> 4];
+                text += hex[c & 0xf];
+            }
+        }
+    }
+    text.append(str.data() + run, str.size() - run);
+    text += '"';
+}
+
+void DiagnosticWriter::appendNumber(std::string &text, const std::size_t number) {
+    char digits[20];
+    const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), number);
+    text.append(digits, end);
+}
@@ -0,0 +1,39 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/diagnostics/JsonLinesWriter.h"
+
+namespace {
+
+std::string_view severityName(const DiagnosticSeverity severity) {
+    switch (severity) {
+        case DiagnosticSeverity::ERROR: return "error";
+        case DiagnosticSeverity::WARNING: return "warning";
+        case DiagnosticSeverity::WEAK_WARNING: return "weak_warning";
+    }
+    return "error";
+}
+
+}
+
+void JsonLinesWriter::format(const Diagnostic &diagnostic, std::string &text) const {
+    const auto [path, begin, end] = resolve(diagnostic.source_range);
+    text += "{\"file\":";
+    appendJsonString(text, path.native());
+    text += ",\"line\":";
+    appendNumber(text, begin.line);
+    text += ",\"column\":";
+    appendNumber(text, begin.column);
+    text += ",\"end_line\":";
+    appendNumber(text, end.line);
+    text += ",\"end_column\":";
+    appendNumber(text, end.column);
+    text += ",\"severity\":\"";
+    text += severityName(diagnostic.severity);
+    text += "\",\"kind\":\"";
+    text += magic_enum::enum_name(diagnostic.kind);
+    text += "\",\"message\":";
+    appendJsonString(text, diagnostic.msg());
+    text += "}\n";
+}
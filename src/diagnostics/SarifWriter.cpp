@@ -0,0 +1,78 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/diagnostics/SarifWriter.h"
+
+#include <cctype>
+
+namespace {
+
+std::string_view levelOf(const DiagnosticSeverity severity) {
+    switch (severity) {
+        case DiagnosticSeverity::ERROR: return "error";
+        case DiagnosticSeverity::WARNING: return "warning";
+        case DiagnosticSeverity::WEAK_WARNING: return "note";
+    }
+    return "error";
+}
+
+// A file:// URI for the absolute path, with everything but unreserved characters and separators
+// percent-encoded
+std::string fileUri(const std::filesystem::path& path) {
+    constexpr std::string_view hex = "0123456789ABCDEF";
+    const std::string absolute = std::filesystem::absolute(path).generic_string();
+    std::string uri = "file://";
+    if (!absolute.starts_with('/')) uri += '/'; // a drive letter
+    for (const char c : absolute) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || std::string_view{"-._~/:"}.find(c) != std::string_view::npos) {
+            uri += c;
+        } else {
+            uri += '%';
+            uri += hex[static_cast<unsigned char>(c) >> 4];
+            uri += hex[static_cast<unsigned char>(c) & 0xf];
+        }
+    }
+    return uri;
+}
+
+}
+
+SarifWriter::SarifWriter(std::ostream &out, const SourceManager &source_manager, const std::size_t buffer_size)
+    : DiagnosticWriter(out, source_manager, buffer_size) {
+    writeRaw(R"({"version":"2.1.0","$schema":"https://json.schemastore.org/sarif-2.1.0.json",)"
+             R"("runs":[{"tool":{"driver":{"name":"kahwa_lang"}},"results":[)" "\n");
+    setSeparator(",\n");
+}
+
+SarifWriter::~SarifWriter() {
+    finish();
+}
+
+void SarifWriter::finish() {
+    if (finished) return;
+    finished = true;
+    writeRaw("\n]}]}\n");
+    flush();
+}
+
+void SarifWriter::format(const Diagnostic &diagnostic, std::string &text) const {
+    const auto [path, begin, end] = resolve(diagnostic.source_range);
+    text += "{\"ruleId\":\"";
+    text += magic_enum::enum_name(diagnostic.kind);
+    text += "\",\"level\":\"";
+    text += levelOf(diagnostic.severity);
+    text += "\",\"message\":{\"text\":";
+    appendJsonString(text, diagnostic.msg());
+    text += "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":";
+    appendJsonString(text, fileUri(path));
+    text += "},\"region\":{\"startLine\":";
+    appendNumber(text, begin.line);
+    text += ",\"startColumn\":";
+    appendNumber(text, begin.column);
+    text += ",\"endLine\":";
+    appendNumber(text, end.line);
+    text += ",\"endColumn\":";
+    appendNumber(text, end.column);
+    text += "}}}]}";
+}
@@ -0,0 +1,303 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/driver/Driver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/TokenStream.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// Which worker got which file varies from run to run, the merged order must not. Files are laid out in order,
+// so sorting by location sorts by file first. A file's diagnostics come from a single engine, or are added in
+// parse order, so the stable sort keeps them in the order they were reported. Errors past the first
+// `error_limit` are dropped.
+std::vector<Diagnostic> sortedByLocation(std::vector<const Diagnostic*> diagnostics, const std::size_t error_limit = DiagnosticOptions::NO_LIMIT) {
+    std::ranges::stable_sort(diagnostics, {}, [](const Diagnostic* d) { return d->source_range.begin.offset; });
+    std::vector<Diagnostic> sorted;
+    sorted.reserve(diagnostics.size());
+    std::size_t errors = 0;
+    for (const Diagnostic* diagnostic : diagnostics) {
+        if (diagnostic->severity == DiagnosticSeverity::ERROR && errors++ >= error_limit) continue;
+        sorted.push_back(*diagnostic);
+    }
+    return sorted;
+}
+
+// The tokens that start in [start, stop) when lexing from `start`, and what lexing them reported. Lexing a
+// token depends only on the text from where it begins, so from the first token the whole file's lexing also
+// begins at, the rest are the same.
+struct LexedChunk {
+    std::vector<Token> tokens;
+    std::vector<Diagnostic> diagnostics;
+    std::size_t next = SIZE_MAX; // where lexing past `stop` carries on, if it does
+};
+
+LexedChunk lexChunk(const std::string_view source, const std::size_t start, const std::size_t stop) {
+    LexedChunk chunk;
+    DiagnosticEngine engine;
+    Tokeniser::TokeniserWorker lexer{SourceLocation{start}, source.substr(start), engine};
+    while (const auto token = lexer.lexToken()) {
+        if (token->getSourceRange().begin.offset >= stop) {
+            chunk.next = token->getSourceRange().begin.offset;
+            break;
+        }
+        chunk.tokens.push_back(*token);
+    }
+    for (const auto& diagnostic : engine.getAll()) {
+        if (diagnostic.source_range.begin.offset < stop) chunk.diagnostics.push_back(diagnostic);
+    }
+    // An unterminated string past `stop` ends the file without a token, the next chunk reports it
+    if (chunk.next == SIZE_MAX && !engine.getAll().empty() && engine.getAll().back().source_range.begin.offset >= stop) {
+        chunk.next = engine.getAll().back().source_range.begin.offset;
+    }
+    return chunk;
+}
+
+// Where to start each chunk: roughly equal numbers of tokens, each starting right after a ';' or '}' outside
+// any braces, where a top-level declaration most likely ends. A guess that is wrong costs time, not
+// correctness, so unbalanced braces only need to not break it.
+std::vector<std::size_t> chunkStarts(const std::vector<Token>& tokens, const std::size_t chunks) {
+    std::vector<std::size_t> starts{0};
+    std::size_t depth = 0;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        const TokenType type = tokens[i].type;
+        if (type == TokenType::LEFT_CURLY_BRACE) {
+            depth++;
+            continue;
+        }
+        if (type == TokenType::RIGHT_CURLY_BRACE) {
+            depth = depth == 0 ? 0 : depth - 1;
+            if (depth > 0) continue;
+        } else if (type != TokenType::SEMI_COLON || depth > 0) {
+            continue;
+        }
+
+        if (i + 1 < tokens.size() && i + 1 >= tokens.size() * starts.size() / chunks) starts.push_back(i + 1);
+        if (starts.size() == chunks) break;
+    }
+    return starts;
+}
+
+}
+
+Project Driver::parse(const std::vector<std::string_view> &sources) {
+    // The same layout a SourceManager would give these files
+    std::vector<SourceLocation> file_starts;
+    std::size_t start = 0;
+    for (const std::string_view source : sources) {
+        file_starts.emplace_back(start);
+        start = SourceManager::nextFileStart(start, source.length());
+    }
+    return parse(sources, file_starts);
+}
+
+Project Driver::parse(const std::vector<std::string_view> &sources, const std::vector<SourceLocation> &file_starts) {
+    Project project;
+    project.files.resize(sources.size());
+
+    // The error limit is applied here, in file order rather than in the order workers happen to report, so
+    // the same files and diagnostics are kept whatever the thread count. A streaming engine applies it itself.
+    const std::size_t error_limit = diagnostic_options.error_limit;
+    DiagnosticOptions engine_options = diagnostic_options;
+    if (!engine_options.sink) engine_options.error_limit = DiagnosticOptions::NO_LIMIT;
+
+    // A Parser per worker rather than per file, so a worker's files share their interned types
+    DiagnosticEngine diagnostic_engine{engine_options};
+    std::vector<Parser> parsers;
+    parsers.reserve(pool.size());
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        project.arenas.push_back(std::make_unique<Arena>());
+        parsers.emplace_back(*project.arenas[i], diagnostic_engine);
+    }
+
+    // The errors of each file parsed so far. Once the files up to one of them hold `error_limit` errors, that
+    // is the last file kept and no worker needs to parse past it.
+    std::mutex file_errors_mutex;
+    std::vector<std::optional<std::size_t>> file_errors(sources.size());
+    std::size_t counted_files = 0;
+    std::size_t counted_errors = 0;
+    std::atomic<std::size_t> last_file{sources.size()};
+
+    pool.parallelFor(sources.size(), [&](const std::size_t file_id, const std::size_t worker) {
+        // Only a streaming engine has a limit of its own to reach
+        if (file_id > last_file.load(std::memory_order_relaxed) || diagnostic_engine.limitReached()) {
+            project.files[file_id] = project.arenas[worker]->make<KahwaFile>();
+            return;
+        }
+        diagnostic_engine.beginFile();
+        const std::size_t errors_before = diagnostic_engine.threadErrorCount();
+        TokenStream tokens = Tokeniser{diagnostic_engine}.stream(file_starts[file_id], sources[file_id]);
+        project.files[file_id] = parsers[worker].parseFile(tokens);
+
+        // A file is parsed to the end once started, but what it found is dropped as soon as it is past the limit
+        std::lock_guard lock{file_errors_mutex};
+        if (file_id > last_file.load(std::memory_order_relaxed)) {
+            project.files[file_id] = project.arenas[worker]->make<KahwaFile>();
+            return;
+        }
+        file_errors[file_id] = diagnostic_engine.threadErrorCount() - errors_before;
+        while (counted_files < sources.size() && file_errors[counted_files] && counted_errors < error_limit) {
+            counted_errors += *file_errors[counted_files++];
+            if (counted_errors >= error_limit) last_file.store(counted_files - 1, std::memory_order_relaxed);
+        }
+    });
+    diagnostic_engine.flush();
+
+    // Workers may have parsed past the last file before it was known, what they found is dropped
+    const std::size_t kept_files = std::min(last_file.load(std::memory_order_relaxed) + 1, sources.size());
+    for (std::size_t file_id = kept_files; file_id < sources.size(); file_id++) {
+        project.files[file_id] = project.arenas[0]->make<KahwaFile>();
+    }
+    const std::size_t kept_end = kept_files < sources.size() ? file_starts[kept_files].offset : SIZE_MAX;
+
+    // Only the kept files' errors count as over the limit, the rest depend on how far workers got
+    std::vector<const Diagnostic*> merged;
+    std::size_t errors = 0;
+    for (const auto& diagnostic : diagnostic_engine.getAll()) {
+        if (diagnostic.source_range.begin.offset >= kept_end) continue;
+        if (diagnostic.severity == DiagnosticSeverity::ERROR) errors++;
+        merged.push_back(&diagnostic);
+    }
+    project.diagnostics = sortedByLocation(std::move(merged), error_limit);
+    project.dropped_diagnostics = diagnostic_engine.stats();
+    if (!diagnostic_options.sink) {
+        project.dropped_diagnostics.over_limit = errors - std::ranges::count(project.diagnostics, DiagnosticSeverity::ERROR, &Diagnostic::severity);
+    }
+    return project;
+}
+
+std::vector<Token> Driver::tokeniseParallel(const std::string_view source, std::vector<Diagnostic>& diagnostics) {
+    // Chunks start at line starts, where a token most likely begins
+    std::vector<std::size_t> starts{0};
+    const std::size_t chunk_count = std::clamp<std::size_t>(source.size() / MIN_CHUNK_BYTES, 1, pool.size() * 4);
+    for (std::size_t i = 1; i < chunk_count; i++) {
+        const std::size_t line_end = source.find('\n', source.size() * i / chunk_count);
+        if (line_end == std::string_view::npos) break;
+        if (line_end + 1 > starts.back() && line_end + 1 < source.size()) starts.push_back(line_end + 1);
+    }
+    const auto stop = [&](const std::size_t chunk) { return chunk + 1 < starts.size() ? starts[chunk + 1] : source.size(); };
+
+    std::vector<LexedChunk> chunks(starts.size());
+    pool.parallelFor(starts.size(), [&](const std::size_t index, std::size_t) {
+        chunks[index] = lexChunk(source, starts[index], stop(index));
+    });
+
+    // A chunk that started inside a comment or string is only kept from the token the previous chunk's lexing
+    // runs into, if it has one there. Otherwise it is lexed again from that token.
+    std::vector<Token> tokens;
+    std::size_t next = 0;
+    for (std::size_t index = 0; index < chunks.size() && next != SIZE_MAX; index++) {
+        LexedChunk& chunk = chunks[index];
+        if (next != starts[index]) {
+            const auto first = std::ranges::lower_bound(chunk.tokens, next, {}, [](const Token& token) { return token.getSourceRange().begin.offset; });
+            if (first == chunk.tokens.end() || first->getSourceRange().begin.offset != next) {
+                chunk = lexChunk(source, next, stop(index));
+            }
+        }
+        for (const Token& token : chunk.tokens) {
+            if (token.getSourceRange().begin.offset >= next) tokens.push_back(token);
+        }
+        for (const auto& diagnostic : chunk.diagnostics) {
+            if (diagnostic.source_range.begin.offset >= next) diagnostics.push_back(diagnostic);
+        }
+        next = chunk.next;
+    }
+    return tokens;
+}
+
+Project Driver::parseFileParallel(const std::string_view source) {
+    Project project;
+
+    std::vector<Diagnostic> lexer_diagnostics;
+    const std::vector<Token> tokens = tokeniseParallel(source, lexer_diagnostics);
+
+    const std::size_t chunk_count = std::clamp<std::size_t>(tokens.size() / MIN_CHUNK_TOKENS, 1, pool.size() * 4);
+    const std::vector<std::size_t> starts = chunkStarts(tokens, chunk_count);
+
+    // Each chunk is parsed from its start as though the parse of the whole file had stopped there, until
+    // a declaration runs into the next chunk
+    struct Chunk {
+        std::size_t worker;
+        std::optional<Parser::Declarations> decls;
+        std::vector<Parser::Boundary> boundaries;
+    };
+    std::vector<DiagnosticEngine> diagnostic_engines(pool.size());
+    std::vector<Parser> parsers;
+    parsers.reserve(pool.size());
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        project.arenas.push_back(std::make_unique<Arena>());
+        parsers.emplace_back(*project.arenas[i], diagnostic_engines[i]);
+    }
+
+    std::vector<Chunk> chunks(starts.size());
+    pool.parallelFor(starts.size(), [&](const std::size_t index, const std::size_t worker) {
+        Chunk& chunk = chunks[index];
+        chunk.worker = worker;
+        chunk.decls.emplace(*project.arenas[worker]);
+        const std::size_t stop = index + 1 < starts.size() ? starts[index + 1] : tokens.size();
+        parsers[worker].parseDeclarations(tokens, starts[index], stop, *chunk.decls, chunk.boundaries);
+    });
+
+    // Stitched together in order. Where the parse so far is at a boundary a chunk also reached, the rest of
+    // that chunk is what a sequential parse would produce. Where a declaration overran a chunk's start to
+    // somewhere the chunk did not stop, declarations are parsed one at a time until the two line up again.
+    Arena& arena = *project.arenas[0];
+    Parser::Declarations decls{arena};
+    std::vector<Diagnostic> parser_diagnostics; // copied, since parsing more may move the engines' ones
+
+    const auto append = [&](const Parser::Declarations& from, const DiagnosticEngine& engine, const Parser::Boundary& begin, const Parser::Boundary& end) {
+        for (std::size_t i = begin.typedefs; i < end.typedefs; i++) decls.typedefDecls.push_back(from.typedefDecls.span()[i]);
+        for (std::size_t i = begin.classes; i < end.classes; i++) decls.classDecls.push_back(from.classDecls.span()[i]);
+        for (std::size_t i = begin.functions; i < end.functions; i++) decls.functionDecls.push_back(from.functionDecls.span()[i]);
+        for (std::size_t i = begin.variables; i < end.variables; i++) decls.variableDecls.push_back(from.variableDecls.span()[i]);
+        for (std::size_t i = begin.diagnostics; i < end.diagnostics; i++) parser_diagnostics.push_back(engine.getAll()[i]);
+    };
+
+    std::size_t position = 0;
+    while (position < tokens.size()) {
+        const auto chunk_it = std::ranges::upper_bound(starts, position) - 1;
+        const Chunk& chunk = chunks[chunk_it - starts.begin()];
+        const auto boundary = std::ranges::lower_bound(chunk.boundaries, position, {}, &Parser::Boundary::token);
+        if (boundary != chunk.boundaries.end() && boundary->token == position) {
+            append(*chunk.decls, diagnostic_engines[chunk.worker], *boundary, chunk.boundaries.back());
+            position = chunk.boundaries.back().token;
+            continue;
+        }
+
+        // The pool is idle again, so the first worker's parser is free
+        Parser::Declarations single{arena};
+        std::vector<Parser::Boundary> boundaries;
+        parsers[0].parseDeclarations(tokens, position, position + 1, single, boundaries);
+        append(single, diagnostic_engines[0], boundaries.front(), boundaries.back());
+        position = boundaries.back().token;
+    }
+
+    project.files.push_back(arena.make<KahwaFile>(decls.typedefDecls.span(), decls.classDecls.span(), decls.functionDecls.span(), decls.variableDecls.span()));
+
+    // As from a single engine: the lexer's diagnostics are reported before the parser's at the same place
+    std::vector<const Diagnostic*> merged;
+    for (const auto& diagnostic : lexer_diagnostics) merged.push_back(&diagnostic);
+    for (const auto& diagnostic : parser_diagnostics) merged.push_back(&diagnostic);
+    project.diagnostics = sortedByLocation(std::move(merged));
+    return project;
+}
+
+Project Driver::parse(const SourceManager &source_manager) {
+    std::vector<std::string_view> sources;
+    std::vector<SourceLocation> file_starts;
+    sources.reserve(source_manager.fileCount());
+    file_starts.reserve(source_manager.fileCount());
+    for (std::size_t file_id = 0; file_id < source_manager.fileCount(); file_id++) {
+        sources.emplace_back(source_manager.getSource(file_id));
+        file_starts.push_back(source_manager.getFileStart(file_id));
+    }
+    return parse(sources, file_starts);
+}
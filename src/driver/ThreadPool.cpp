@@ -0,0 +1,107 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/driver/ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (std::size_t i = 0; i < threads; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{mutex};
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t, std::size_t)> &fn) {
+    if (count == 0) return;
+
+    // Contiguous slices keep neighbouring indices, usually files of similar size, on the same worker
+    const std::size_t per_worker = (count + workers.size() - 1) / workers.size();
+    for (std::size_t worker = 0; worker < workers.size(); worker++) {
+        std::lock_guard lock{queues[worker]->mutex};
+        for (std::size_t i = worker * per_worker; i < std::min(count, (worker + 1) * per_worker); i++) {
+            queues[worker]->indices.push_back(i);
+        }
+    }
+
+    std::unique_lock lock{mutex};
+    job = &fn;
+    busy = workers.size();
+    error = nullptr;
+    generation++;
+    work_ready.notify_all();
+    work_done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+
+    if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+}
+
+void ThreadPool::workerLoop(const std::size_t worker) {
+    std::size_t seen_generation = 0;
+    while (true) {
+        const std::function<void(std::size_t, std::size_t)>* fn;
+        {
+            std::unique_lock lock{mutex};
+            work_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) return;
+            seen_generation = generation;
+            fn = job;
+        }
+
+        std::size_t index;
+        while (nextIndex(worker, index)) {
+            try {
+                (*fn)(index, worker);
+            } catch (...) {
+                std::lock_guard lock{mutex};
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        std::lock_guard lock{mutex};
+        if (--busy == 0) {
+            work_done.notify_one();
+        }
+    }
+}
+
+bool ThreadPool::nextIndex(const std::size_t worker, std::size_t &index) {
+    {
+        WorkQueue& own = *queues[worker];
+        std::lock_guard lock{own.mutex};
+        if (!own.indices.empty()) {
+            index = own.indices.front();
+            own.indices.pop_front();
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < queues.size(); offset++) {
+        WorkQueue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard lock{victim.mutex};
+        if (!victim.indices.empty()) {
+            index = victim.indices.back();
+            victim.indices.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,380 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/parser/BinaryAst.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace binary_ast {
+namespace {
+
+// Appends nodes to the image after the header. A node is written after everything it points to, so the
+// buffer may grow while its children are written but never while the node itself is being filled in.
+class Writer {
+public:
+    explicit Writer(const SourceLocation file_start): file_start(file_start.offset) {
+        allocate<Header>();
+    }
+
+    std::string finish(const ::KahwaFile& file) {
+        const std::uint32_t root = write(file);
+
+        std::vector<std::uint32_t> chars;
+        chars.reserve(symbols.size());
+        for (const Symbol symbol : symbols) chars.push_back(writeChars(symbol.str()));
+        const std::uint32_t strings = allocate<RelArray<char>>(symbols.size());
+        for (std::size_t i = 0; i < symbols.size(); i++) {
+            link(at<RelArray<char>>(strings, i), chars[i], symbols[i].str().size());
+        }
+
+        auto& header = at<Header>(0);
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.size = static_cast<std::uint32_t>(bytes.size());
+        link(header.strings, strings, symbols.size());
+        link(header.file, root);
+        return std::move(bytes);
+    }
+
+private:
+    std::string bytes;
+    const std::uint32_t file_start;
+
+    std::vector<Symbol> symbols;
+    std::unordered_map<Symbol, StringId> string_ids;
+    std::unordered_map<const ::TypeRef*, std::uint32_t> types; // written already
+
+    // Zeroed space for `count` T, returning its offset
+    template <typename T>
+    std::uint32_t allocate(const std::size_t count = 1) {
+        static_assert(alignof(T) <= 4 && std::is_trivially_copyable_v<T>);
+        const std::size_t offset = (bytes.size() + 3) & ~std::size_t{3};
+        if (offset + sizeof(T) * count > UINT32_MAX) throw std::length_error("AST image is larger than 4 GiB");
+        bytes.resize(offset + sizeof(T) * count);
+        return static_cast<std::uint32_t>(offset);
+    }
+
+    template <typename T>
+    T& at(const std::uint32_t offset, const std::size_t index = 0) {
+        return reinterpret_cast<T*>(bytes.data() + offset)[index];
+    }
+
+    template <typename T>
+    void link(RelPtr<T>& ptr, const std::uint32_t target) {
+        const auto from = reinterpret_cast<const char*>(&ptr) - bytes.data();
+        ptr.offset = static_cast<std::int32_t>(static_cast<std::int64_t>(target) - from);
+    }
+
+    template <typename T>
+    void link(RelArray<T>& array, const std::uint32_t first, const std::size_t count) {
+        array.count = static_cast<std::uint32_t>(count);
+        if (count > 0) link(array.first, first);
+    }
+
+    // An array of pointers to nodes already written, 0 meaning null
+    template <typename T>
+    std::uint32_t writePointers(const std::vector<std::uint32_t>& targets) {
+        const std::uint32_t array = allocate<RelPtr<T>>(targets.size());
+        for (std::size_t i = 0; i < targets.size(); i++) {
+            if (targets[i] != 0) link(at<RelPtr<T>>(array, i), targets[i]);
+        }
+        return array;
+    }
+
+    template <typename T, typename Node, typename Write>
+    std::uint32_t writeAll(const ArenaSpan<Node*> nodes, Write&& write) {
+        std::vector<std::uint32_t> targets;
+        targets.reserve(nodes.size());
+        for (const Node* node : nodes) targets.push_back(node ? write(*node) : 0);
+        return writePointers<T>(targets);
+    }
+
+    std::uint32_t writeChars(const std::string_view str) {
+        const std::uint32_t offset = allocate<char>(str.size());
+        str.copy(bytes.data() + offset, str.size());
+        return offset;
+    }
+
+    StringId string(const Symbol symbol) {
+        const auto [it, inserted] = string_ids.try_emplace(symbol, static_cast<StringId>(symbols.size()));
+        if (inserted) symbols.push_back(symbol);
+        return it->second;
+    }
+
+    [[nodiscard]] Range range(const SourceRange& range) const {
+        return {range.begin.offset - file_start, range.end.offset - file_start};
+    }
+
+    std::uint32_t write(const ::TypeRef* type) {
+        if (type == nullptr) return 0;
+        if (const auto it = types.find(type); it != types.end()) return it->second;
+
+        const std::uint32_t args = writeAll<TypeRef>(type->args, [&](const ::TypeRef& arg) { return write(&arg); });
+        const std::uint32_t offset = allocate<TypeRef>();
+        auto& node = at<TypeRef>(offset);
+        node.identifier = string(type->identifier);
+        link(node.args, args, type->args.size());
+        types.emplace(type, offset);
+        return offset;
+    }
+
+    // Writes what a Decl points to, and fills it in once its node has been allocated
+    class DeclWriter {
+    public:
+        DeclWriter(Writer& writer, const ::Decl& decl): writer(writer), decl(decl) {
+            modifiers = writer.allocate<Modifier>(decl.modifiers.size());
+            for (std::size_t i = 0; i < decl.modifiers.size(); i++) writer.at<Modifier>(modifiers, i) = decl.modifiers[i];
+        }
+
+        void fill(Decl& node) const {
+            node.name = writer.string(decl.name);
+            writer.link(node.modifiers, modifiers, decl.modifiers.size());
+            node.name_range = writer.range(decl.nameSourceRange);
+            node.body_range = writer.range(decl.bodyRange);
+        }
+
+    private:
+        Writer& writer;
+        const ::Decl& decl;
+        std::uint32_t modifiers;
+    };
+
+    std::uint32_t write(const ::TypedefDecl& decl) {
+        const std::uint32_t type = write(decl.referredType);
+        const DeclWriter base{*this, decl};
+        const std::uint32_t offset = allocate<TypedefDecl>();
+        auto& node = at<TypedefDecl>(offset);
+        base.fill(node.decl);
+        node.typedef_range = range(decl.typedefSourceRange);
+        if (type) link(node.referred_type, type);
+        return offset;
+    }
+
+    std::uint32_t write(const ::FieldDecl& decl) {
+        const std::uint32_t type = write(decl.type);
+        const DeclWriter base{*this, decl};
+        const std::uint32_t offset = allocate<FieldDecl>();
+        auto& node = at<FieldDecl>(offset);
+        base.fill(node.decl);
+        if (type) link(node.type, type);
+        node.type_range = range(decl.typeSourceRange);
+        return offset;
+    }
+
+    std::uint32_t write(const ::MethodDecl& decl) {
+        const std::uint32_t return_type = write(decl.returnType);
+        std::vector<std::uint32_t> parameter_types;
+        for (const auto& [type, name] : decl.parameters) parameter_types.push_back(write(type));
+        std::uint32_t block = 0;
+        if (decl.block) {
+            block = allocate<Block>();
+            at<Block>(block).stmts = static_cast<std::uint32_t>(decl.block->stmts.size());
+        }
+        const std::uint32_t parameters = allocate<Parameter>(decl.parameters.size());
+        for (std::size_t i = 0; i < decl.parameters.size(); i++) {
+            auto& parameter = at<Parameter>(parameters, i);
+            if (parameter_types[i]) link(parameter.type, parameter_types[i]);
+            parameter.name = string(decl.parameters[i].second);
+        }
+        const DeclWriter base{*this, decl};
+
+        const std::uint32_t offset = allocate<MethodDecl>();
+        auto& node = at<MethodDecl>(offset);
+        base.fill(node.decl);
+        if (return_type) link(node.return_type, return_type);
+        link(node.parameters, parameters, decl.parameters.size());
+        if (block) link(node.block, block);
+        node.return_type_range = range(decl.returnTypeSourceRange);
+        return offset;
+    }
+
+    std::uint32_t write(const ::ClassDecl& decl) {
+        const std::uint32_t super_classes = writeAll<TypeRef>(decl.superClasses, [&](const ::TypeRef& type) { return write(&type); });
+        const std::uint32_t fields = writeAll<FieldDecl>(decl.fields, [&](const ::FieldDecl& field) { return write(field); });
+        const std::uint32_t methods = writeAll<MethodDecl>(decl.methods, [&](const ::MethodDecl& method) { return write(method); });
+        const std::uint32_t nested = writeAll<ClassDecl>(decl.nestedClasses, [&](const ::ClassDecl& nested) { return write(nested); });
+        const DeclWriter base{*this, decl};
+
+        const std::uint32_t offset = allocate<ClassDecl>();
+        auto& node = at<ClassDecl>(offset);
+        base.fill(node.decl);
+        node.class_range = range(decl.classSourceRange);
+        link(node.super_classes, super_classes, decl.superClasses.size());
+        link(node.fields, fields, decl.fields.size());
+        link(node.methods, methods, decl.methods.size());
+        link(node.nested_classes, nested, decl.nestedClasses.size());
+        return offset;
+    }
+
+    std::uint32_t write(const ::KahwaFile& file) {
+        const std::uint32_t typedefs = writeAll<TypedefDecl>(file.typedefDecls, [&](const ::TypedefDecl& decl) { return write(decl); });
+        const std::uint32_t classes = writeAll<ClassDecl>(file.classDecls, [&](const ::ClassDecl& decl) { return write(decl); });
+        const std::uint32_t functions = writeAll<MethodDecl>(file.functionDecls, [&](const ::MethodDecl& decl) { return write(decl); });
+        const std::uint32_t variables = writeAll<FieldDecl>(file.variableDecls, [&](const ::FieldDecl& decl) { return write(decl); });
+
+        const std::uint32_t offset = allocate<KahwaFile>();
+        auto& node = at<KahwaFile>(offset);
+        link(node.typedef_decls, typedefs, file.typedefDecls.size());
+        link(node.class_decls, classes, file.classDecls.size());
+        link(node.function_decls, functions, file.functionDecls.size());
+        link(node.variable_decls, variables, file.variableDecls.size());
+        return offset;
+    }
+};
+
+// Rebuilds the pointer tree, interning each string of the image once
+class Loader {
+public:
+    Loader(const BinaryAst& ast, const std::size_t strings, Arena& arena, TypeTable& types, const SourceLocation file_start)
+        : ast(ast), arena(arena), types(types), file_start(file_start.offset), symbols(strings) {}
+
+    ::KahwaFile* load(const KahwaFile& file) {
+        return arena.make<::KahwaFile>(
+            loadAll<::TypedefDecl>(file.typedef_decls),
+            loadAll<::ClassDecl>(file.class_decls),
+            loadAll<::MethodDecl>(file.function_decls),
+            loadAll<::FieldDecl>(file.variable_decls));
+    }
+
+private:
+    const BinaryAst& ast;
+    Arena& arena;
+    TypeTable& types;
+    const std::uint32_t file_start;
+    std::vector<std::optional<Symbol>> symbols;
+
+    Symbol symbol(const StringId id) {
+        auto& symbol = symbols[id];
+        if (!symbol) symbol = Symbol::intern(ast.str(id));
+        return *symbol;
+    }
+
+    [[nodiscard]] SourceRange range(const Range range) const {
+        return {SourceLocation{range.begin + file_start}, SourceLocation{range.end + file_start}};
+    }
+
+    template <typename T, typename Node>
+    ArenaSpan<T*> loadAll(const RelArray<RelPtr<Node>>& nodes) {
+        if (nodes.empty()) return {};
+        auto** loaded = static_cast<T**>(arena.allocate(sizeof(T*) * nodes.size(), alignof(T*)));
+        for (std::size_t i = 0; i < nodes.size(); i++) loaded[i] = nodes[i] ? load(*nodes[i]) : nullptr;
+        return {loaded, nodes.size()};
+    }
+
+    ArenaSpan<Modifier> modifiers(const Decl& decl) const {
+        return ArenaSpan<Modifier>::copyOf(arena, decl.modifiers);
+    }
+
+    ::TypeRef* load(const RelPtr<TypeRef>& type) {
+        return type ? load(*type) : nullptr;
+    }
+
+    ::TypeRef* load(const TypeRef& type) {
+        if (type.args.empty()) return types.intern(symbol(type.identifier));
+        std::vector<::TypeRef*> args;
+        args.reserve(type.args.size());
+        for (const auto& arg : type.args) args.push_back(load(arg));
+        return types.intern(symbol(type.identifier), args);
+    }
+
+    ::TypedefDecl* load(const TypedefDecl& decl) {
+        return arena.make<::TypedefDecl>(symbol(decl.decl.name), modifiers(decl.decl), load(decl.referred_type),
+            range(decl.typedef_range), range(decl.decl.name_range), range(decl.decl.body_range));
+    }
+
+    ::FieldDecl* load(const FieldDecl& decl) {
+        return arena.make<::FieldDecl>(symbol(decl.decl.name), modifiers(decl.decl), load(decl.type),
+            range(decl.type_range), range(decl.decl.name_range), range(decl.decl.body_range));
+    }
+
+    ::MethodDecl* load(const MethodDecl& decl) {
+        std::vector<std::pair<::TypeRef*, Symbol>> parameters;
+        parameters.reserve(decl.parameters.size());
+        for (const auto& [type, name] : decl.parameters) parameters.emplace_back(load(type), symbol(name));
+
+        ::Block* block = nullptr;
+        if (decl.block) {
+            std::vector<Stmt*> stmts(decl.block->stmts);
+            for (auto& stmt : stmts) stmt = arena.make<Stmt>();
+            block = arena.make<::Block>(ArenaSpan<Stmt*>::copyOf(arena, stmts));
+        }
+        return arena.make<::MethodDecl>(symbol(decl.decl.name), modifiers(decl.decl), load(decl.return_type),
+            ArenaSpan<std::pair<::TypeRef*, Symbol>>::copyOf(arena, parameters), block,
+            range(decl.return_type_range), range(decl.decl.name_range), range(decl.decl.body_range));
+    }
+
+    ::ClassDecl* load(const ClassDecl& decl) {
+        std::vector<::TypeRef*> super_classes;
+        super_classes.reserve(decl.super_classes.size());
+        for (const auto& type : decl.super_classes) super_classes.push_back(load(type));
+
+        return arena.make<::ClassDecl>(symbol(decl.decl.name), range(decl.class_range), range(decl.decl.name_range),
+            range(decl.decl.body_range), modifiers(decl.decl), ArenaSpan<::TypeRef*>::copyOf(arena, super_classes),
+            loadAll<::FieldDecl>(decl.fields), loadAll<::MethodDecl>(decl.methods), loadAll<::ClassDecl>(decl.nested_classes));
+    }
+};
+
+}
+}
+
+namespace {
+
+// Closes the descriptor on every path out of the constructor
+struct FileDescriptor {
+    int fd;
+    ~FileDescriptor() { if (fd >= 0) close(fd); }
+};
+
+std::filesystem::filesystem_error errnoError(const char* what, const std::filesystem::path& path) {
+    return std::filesystem::filesystem_error{what, path, std::error_code{errno, std::generic_category()}};
+}
+
+}
+
+std::string BinaryAst::serialise(const KahwaFile &file, const SourceLocation file_start) {
+    return binary_ast::Writer{file_start}.finish(file);
+}
+
+std::optional<BinaryAst> BinaryAst::view(const std::string_view bytes) {
+    assert(reinterpret_cast<std::uintptr_t>(bytes.data()) % 4 == 0);
+    if (bytes.size() < sizeof(binary_ast::Header)) return std::nullopt;
+
+    const auto* header = reinterpret_cast<const binary_ast::Header*>(bytes.data());
+    if (header->magic != binary_ast::MAGIC || header->version != binary_ast::VERSION || header->size != bytes.size()) {
+        return std::nullopt;
+    }
+    return BinaryAst{header};
+}
+
+KahwaFile *BinaryAst::load(Arena &arena, TypeTable &types, const SourceLocation file_start) const {
+    return binary_ast::Loader{*this, header->strings.size(), arena, types, file_start}.load(file());
+}
+
+MappedAst::MappedAst(const std::filesystem::path &path) {
+    const FileDescriptor file{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file.fd < 0) throw errnoError("cannot open AST image", path);
+
+    struct stat info{};
+    if (fstat(file.fd, &info) != 0) throw errnoError("cannot stat AST image", path);
+
+    // An empty file is no image, and cannot be mapped
+    size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) return;
+
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+    if (data == MAP_FAILED) throw errnoError("cannot map AST image", path);
+}
+
+MappedAst::~MappedAst() {
+    if (data) munmap(data, size);
+}
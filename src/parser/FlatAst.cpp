@@ -0,0 +1,77 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/parser/FlatAst.h"
+
+FlatAst::FlatAst(const KahwaFile& file) {
+    append(NodeKind::FILE, &file, std::nullopt, SourceLocation{0}, NO_NODE);
+    for (NodeId id = 0; id < size(); id++) {
+        appendChildren(id);
+    }
+    if (size() > 1) locations[ROOT] = locations[ROOT + 1];
+}
+
+NodeId FlatAst::append(const NodeKind kind, const void* node, const std::optional<Symbol> name, const SourceLocation location, const NodeId parent) {
+    const auto id = static_cast<NodeId>(size());
+    kinds.push_back(kind);
+    names.push_back(name ? name->id : NO_NAME);
+    locations.push_back(location.offset);
+    parents.push_back(parent);
+    first_children.push_back(0);
+    child_counts.push_back(0);
+    nodes.push_back(node);
+    return id;
+}
+
+void FlatAst::appendChildren(const NodeId id) {
+    const auto first = static_cast<NodeId>(size());
+    const SourceLocation location{locations[id]};
+
+    const auto appendDecl = [&]<typename T>(const T* decl) {
+        if (decl) append(kindOf<T>(), decl, decl->name, decl->nameSourceRange.begin, id);
+    };
+    const auto appendType = [&](const TypeRef* type) {
+        if (type) append(NodeKind::TYPE_REF, type, type->identifier, location, id);
+    };
+
+    switch (kinds[id]) {
+        case NodeKind::FILE: {
+            const auto& file = node<KahwaFile>(id);
+            for (const auto* decl : file.typedefDecls) appendDecl(decl);
+            for (const auto* decl : file.classDecls) appendDecl(decl);
+            for (const auto* decl : file.functionDecls) appendDecl(decl);
+            for (const auto* decl : file.variableDecls) appendDecl(decl);
+            break;
+        }
+        case NodeKind::TYPEDEF:
+            appendType(node<TypedefDecl>(id).referredType);
+            break;
+        case NodeKind::CLASS: {
+            const auto& decl = node<ClassDecl>(id);
+            for (const auto* type : decl.superClasses) appendType(type);
+            for (const auto* field : decl.fields) appendDecl(field);
+            for (const auto* method : decl.methods) appendDecl(method);
+            for (const auto* nested : decl.nestedClasses) appendDecl(nested);
+            break;
+        }
+        case NodeKind::METHOD: {
+            const auto& decl = node<MethodDecl>(id);
+            appendType(decl.returnType);
+            for (const auto& [type, name] : decl.parameters) appendType(type);
+            if (decl.block) append(NodeKind::BLOCK, decl.block, std::nullopt, location, id);
+            break;
+        }
+        case NodeKind::FIELD:
+            appendType(node<FieldDecl>(id).type);
+            break;
+        case NodeKind::TYPE_REF:
+            for (const auto* arg : node<TypeRef>(id).args) appendType(arg);
+            break;
+        case NodeKind::BLOCK:
+            break;
+    }
+
+    first_children[id] = first;
+    child_counts[id] = static_cast<std::uint32_t>(size()) - first;
+}
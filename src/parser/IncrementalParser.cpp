@@ -0,0 +1,190 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/parser/IncrementalParser.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "../../include/tokeniser/TokenStream.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+// Copies of nodes from after an edit, `delta` bytes further along
+
+TypedefDecl* shifted(Arena& arena, const TypedefDecl* decl, std::ptrdiff_t delta);
+ClassDecl* shifted(Arena& arena, const ClassDecl* decl, std::ptrdiff_t delta);
+MethodDecl* shifted(Arena& arena, const MethodDecl* decl, std::ptrdiff_t delta);
+FieldDecl* shifted(Arena& arena, const FieldDecl* decl, std::ptrdiff_t delta);
+
+template <typename T>
+ArenaSpan<T*> shifted(Arena& arena, const ArenaSpan<T*> decls, const std::ptrdiff_t delta) {
+    ArenaVector<T*> result{arena};
+    for (const T* decl : decls) result.push_back(decl ? shifted(arena, decl, delta) : nullptr);
+    return result.span();
+}
+
+TypedefDecl* shifted(Arena& arena, const TypedefDecl* decl, const std::ptrdiff_t delta) {
+    return arena.make<TypedefDecl>(decl->name, decl->modifiers, decl->referredType,
+        decl->typedefSourceRange.shiftedBy(delta), decl->nameSourceRange.shiftedBy(delta), decl->bodyRange.shiftedBy(delta));
+}
+
+ClassDecl* shifted(Arena& arena, const ClassDecl* decl, const std::ptrdiff_t delta) {
+    return arena.make<ClassDecl>(decl->name,
+        decl->classSourceRange.shiftedBy(delta), decl->nameSourceRange.shiftedBy(delta), decl->bodyRange.shiftedBy(delta),
+        decl->modifiers, decl->superClasses, shifted(arena, decl->fields, delta), shifted(arena, decl->methods, delta),
+        shifted(arena, decl->nestedClasses, delta));
+}
+
+MethodDecl* shifted(Arena& arena, const MethodDecl* decl, const std::ptrdiff_t delta) {
+    return arena.make<MethodDecl>(decl->name, decl->modifiers, decl->returnType, decl->parameters, decl->block,
+        decl->returnTypeSourceRange.shiftedBy(delta), decl->nameSourceRange.shiftedBy(delta), decl->bodyRange.shiftedBy(delta));
+}
+
+FieldDecl* shifted(Arena& arena, const FieldDecl* decl, const std::ptrdiff_t delta) {
+    return arena.make<FieldDecl>(decl->name, decl->modifiers, decl->type,
+        decl->typeSourceRange.shiftedBy(delta), decl->nameSourceRange.shiftedBy(delta), decl->bodyRange.shiftedBy(delta));
+}
+
+// The old declarations before `prefix`, the new ones, then the old ones from `suffix` on
+template <typename T>
+ArenaSpan<T*> splice(Arena& arena, const ArenaSpan<T*> old, const std::size_t prefix, ArenaVector<T*>& parsed, const std::size_t suffix, const std::ptrdiff_t delta) {
+    ArenaVector<T*> result{arena};
+    for (std::size_t i = 0; i < prefix; i++) result.push_back(old[i]);
+    for (T* decl : parsed) result.push_back(decl);
+    for (std::size_t i = suffix; i < old.size(); i++) result.push_back(delta == 0 || !old[i] ? old[i] : shifted(arena, old[i], delta));
+    return result.span();
+}
+
+}
+
+KahwaFile* IncrementalParser::parse(const std::string_view source) {
+    DiagnosticEngine lexer_engine;
+    current_tokens = Tokeniser{lexer_engine}.tokenise(file_start, source);
+    lexer_diagnostics = std::vector(lexer_engine.getAll());
+
+    std::vector<Diagnostic> diagnostics;
+    std::vector<Checkpoint> reached{Checkpoint{}};
+    Parser::Declarations decls{arena};
+    parseFrom(Checkpoint{}, decls, diagnostics, reached, [](const Checkpoint&) { return false; });
+    parser_diagnostics = std::move(diagnostics);
+    checkpoints = std::move(reached);
+
+    source_size = source.size();
+    auto* parsed = arena.make<KahwaFile>(decls.typedefDecls.span(), decls.classDecls.span(), decls.functionDecls.span(), decls.variableDecls.span());
+    file = parsed;
+    return parsed;
+}
+
+KahwaFile* IncrementalParser::reparse(const KahwaFile* previous, const std::string_view source, const TextEdit& edit) {
+    assert(previous == file);
+    assert(edit.offset + edit.removed <= source_size);
+    assert(source.size() == source_size - edit.removed + edit.inserted.size());
+    const std::ptrdiff_t delta = edit.delta();
+
+    const auto [first, last, count] = Tokeniser::relex(file_start, source, edit, current_tokens, lexer_diagnostics);
+    const std::ptrdiff_t token_delta = static_cast<std::ptrdiff_t>(count) - static_cast<std::ptrdiff_t>(last - first);
+
+    // Resume where neither the previous token nor anything the parse looked ahead at has changed. The parser
+    // never peeks further than a TokenStream's lookahead.
+    std::size_t restart = 0;
+    while (restart + 1 < checkpoints.size() && checkpoints[restart + 1].token + TokenStream::LOOKAHEAD <= first) restart++;
+
+    // Converged once the previous token is past the changed ones, at a boundary the old parse also stopped at
+    std::size_t converged = checkpoints.size();
+    Checkpoint joined{};
+    const auto isConverged = [&](const Checkpoint& checkpoint) {
+        if (checkpoint.token <= first + count) return false;
+        const auto old_token = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(checkpoint.token) - token_delta);
+        const auto it = std::ranges::lower_bound(checkpoints.begin() + static_cast<std::ptrdiff_t>(restart), checkpoints.end(), old_token, {}, &Checkpoint::token);
+        if (it == checkpoints.end() || it->token != old_token) return false;
+        converged = it - checkpoints.begin();
+        joined = checkpoint;
+        return true;
+    };
+
+    const Checkpoint start = checkpoints[restart];
+    std::vector<Diagnostic> window_diagnostics;
+    std::vector<Checkpoint> reached;
+    Parser::Declarations decls{arena};
+    const std::size_t reparsed = parseFrom(start, decls, window_diagnostics, reached, isConverged);
+
+    // The old parse from the converged checkpoint on, carried over with its counts moved to the new parse's
+    const Checkpoint end = converged < checkpoints.size() ? checkpoints[converged] : Checkpoint{
+        .token = current_tokens.size(),
+        .diagnostics = parser_diagnostics.size(),
+        .typedefs = file->typedefDecls.size(),
+        .classes = file->classDecls.size(),
+        .functions = file->functionDecls.size(),
+        .variables = file->variableDecls.size(),
+    };
+    for (std::size_t i = converged; i < checkpoints.size(); i++) {
+        Checkpoint& old = checkpoints[i];
+        old = {
+            .token = old.token - end.token + joined.token,
+            .diagnostics = old.diagnostics - end.diagnostics + joined.diagnostics,
+            .typedefs = old.typedefs - end.typedefs + joined.typedefs,
+            .classes = old.classes - end.classes + joined.classes,
+            .functions = old.functions - end.functions + joined.functions,
+            .variables = old.variables - end.variables + joined.variables,
+        };
+    }
+    const auto replaced = checkpoints.erase(checkpoints.begin() + static_cast<std::ptrdiff_t>(restart) + 1, checkpoints.begin() + static_cast<std::ptrdiff_t>(converged));
+    checkpoints.insert(replaced, reached.begin(), reached.end());
+
+    std::vector<Diagnostic> diagnostics;
+    diagnostics.reserve(start.diagnostics + window_diagnostics.size() + parser_diagnostics.size() - end.diagnostics);
+    for (std::size_t i = 0; i < start.diagnostics; i++) diagnostics.push_back(parser_diagnostics[i]);
+    for (const auto& diagnostic : window_diagnostics) diagnostics.push_back(diagnostic);
+    for (std::size_t i = end.diagnostics; i < parser_diagnostics.size(); i++) diagnostics.push_back(parser_diagnostics[i].shiftedBy(delta));
+
+    auto* parsed = arena.make<KahwaFile>(
+        splice(arena, file->typedefDecls, start.typedefs, decls.typedefDecls, end.typedefs, delta),
+        splice(arena, file->classDecls, start.classes, decls.classDecls, end.classes, delta),
+        splice(arena, file->functionDecls, start.functions, decls.functionDecls, end.functions, delta),
+        splice(arena, file->variableDecls, start.variables, decls.variableDecls, end.variables, delta));
+
+    const std::size_t total = parsed->typedefDecls.size() + parsed->classDecls.size() + parsed->functionDecls.size() + parsed->variableDecls.size();
+    const std::size_t window = decls.typedefDecls.size() + decls.classDecls.size() + decls.functionDecls.size() + decls.variableDecls.size();
+    last_stats = {.tokens_relexed = count, .declarations_reparsed = reparsed, .declarations_reused = total - window};
+
+    parser_diagnostics = std::move(diagnostics);
+    source_size = source.size();
+    file = parsed;
+    return parsed;
+}
+
+std::vector<Diagnostic> IncrementalParser::diagnostics() const {
+    std::vector<Diagnostic> all = lexer_diagnostics;
+    for (const auto& diagnostic : parser_diagnostics) all.push_back(diagnostic);
+    return all;
+}
+
+template <typename Converged>
+std::size_t IncrementalParser::parseFrom(const Checkpoint& start, Parser::Declarations& decls, std::vector<Diagnostic>& diagnostics, std::vector<Checkpoint>& reached, Converged&& converged) {
+    DiagnosticEngine parser_engine;
+    TokenStream stream{std::span<const Token>{current_tokens}.subspan(start.token)};
+    Parser::ParserWorker worker{stream, arena, types, parser_engine};
+    if (start.token > 0) worker.resumeAfter(current_tokens[start.token - 1]);
+
+    std::size_t parsed = 0;
+    while (!stream.atEnd()) {
+        worker.parseDeclaration(decls);
+        parsed++;
+        const Checkpoint checkpoint{
+            .token = start.token + stream.position(),
+            .diagnostics = start.diagnostics + parser_engine.count(),
+            .typedefs = start.typedefs + decls.typedefDecls.size(),
+            .classes = start.classes + decls.classDecls.size(),
+            .functions = start.functions + decls.functionDecls.size(),
+            .variables = start.variables + decls.variableDecls.size(),
+        };
+        if (converged(checkpoint)) break;
+        reached.push_back(checkpoint);
+    }
+
+    for (const auto& diagnostic : parser_engine.getAll()) diagnostics.push_back(diagnostic);
+    return parsed;
+}
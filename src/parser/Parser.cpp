@@ -7,203 +7,224 @@
 #include "../../include/parser/Modifier.h"
 
 KahwaFile *Parser::parseFile(const std::vector<Token> &tokens) const {
-    return ParserWorker(tokens, astArena, diagnostic_engine).parseFile();
+    TokenStream stream{tokens};
+    return parseFile(stream);
+}
+
+KahwaFile *Parser::parseFile(TokenStream &tokens) const {
+    return ParserWorker(tokens, astArena, types, diagnostic_engine).parseFile();
 }
 
 TypedefDecl *Parser::parseTypedef(const std::vector<Token> &tokens) const {
-    return ParserWorker(tokens, astArena, diagnostic_engine).parseTypedef();
+    TokenStream stream{tokens};
+    return ParserWorker(stream, astArena, types, diagnostic_engine).parseTypedef();
+}
+
+void Parser::parseDeclarations(const std::span<const Token> tokens, const std::size_t start, const std::size_t stop, Declarations &decls, std::vector<Boundary> &boundaries) const {
+    TokenStream stream{tokens.subspan(start)};
+    ParserWorker worker{stream, astArena, types, diagnostic_engine};
+    if (start > 0) worker.resumeAfter(tokens[start - 1]);
+
+    const auto boundary = [&] {
+        boundaries.push_back({
+            .token = start + stream.position(),
+            .diagnostics = diagnostic_engine.count(),
+            .typedefs = decls.typedefDecls.size(),
+            .classes = decls.classDecls.size(),
+            .functions = decls.functionDecls.size(),
+            .variables = decls.variableDecls.size(),
+        });
+    };
+    boundary();
+    while (!stream.atEnd() && start + stream.position() < stop) {
+        worker.parseDeclaration(decls);
+        boundary();
+    }
 }
 
 KahwaFile *Parser::ParserWorker::parseFile() {
-    std::vector<TypedefDecl*> typedefDecls;
-    std::vector<ClassDecl*> classDecls;
-    std::vector<MethodDecl*> functionDecls;
-    std::vector<FieldDecl*> variableDecls;
+    Declarations decls{astArena};
+    // Past the error limit the rest of the file is not worth parsing
+    while (!tokens.atEnd() && !diagnostic_engine.limitReached()) {
+        parseDeclaration(decls);
+    }
+
+    return astArena.make<KahwaFile>(decls.typedefDecls.span(), decls.classDecls.span(), decls.functionDecls.span(), decls.variableDecls.span());
+}
 
-    while (idx < tokens.size()) {
-        std::size_t save_idx = idx;
+void Parser::ParserWorker::parseDeclaration(Declarations &decls) {
+    const Token firstToken = *tokens.peek();
 
-        getModifierList();
+    // Modifiers are consumed once and handed to the declaration, the stream cannot rewind
+    auto modifiers = getModifierList();
+    if (tokens.atEnd()) return;
 
-        const Token& token = tokens[idx++];
+    const Token token = advance();
 
-        if (token.type == TokenType::TYPEDEF) {
-            idx = save_idx;
-            if (auto typedefDecl = parseTypedef()) {
-                typedefDecls.push_back(typedefDecl);
-            } else {
-                continue;
+    if (token.type == TokenType::TYPEDEF) {
+        if (auto typedefDecl = parseTypedef(modifiers, firstToken, token)) {
+            decls.typedefDecls.push_back(typedefDecl);
+            diagnostic_engine.endRecovery();
+        }
+    } else {
+        if (next_is(TokenType::CLASS)) {
+            // class-decl
+            if (ClassDecl *class_decl = parseClass(modifiers, token)) {
+                decls.classDecls.push_back(class_decl);
+                diagnostic_engine.endRecovery();
             }
         } else {
-            if (next_is(TokenType::CLASS)) {
-                // class-decl
-                idx = save_idx;
-                if (ClassDecl *class_decl = parseClass()) {
-                    classDecls.push_back(class_decl);
-                }
-            } else {
-                continue; // TODO
-                // variable-decl or function-decl
+            return; // TODO
+            // variable-decl or function-decl
 
-                idx = save_idx;
+            // TODO - Distinguish between the two first
 
-                // TODO - Distinguish between the two first
-
-                // TODO - But with recovery being file-level and not class-level
-                if (auto function = parseMethod()) {
-                    functionDecls.push_back(function);
-                }
-
-                continue;
-            }
-
-            // TODO - Insert a bad node
-            diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, SourceRange{token.source_range}, toMsg(DiagnosticKind::EXPECTED_DECLARATION));
+            // TODO - But with recovery being file-level and not class-level
         }
-    }
 
-    return astArena.make<KahwaFile>(typedefDecls, classDecls, functionDecls, variableDecls);
+        // TODO - Insert a bad node
+        diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, token.getSourceRange());
+        diagnostic_engine.beginRecovery();
+    }
 }
 
 TypedefDecl *Parser::ParserWorker::parseTypedef() {
-    // idx is pointing to token right after "typedef"
-    // Assuming no generics
+    if (tokens.atEnd()) {
+        expect(TokenType::TYPEDEF, SAFE_POINTS_FOR_FILE);
+        return nullptr;
+    }
 
-    const Token& firstToken = tokens[idx];
+    const Token firstToken = *tokens.peek();
 
     auto modifiers = getModifierList();
 
-    if (const auto nextTokens = expect(
-        std::vector{TokenType::TYPEDEF, TokenType::IDENTIFIER, TokenType::IDENTIFIER, TokenType::SEMI_COLON},
-        std::vector(4, isSafePointForFile)
-        )) {
-        auto* referredType = astArena.make<TypeRef>(*nextTokens.value()[1].getIf<std::string>());
-        return astArena.make<TypedefDecl>(
-            *nextTokens.value()[2].getIf<std::string>(),
-            modifiers,
-            referredType,
-            nextTokens.value()[0].source_range,
-            nextTokens.value()[1].source_range,
-            SourceRange{firstToken, nextTokens->back()});
+    if (const auto typedefToken = expect(TokenType::TYPEDEF, SAFE_POINTS_FOR_FILE)) {
+        return parseTypedef(modifiers, firstToken, *typedefToken);
     }
     return nullptr;
 }
 
-ClassDecl *Parser::ParserWorker::parseClass() {
-    std::vector<Modifier> modifiers = getModifierList();
-    std::vector<TypeRef*> superClasses;
-    std::vector<FieldDecl*> fields;
-    std::vector<MethodDecl*> methods;
-    std::vector<ClassDecl*> nestedClasses;
+TypedefDecl *Parser::ParserWorker::parseTypedef(const ArenaSpan<Modifier> modifiers, const Token &firstToken, const Token &typedefToken) {
+    // Assuming no generics
+    const auto typeToken = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_FILE);
+    if (!typeToken) return nullptr;
+    const auto nameToken = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_FILE);
+    if (!nameToken) return nullptr;
+    const auto semiColonToken = expect(TokenType::SEMI_COLON, SAFE_POINTS_FOR_FILE);
+    if (!semiColonToken) return nullptr;
+
+    auto* referredType = types.intern(*typeToken->getIf<Symbol>());
+    return astArena.make<TypedefDecl>(
+        *nameToken->getIf<Symbol>(),
+        modifiers,
+        referredType,
+        typedefToken.getSourceRange(),
+        typeToken->getSourceRange(),
+        SourceRange{firstToken, *semiColonToken});
+}
+
+ClassDecl *Parser::ParserWorker::parseClass(const ArenaSpan<Modifier> modifiers, const Token &classToken) {
+    ArenaVector<TypeRef*> superClasses{astArena};
+    ArenaVector<FieldDecl*> fields{astArena};
+    ArenaVector<MethodDecl*> methods{astArena};
+    ArenaVector<ClassDecl*> nestedClasses{astArena};
 
-    SourceRange classSourceRange = tokens[idx++].source_range;
+    SourceRange classSourceRange = classToken.getSourceRange();
 
-    auto nameToken = expect(TokenType::IDENTIFIER, isSafePointForFile);
+    auto nameToken = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_FILE);
     if (!nameToken) {
         return nullptr;
     }
 
-    std::string name = *nameToken->getIf<std::string>();
-    SourceRange nameSourceRange = nameToken->source_range;
+    Symbol name = *nameToken->getIf<Symbol>();
+    SourceRange nameSourceRange = nameToken->getSourceRange();
 
     // TODO - Parse optional super classes
 
-    if (!expect(TokenType::LEFT_CURLY_BRACE, isSafePointForFile)) {
+    if (!expect(TokenType::LEFT_CURLY_BRACE, SAFE_POINTS_FOR_FILE)) {
         return nullptr;
     }
 
     // Parse class body
 
-    while (!next_is(TokenType::RIGHT_CURLY_BRACE)) {
+    while (!tokens.atEnd() && !next_is(TokenType::RIGHT_CURLY_BRACE)) {
         // Process class-member
 
-        std::size_t save_idx = idx;
         getModifierList();
 
-        if (auto nextToken1 = expect(TokenType::IDENTIFIER, isSafePointForClass)) {
+        if (auto nextToken1 = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_CLASS)) {
             // Could be type of variable or return type of method or name of constructor
 
             if (next_is(TokenType::LEFT_PAREN)) {
                 // constructor
 
-                idx = save_idx;
-
                 // TODO
                 continue;
             }
 
-            if (auto nextToken2 = expect(TokenType::IDENTIFIER, isSafePointForClass)) {
+            if (auto nextToken2 = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_CLASS)) {
 
                 // left parenthesis -> method, otherwise field declaration
                 if (next_is(TokenType::LEFT_PAREN)) {
                     // method
 
-                    idx = save_idx;
-
                     // TODO
                     continue;
                 }
                 // field OR error TODO
 
-                idx = save_idx;
-
                 // TODO
             }
         }
     }
 
-    expect(TokenType::RIGHT_CURLY_BRACE, isSafePointForFile);
+    expect(TokenType::RIGHT_CURLY_BRACE, SAFE_POINTS_FOR_FILE);
 
-    const std::size_t file_id = nameToken->source_range.file_id;
     const std::size_t length = 1; // TODO
 
-    SourceRange bodyRange{file_id, classSourceRange.pos, length};
+    SourceRange bodyRange{classSourceRange.begin, length};
 
-    return astArena.make<ClassDecl>(name, classSourceRange, nameSourceRange, bodyRange, modifiers, superClasses, fields, methods, nestedClasses);
+    return astArena.make<ClassDecl>(name, classSourceRange, nameSourceRange, bodyRange, modifiers, superClasses.span(), fields.span(), methods.span(), nestedClasses.span());
 }
 
 MethodDecl *Parser::ParserWorker::parseMethod() {
-    const std::vector<Modifier>& modifiers = getModifierList();
-    assertTokenSequence(3, {TokenType::IDENTIFIER, TokenType::IDENTIFIER, TokenType::LEFT_PAREN});
+    const ArenaSpan<Modifier> modifiers = getModifierList();
+    assertTokenSequence({TokenType::IDENTIFIER, TokenType::IDENTIFIER, TokenType::LEFT_PAREN});
 
-    std::vector<std::pair<TypeRef*, std::string>> parameters;
+    ArenaVector<std::pair<TypeRef*, Symbol>> parameters{astArena};
     Block* block;
 
-    std::vector<Token> nextTokens = next(3);
+    const Token returnTypeToken = advance();
+    const Token nameToken = advance();
+    advance(); // "("
 
-    auto returnType = astArena.make<TypeRef>(*nextTokens[0].getIf<std::string>());
-    auto returnTypeSourceRange = nextTokens[0].source_range;
-    std::string name = *nextTokens[1].getIf<std::string>();
-    auto nameSourceRange = nextTokens[1].source_range;
-    idx += 3;
+    auto returnType = types.intern(*returnTypeToken.getIf<Symbol>());
+    auto returnTypeSourceRange = returnTypeToken.getSourceRange();
+    Symbol name = *nameToken.getIf<Symbol>();
+    auto nameSourceRange = nameToken.getSourceRange();
 
     while (next_is(TokenType::RIGHT_PAREN)) {
-        auto tokens = expect(
-            {TokenType::IDENTIFIER, TokenType::IDENTIFIER},
-            std::vector(3, isSafePointForClass));
-        if (!tokens) {
-            return nullptr;
-        }
-
-        auto paramType = astArena.make<TypeRef>(*tokens.value()[0].getIf<std::string>());
-        const std::string& paramName = *tokens.value()[1].getIf<std::string>();
+        const auto paramTypeToken = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_CLASS);
+        if (!paramTypeToken) return nullptr;
+        const auto paramNameToken = expect(TokenType::IDENTIFIER, SAFE_POINTS_FOR_CLASS);
+        if (!paramNameToken) return nullptr;
 
-        parameters.emplace_back(paramType, paramName);
+        parameters.emplace_back(types.intern(*paramTypeToken->getIf<Symbol>()), *paramNameToken->getIf<Symbol>());
     }
 
-    if (expect(TokenType::LEFT_CURLY_BRACE, isSafePointForClass)) {
-        idx--;
+    if (next_is(TokenType::LEFT_CURLY_BRACE)) {
         block = parseBlock();
         if (!block) {
             return nullptr;
         }
     } else {
+        expect(TokenType::LEFT_CURLY_BRACE, SAFE_POINTS_FOR_CLASS);
         return nullptr;
     }
 
-    SourceRange bodyRange{1, 1}; // TODO
+    SourceRange bodyRange{SourceLocation{1}, 1}; // TODO
 
-    return astArena.make<MethodDecl>(name, modifiers, returnType, parameters, block, returnTypeSourceRange, nameSourceRange, bodyRange);
+    return astArena.make<MethodDecl>(name, modifiers, returnType, parameters.span(), block, returnTypeSourceRange, nameSourceRange, bodyRange);
 }
 
 Block *Parser::ParserWorker::parseBlock() {
@@ -211,101 +232,71 @@ Block *Parser::ParserWorker::parseBlock() {
 }
 
 
-void Parser::ParserWorker::assertTokenSequence(const std::size_t count, const std::vector<TokenType> &expectedTypes) const {
-    std::vector<TokenType> actualTypes;
-    std::vector<Token> actualTokens = next(count);
-    std::ranges::transform(actualTokens, actualTypes.begin(), [](const Token& token){ return token.type; });
-
-    assert(actualTypes == expectedTypes);
-}
-
-bool Parser::ParserWorker::next_is(TokenType expected) const {
-    return next_is(std::vector{expected});
-}
-
-bool Parser::ParserWorker::next_is(const std::vector<TokenType> &expected) const {
-    std::vector<Token> nextTokens = next(expected.size());
-    std::vector<TokenType> nextTokenTypes{nextTokens.size()};
-    std::ranges::transform(nextTokens, nextTokenTypes.begin(), [](const Token& token){ return token.type; });
-    return nextTokenTypes == expected;
+void Parser::ParserWorker::assertTokenSequence(const std::initializer_list<TokenType> expectedTypes) {
+    std::size_t i = 0;
+    for (const TokenType expected : expectedTypes) {
+        [[maybe_unused]] const Token* token = tokens.peek(i++);
+        assert(token != nullptr && token->type == expected);
+    }
 }
 
-std::vector<Token> Parser::ParserWorker::next(const std::function<bool(const Token &)> &until) const {
-    return next(tokens.size(), until);
+bool Parser::ParserWorker::next_is(const TokenType expected) {
+    const Token* token = tokens.peek();
+    return token != nullptr && token->type == expected;
 }
 
-
-std::vector<Token> Parser::ParserWorker::next(std::size_t count, const std::function<bool(const Token &)> &until) const {
-    std::vector<Token> res;
-    std::size_t i = idx;
-    while (i < tokens.size() && count-- > 0) {
-        const Token& token = tokens[i++];
-        if (!until(token)) {
-            res.push_back(token);
-        } else {
-            break;
-        }
+bool Parser::ParserWorker::next_is(const std::initializer_list<TokenType> expected) {
+    std::size_t i = 0;
+    for (const TokenType type : expected) {
+        const Token* token = tokens.peek(i++);
+        if (token == nullptr || token->type != type) return false;
     }
-
-    return res;
+    return true;
 }
 
-Token Parser::ParserWorker::next() const {
-    return next(1)[0];
+Token Parser::ParserWorker::advance() {
+    previous = tokens.advance();
+    return *previous;
 }
 
-void Parser::ParserWorker::syncTo(const std::function<bool(const Token&)> &isSafePoint) {
-    idx += next([&isSafePoint](const Token& token) { return isSafePoint(token); }).size();
+void Parser::ParserWorker::syncTo(const TokenMask safePoints) {
+    for (const Token* token = tokens.peek(); token != nullptr && !safePoints.contains(token->type); token = tokens.peek()) {
+        advance();
+    }
 }
 
-std::optional<Token> Parser::ParserWorker::expect(const TokenType tokenType, const DiagnosticKind kind, const std::function<bool(const Token&)> &isSafePoint) {
-    const auto nextToken = next(1);
-    if (nextToken.size() == 1) {
-        if (nextToken[0].type == tokenType) {
-            return tokens[idx++];
-        }
+std::optional<Token> Parser::ParserWorker::expect(const TokenType tokenType, const DiagnosticKind kind, const TokenMask safePoints) {
+    if (next_is(tokenType)) {
+        return advance();
     }
 
-    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, kind, getPrevTokSourceRange(), toMsg(kind));
-    syncTo(isSafePoint);
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, kind, getPrevTokSourceRange());
+    diagnostic_engine.beginRecovery();
+    syncTo(safePoints);
     return std::nullopt;
 }
 
-std::optional<Token> Parser::ParserWorker::expect(TokenType tokenType, const std::function<bool(const Token &)> &isSafePoint) {
-    return expect(tokenType, expectedTokenTypeToDiagnosticKind(tokenType), isSafePoint);
-}
-
-
-std::optional<std::vector<Token>> Parser::ParserWorker::expect(const std::vector<TokenType>& tokenTypes, const std::vector<DiagnosticKind>& kinds, const std::vector<std::function<bool(const Token&)>>& isSafePoints) {
-    assert(tokenTypes.size() == kinds.size() && kinds.size() == isSafePoints.size());
-    std::vector<Token> res;
-    for (int i = 0; i < tokenTypes.size(); i++) {
-        if (auto tok = expect(tokenTypes[i], kinds[i], isSafePoints[i])) {
-            res.emplace_back(tok.value());
-        } else {
-            return std::nullopt;
-        }
+std::optional<Token> Parser::ParserWorker::expect(TokenType tokenType, const TokenMask safePoints) {
+    if (next_is(tokenType)) {
+        return advance();
     }
-    return res;
+    return expect(tokenType, expectedTokenTypeToDiagnosticKind(tokenType), safePoints);
 }
 
-std::optional<std::vector<Token>> Parser::ParserWorker::expect(const std::vector<TokenType> &tokenTypes, const std::vector<std::function<bool(const Token &)> > &isSafePoints) {
-    std::vector<DiagnosticKind> kinds{tokenTypes.size()};
-    std::ranges::transform(tokenTypes, kinds.begin(), [](const TokenType type){ return expectedTokenTypeToDiagnosticKind(type); });
-    return expect(tokenTypes, kinds, isSafePoints);
-}
 
-SourceRange Parser::ParserWorker::getPrevTokSourceRange() const {
-    return idx == 0 ? SourceRange{tokens.empty() ? -1 : tokens[0].source_range.file_id, 0} : tokens[idx - 1].source_range;
+SourceRange Parser::ParserWorker::getPrevTokSourceRange() {
+    if (previous) return previous->getSourceRange();
+    // Nothing consumed yet, so the problem is at the next token, if there is one
+    const Token* first = tokens.peek();
+    return first == nullptr ? SourceRange{SourceLocation{0}} : first->getSourceRange();
 }
 
-std::vector<Modifier> Parser::ParserWorker::getModifierList() {
-    std::vector<Token> modifierTokens = next([](const Token& tok){ return !MODIFIER_TYPES.contains(tok.type); });
-    idx += modifierTokens.size();
-
-    std::vector<Modifier> modifiers{modifierTokens.size()};
-    std::ranges::transform(modifierTokens, modifiers.begin(), [](const Token& token){ return tokenTypeToModifier(token.type); });
+ArenaSpan<Modifier> Parser::ParserWorker::getModifierList() {
+    ArenaVector<Modifier> modifiers{astArena};
+    for (const Token* token = tokens.peek(); token != nullptr && MODIFIER_TYPES.contains(token->type); token = tokens.peek()) {
+        modifiers.push_back(tokenTypeToModifier(advance().type));
+    }
 
-    return modifiers;
+    return modifiers.span();
 }
 
@@ -0,0 +1,51 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/parser/TypeTable.h"
+
+#include <algorithm>
+
+TypeRef* TypeTable::intern(const Symbol identifier, const std::span<TypeRef* const> args) {
+    total++;
+    // At most half full, so probing stays short
+    if (2 * (unique + 1) > capacity) grow();
+
+    const std::uint64_t hash = hashOf(identifier, args);
+    for (std::size_t i = hash & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+        Slot& slot = slots[i];
+        if (!slot.type) {
+            slot = {hash, arena.make<TypeRef>(identifier, ArenaSpan<TypeRef*>::copyOf(arena, args))};
+            unique++;
+            return slot.type;
+        }
+        if (slot.hash == hash && slot.type->identifier == identifier && std::ranges::equal(slot.type->args, args)) {
+            return slot.type;
+        }
+    }
+}
+
+void TypeTable::grow() {
+    // The old slots are left behind in the arena, as ArenaVector does with its buffers
+    const std::size_t new_capacity = capacity == 0 ? INITIAL_CAPACITY : capacity * 2;
+    auto* grown = static_cast<Slot*>(arena.allocate(sizeof(Slot) * new_capacity, alignof(Slot)));
+    std::fill_n(grown, new_capacity, Slot{0, nullptr});
+    for (std::size_t i = 0; i < capacity; i++) {
+        if (!slots[i].type) continue;
+        std::size_t j = slots[i].hash & (new_capacity - 1);
+        while (grown[j].type) j = (j + 1) & (new_capacity - 1);
+        grown[j] = slots[i];
+    }
+    slots = grown;
+    capacity = new_capacity;
+}
+
+std::uint64_t TypeTable::hashOf(const Symbol identifier, const std::span<TypeRef* const> args) {
+    // Arguments are interned, so their addresses stand for their structure
+    std::uint64_t hash = identifier.id;
+    for (const TypeRef* arg : args) {
+        hash = (hash ^ reinterpret_cast<std::uintptr_t>(arg)) * 0x9e3779b97f4a7c15;
+    }
+    hash *= 0xbf58476d1ce4e5b9;
+    return hash ^ (hash >> 31);
+}
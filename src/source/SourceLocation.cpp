@@ -5,6 +5,6 @@
 #include "../../include/source/SourceLocation.h"
 #include "../../include/source/SourceRange.h"
 
-SourceLocation SourceLocation::getEndOf(SourceRange source_range) {
-    return SourceLocation{source_range.file_id, source_range.pos + source_range.length};
-}
\ No newline at end of file
+SourceLocation SourceLocation::getEndOf(const SourceRange source_range) {
+    return source_range.end;
+}
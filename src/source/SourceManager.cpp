@@ -3,24 +3,182 @@
 //
 
 #include "../../include/source/SourceManager.h"
+#include "../../include/tokeniser/Scanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::filesystem::filesystem_error errnoError(const char* what, const std::filesystem::path& path) {
+    return std::filesystem::filesystem_error{what, path, std::error_code{errno, std::generic_category()}};
+}
+
+// Closes the descriptor on every path out of addFile
+struct FileDescriptor {
+    int fd;
+    ~FileDescriptor() { if (fd > STDIN_FILENO) close(fd); }
+};
+
+}
+
+SourceManager::~SourceManager() {
+    for (const auto& [data, size] : mappings) {
+        munmap(data, size);
+    }
+}
 
 std::size_t SourceManager::addFile(const std::filesystem::path &path) {
+    if (path == "-") {
+        if (const auto it = ids_by_path.find("-"); it != ids_by_path.end()) {
+            return it->second;
+        }
+        return addContents(path, readAll(STDIN_FILENO, path, 0));
+    }
+
     auto canonical_path = std::filesystem::canonical(path);
-    if (const auto it = std::ranges::find_if(source_files, [canonical_path](const SourceFile& file) { return file.path == canonical_path; }); it != source_files.end()) {
-        return std::distance(source_files.begin(), it);
+    if (const auto it = ids_by_path.find(canonical_path.string()); it != ids_by_path.end()) {
+        return it->second;
     }
 
-    std::ifstream in(canonical_path);
-    std::string contents{std::istreambuf_iterator(in), std::istreambuf_iterator<char>()};
+    const FileDescriptor file{open(canonical_path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file.fd < 0) throw errnoError("cannot open source file", canonical_path);
 
-    std::size_t id = source_files.size();
-    source_files.emplace_back(canonical_path, contents);
+    struct stat info{};
+    if (fstat(file.fd, &info) != 0) throw errnoError("cannot stat source file", canonical_path);
 
-    return id;
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (!S_ISREG(info.st_mode) || size < MMAP_THRESHOLD) {
+        return addContents(canonical_path, readAll(file.fd, canonical_path, size));
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+    if (data == MAP_FAILED) throw errnoError("cannot map source file", canonical_path);
+    mappings.push_back({data, size});
+
+    return addContents(canonical_path, std::string_view{static_cast<const char*>(data), size});
 }
 
-const std::string &SourceManager::getSource(const std::size_t file_id) const {
+std::string_view SourceManager::getSource(const std::size_t file_id) const {
     assert(file_id < source_files.size());
     return source_files[file_id].contents;
 }
 
+const std::filesystem::path &SourceManager::getPath(const std::size_t file_id) const {
+    assert(file_id < source_files.size());
+    return source_files[file_id].path;
+}
+
+SourceLocation SourceManager::getFileStart(const std::size_t file_id) const {
+    assert(file_id < file_starts.size());
+    return SourceLocation{file_starts[file_id]};
+}
+
+SourceLocation SourceManager::getLocation(const std::size_t file_id, const std::size_t pos) const {
+    assert(pos <= getSource(file_id).length());
+    return SourceLocation{file_starts[file_id] + pos};
+}
+
+std::size_t SourceManager::getFileId(const SourceLocation location) const {
+    assert(location.offset < end_offset);
+
+    // The last file starting at or before the location
+    const auto it = std::ranges::upper_bound(file_starts, location.offset) - 1;
+    return it - file_starts.begin();
+}
+
+std::size_t SourceManager::getFileOffset(const SourceLocation location) const {
+    return location.offset - file_starts[getFileId(location)];
+}
+
+LineColumn SourceManager::getLineColumn(const SourceLocation location) const {
+    const std::size_t file_id = getFileId(location);
+    const std::size_t pos = location.offset - file_starts[file_id];
+    const auto& starts = lineStarts(file_id);
+
+    // The last line starting at or before `pos`
+    const auto it = std::ranges::upper_bound(starts, pos) - 1;
+    return {static_cast<std::size_t>(it - starts.begin()) + 1, pos - *it + 1};
+}
+
+std::string_view SourceManager::getLineText(const std::size_t file_id, const std::size_t line) const {
+    const auto& starts = lineStarts(file_id);
+    assert(line >= 1 && line <= starts.size());
+
+    const std::string_view source = getSource(file_id);
+    const std::size_t start = starts[line - 1];
+    std::size_t end = line < starts.size() ? starts[line] - 1 : source.length();
+    if (end > start && source[end - 1] == '\r') end--;
+    return source.substr(start, end - start);
+}
+
+std::size_t SourceManager::lineCount(const std::size_t file_id) const {
+    return lineStarts(file_id).size();
+}
+
+const std::vector<std::uint32_t> &SourceManager::lineStarts(const std::size_t file_id) const {
+    assert(file_id < line_tables.size());
+    LineTable& table = *line_tables[file_id];
+    std::call_once(table.built, [&] {
+        const std::string_view source = getSource(file_id);
+        table.starts.push_back(0);
+        for (std::size_t pos = Scanner::findNewline(source, 0); pos < source.length(); pos = Scanner::findNewline(source, pos + 1)) {
+            table.starts.push_back(static_cast<std::uint32_t>(pos + 1));
+        }
+    });
+    return table.starts;
+}
+
+std::size_t SourceManager::addContents(const std::filesystem::path &path, const std::string_view contents) {
+    const std::size_t next_start = nextFileStart(end_offset, contents.length());
+    if (next_start - 1 > UINT32_MAX) {
+        throw std::length_error("source files exceed the 32-bit location space at " + path.string());
+    }
+
+    const std::size_t id = source_files.size();
+    source_files.emplace_back(path, contents);
+    file_starts.push_back(static_cast<std::uint32_t>(end_offset));
+    end_offset = next_start;
+    line_tables.push_back(std::make_unique<LineTable>());
+    ids_by_path.emplace(path.string(), id);
+    return id;
+}
+
+std::string_view SourceManager::readAll(const int fd, const std::filesystem::path &path, const std::size_t size_hint) {
+    // Regular files are read straight into a buffer of the size fstat reported. Anything else, or a file
+    // that grew in the meantime, goes through a growing string first.
+    auto* buffer = static_cast<char*>(buffers.allocate(size_hint, 1));
+    std::size_t size = 0;
+    std::string overflow;
+    char chunk[64 * 1024];
+    while (true) {
+        const bool into_buffer = size < size_hint;
+        const ssize_t n = into_buffer ? read(fd, buffer + size, size_hint - size) : read(fd, chunk, sizeof(chunk));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw errnoError("cannot read source file", path);
+        }
+        if (into_buffer) {
+            size += static_cast<std::size_t>(n);
+        } else {
+            overflow.append(chunk, static_cast<std::size_t>(n));
+        }
+    }
+
+    if (overflow.empty()) {
+        return std::string_view{buffer, size};
+    }
+    auto* grown = static_cast<char*>(buffers.allocate(size + overflow.size(), 1));
+    std::memcpy(grown, buffer, size);
+    std::memcpy(grown + size, overflow.data(), overflow.size());
+    return std::string_view{grown, size + overflow.size()};
+}
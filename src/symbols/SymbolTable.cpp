@@ -0,0 +1,114 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/symbols/SymbolTable.h"
+
+#include <mutex>
+#include <stdexcept>
+
+Symbol Symbol::intern(const std::string_view str) {
+    return SymbolTable::global().intern(str);
+}
+
+const std::string &Symbol::str() const {
+    return SymbolTable::global().get(*this);
+}
+
+SymbolTable::SymbolTable() {
+    slots.resize(1024, Slot{0, EMPTY});
+    for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+        if (isKeywordSpelling(spelling)) {
+            intern(spelling);
+            keywords.push_back(type);
+        }
+    }
+}
+
+SymbolTable::~SymbolTable() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+SymbolTable &SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol SymbolTable::intern(const std::string_view str) {
+    const std::uint32_t hash = hashOf(str);
+    {
+        std::shared_lock lock(mutex);
+        if (const auto symbol = findLocked(str, hash)) return *symbol;
+    }
+
+    std::unique_lock lock(mutex);
+    // Another thread may have inserted it between the two locks
+    if (const auto symbol = findLocked(str, hash)) return *symbol;
+    return insertLocked(str, hash);
+}
+
+std::optional<Symbol> SymbolTable::find(const std::string_view str) const {
+    std::shared_lock lock(mutex);
+    return findLocked(str, hashOf(str));
+}
+
+std::size_t SymbolTable::memoryUsage() const {
+    std::shared_lock lock(mutex);
+    std::size_t bytes = slots.capacity() * sizeof(Slot);
+    const std::size_t n = count.load(std::memory_order_relaxed);
+    bytes += ((n + CHUNK_SIZE - 1) / CHUNK_SIZE) * CHUNK_SIZE * sizeof(std::string);
+    for (std::uint32_t id = 0; id < n; id++) {
+        const std::string& str = get(Symbol{id});
+        if (str.capacity() > std::string{}.capacity()) bytes += str.capacity() + 1;
+    }
+    return bytes;
+}
+
+std::optional<Symbol> SymbolTable::findLocked(const std::string_view str, const std::uint32_t hash) const {
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.id == EMPTY) return std::nullopt;
+        if (slot.hash == hash && get(Symbol{slot.id}) == str) return Symbol{slot.id};
+    }
+}
+
+Symbol SymbolTable::insertLocked(const std::string_view str, const std::uint32_t hash) {
+    const std::uint32_t id = count.load(std::memory_order_relaxed);
+    if (id >= MAX_CHUNKS * CHUNK_SIZE) {
+        throw std::length_error("Symbol table is full.");
+    }
+
+    std::string* chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new std::string[CHUNK_SIZE];
+        chunks[id >> CHUNK_BITS].store(chunk, std::memory_order_release);
+    }
+    chunk[id & (CHUNK_SIZE - 1)] = str;
+    count.store(id + 1, std::memory_order_release);
+
+    // Keep the load factor at or below 1/2
+    if ((id + 1) * 2 > slots.size()) grow();
+
+    const std::size_t mask = slots.size() - 1;
+    std::size_t i = hash & mask;
+    while (slots[i].id != EMPTY) i = (i + 1) & mask;
+    slots[i] = Slot{hash, id};
+
+    return Symbol{id};
+}
+
+void SymbolTable::grow() {
+    std::vector<Slot> old = std::move(slots);
+    slots.assign(old.size() * 2, Slot{0, EMPTY});
+
+    const std::size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == EMPTY) continue;
+        std::size_t i = slot.hash & mask;
+        while (slots[i].id != EMPTY) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
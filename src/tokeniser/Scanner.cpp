@@ -0,0 +1,221 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include "../../include/tokeniser/Scanner.h"
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KAHWA_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f';
+}
+
+bool isIdentifierChar(const char c) {
+    const char lower = static_cast<char>(c | 0x20);
+    return (lower >= 'a' && lower <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Scalar implementation, also used for the tails of the vector implementations
+
+const char* scalarSkipWhitespace(const char* p, const char* end) {
+    while (p < end && isWhitespace(*p)) p++;
+    return p;
+}
+
+const char* scalarFindNewline(const char* p, const char* end) {
+    while (p < end && *p != '\n') p++;
+    return p;
+}
+
+const char* scalarFindCommentEnd(const char* p, const char* end) {
+    for (; p + 1 < end; p++) {
+        if (p[0] == '*' && p[1] == '/') return p;
+    }
+    return end;
+}
+
+const char* scalarFindQuote(const char* p, const char* end) {
+    while (p < end && *p != '"') p++;
+    return p;
+}
+
+const char* scalarSkipIdentifierChars(const char* p, const char* end) {
+    while (p < end && isIdentifierChar(*p)) p++;
+    return p;
+}
+
+const char* scalarSkipDigits(const char* p, const char* end) {
+    while (p < end && isDigit(*p)) p++;
+    return p;
+}
+
+constexpr Scanner::Functions SCALAR{
+    scalarSkipWhitespace,
+    scalarFindNewline,
+    scalarFindCommentEnd,
+    scalarFindQuote,
+    scalarSkipIdentifierChars,
+    scalarSkipDigits,
+};
+
+#ifdef KAHWA_SCANNER_X86
+
+// Classifiers take a pointer to a block of 16 (SSE2) or 32 (AVX2) bytes and return a mask with a bit set
+// for every byte at which the run stops. Only scalars cross their boundaries, so the AVX2 ones can be
+// called from code compiled without AVX. Signed byte comparisons are fine for the ASCII ranges tested,
+// bytes >= 0x80 compare as negative and fall outside every range.
+
+#define KAHWA_AVX2 __attribute__((target("avx2")))
+
+std::uint32_t sse2NonWhitespace(const char* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i ws = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                     _mm_cmpeq_epi8(v, _mm_set1_epi8('\f'))));
+    return ~static_cast<std::uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFF;
+}
+
+template <char C>
+std::uint32_t sse2Char(const char* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(C))));
+}
+
+std::uint32_t sse2CommentEnd(const char* p) {
+    const __m128i star = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('*'));
+    const __m128i slash = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), _mm_set1_epi8('/'));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(star, slash)));
+}
+
+__m128i sse2InRange(const __m128i v, const char lo, const char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))), _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+std::uint32_t sse2NonIdentifier(const char* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i alpha = sse2InRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+    const __m128i ident = _mm_or_si128(_mm_or_si128(alpha, sse2InRange(v, '0', '9')), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+    return ~static_cast<std::uint32_t>(_mm_movemask_epi8(ident)) & 0xFFFF;
+}
+
+std::uint32_t sse2NonDigit(const char* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return ~static_cast<std::uint32_t>(_mm_movemask_epi8(sse2InRange(v, '0', '9'))) & 0xFFFF;
+}
+
+KAHWA_AVX2 std::uint32_t avx2NonWhitespace(const char* p) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i ws = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+                        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\f'))));
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ws));
+}
+
+template <char C>
+KAHWA_AVX2 std::uint32_t avx2Char(const char* p) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(C))));
+}
+
+KAHWA_AVX2 std::uint32_t avx2CommentEnd(const char* p) {
+    const __m256i star = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), _mm256_set1_epi8('*'));
+    const __m256i slash = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)), _mm256_set1_epi8('/'));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(star, slash)));
+}
+
+KAHWA_AVX2 __m256i avx2InRange(const __m256i v, const char lo, const char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))), _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+KAHWA_AVX2 std::uint32_t avx2NonIdentifier(const char* p) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i alpha = avx2InRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+    const __m256i ident = _mm256_or_si256(_mm256_or_si256(alpha, avx2InRange(v, '0', '9')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ident));
+}
+
+KAHWA_AVX2 std::uint32_t avx2NonDigit(const char* p) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(avx2InRange(v, '0', '9')));
+}
+
+// `Extra` is how many bytes past the block the classifier reads
+template <std::size_t Width, std::size_t Extra, std::uint32_t (*Stops)(const char*), const char* (*Tail)(const char*, const char*)>
+const char* scan(const char* p, const char* end) {
+    while (static_cast<std::size_t>(end - p) >= Width + Extra) {
+        if (const std::uint32_t stops = Stops(p)) {
+            return p + std::countr_zero(stops);
+        }
+        p += Width;
+    }
+    return Tail(p, end);
+}
+
+// Compiled for AVX2 and flattened so the classifier is inlined into the loop
+template <std::size_t Extra, std::uint32_t (*Stops)(const char*), const char* (*Tail)(const char*, const char*)>
+KAHWA_AVX2 __attribute__((flatten)) const char* scanAvx2(const char* p, const char* end) {
+    return scan<32, Extra, Stops, Tail>(p, end);
+}
+
+constexpr Scanner::Functions SSE2{
+    scan<16, 0, sse2NonWhitespace, scalarSkipWhitespace>,
+    scan<16, 0, sse2Char<'\n'>, scalarFindNewline>,
+    scan<16, 1, sse2CommentEnd, scalarFindCommentEnd>,
+    scan<16, 0, sse2Char<'"'>, scalarFindQuote>,
+    scan<16, 0, sse2NonIdentifier, scalarSkipIdentifierChars>,
+    scan<16, 0, sse2NonDigit, scalarSkipDigits>,
+};
+
+constexpr Scanner::Functions AVX2{
+    scanAvx2<0, avx2NonWhitespace, scalarSkipWhitespace>,
+    scanAvx2<0, avx2Char<'\n'>, scalarFindNewline>,
+    scanAvx2<1, avx2CommentEnd, scalarFindCommentEnd>,
+    scanAvx2<0, avx2Char<'"'>, scalarFindQuote>,
+    scanAvx2<0, avx2NonIdentifier, scalarSkipIdentifierChars>,
+    scanAvx2<0, avx2NonDigit, scalarSkipDigits>,
+};
+
+#endif
+
+}
+
+Scanner::Level Scanner::bestLevel() {
+#ifdef KAHWA_SCANNER_X86
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    return Level::SSE2;
+#else
+    return Level::SCALAR;
+#endif
+}
+
+bool Scanner::isSupported(const Level level) {
+    return static_cast<int>(level) <= static_cast<int>(bestLevel());
+}
+
+const Scanner::Functions &Scanner::functionsFor(const Level level) {
+    if (!isSupported(level)) {
+        throw std::invalid_argument("Scanner level is not supported on this CPU.");
+    }
+    switch (level) {
+#ifdef KAHWA_SCANNER_X86
+        case Level::AVX2: return AVX2;
+        case Level::SSE2: return SSE2;
+#endif
+        default: return SCALAR;
+    }
+}
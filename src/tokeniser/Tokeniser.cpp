@@ -3,307 +3,196 @@
 //
 
 #include "../../include/tokeniser/Tokeniser.h"
+#include "../../include/tokeniser/LexerTables.h"
+#include "../../include/tokeniser/Scanner.h"
+#include "../../include/tokeniser/TokenStream.h"
 
+#include <algorithm>
 #include <cassert>
 
-std::vector<Token> Tokeniser::TokeniserWorker::tokenise() {
-    while (idx < str.length()) {
+std::vector<Token> Tokeniser::tokenise(const SourceLocation file_start, const std::string_view str) const {
+    std::vector<Token> tokens;
+    TokenStream token_stream = stream(file_start, str);
+    while (!token_stream.atEnd() && !diagnostic_engine.limitReached()) {
+        tokens.push_back(token_stream.advance());
+    }
+    return tokens;
+}
+
+TokenStream Tokeniser::stream(const SourceLocation file_start, const std::string_view str) const {
+    return TokenStream{file_start, str, diagnostic_engine};
+}
+
+Tokeniser::Relexed Tokeniser::relex(const SourceLocation file_start, const std::string_view str, const TextEdit& edit, std::vector<Token>& tokens, std::vector<Diagnostic>& diagnostics) {
+    const auto relative = [&](const SourceLocation location) -> std::size_t { return location.offset - file_start.offset; };
+    const std::ptrdiff_t delta = edit.delta();
+
+    // Lexing restarts after the last token whose lexing could not have seen the edit. Between tokens the lexer
+    // has no state, so the comments and strings after that token are lexed again from their start.
+    const auto first_it = std::ranges::partition_point(tokens, [&](const Token& token) {
+        return relative(token.getSourceRange().end) + LOOKAHEAD <= edit.offset;
+    });
+    const std::size_t first = first_it - tokens.begin();
+    const std::size_t restart = first == 0 ? 0 : relative(tokens[first - 1].getSourceRange().end);
+    const std::size_t edit_end = edit.offset + edit.inserted.size();
+
+    DiagnosticEngine engine;
+    TokeniserWorker lexer{SourceLocation{file_start.offset + restart}, str.substr(restart), engine};
+    std::vector<Token> lexed;
+    std::size_t last = tokens.size();
+    std::size_t lexed_end = SIZE_MAX; // where the new tokens give way to the old ones, in the new text
+    while (const auto token = lexer.lexToken()) {
+        const std::size_t begin = relative(token->getSourceRange().begin);
+        if (begin >= edit_end) {
+            // Past the edit the text is unchanged, and a token only depends on the text from where it starts.
+            // If the old lexing started the same token at the same place, everything after is the same too.
+            const auto old_begin = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(begin) - delta);
+            const auto it = std::ranges::partition_point(first_it, tokens.end(), [&](const Token& old) {
+                return relative(old.getSourceRange().begin) < old_begin;
+            });
+            if (it != tokens.end() && relative(it->getSourceRange().begin) == old_begin &&
+                it->type == token->type && it->getSourceRange().length() == token->getSourceRange().length()) {
+                last = it - tokens.begin();
+                lexed_end = begin;
+                break;
+            }
+        }
+        lexed.push_back(*token);
+    }
+
+    const std::size_t resync = last < tokens.size() ? relative(tokens[last].getSourceRange().begin) : SIZE_MAX;
+    std::vector<Diagnostic> spliced;
+    for (const auto& diagnostic : diagnostics) {
+        if (relative(diagnostic.source_range.begin) < restart) spliced.push_back(diagnostic);
+    }
+    // Lexing the token it resynchronised on may have reported a problem the old diagnostics already have
+    for (const auto& diagnostic : engine.getAll()) {
+        if (relative(diagnostic.source_range.begin) < lexed_end) spliced.push_back(diagnostic);
+    }
+    for (const auto& diagnostic : diagnostics) {
+        if (relative(diagnostic.source_range.begin) >= resync) spliced.push_back(diagnostic.shiftedBy(delta));
+    }
+    diagnostics = std::move(spliced);
+
+    // Only the suffix moves, the tokens before the edit stay where they are
+    const auto replaced = tokens.erase(first_it, tokens.begin() + static_cast<std::ptrdiff_t>(last));
+    const auto suffix = tokens.insert(replaced, lexed.begin(), lexed.end()) + static_cast<std::ptrdiff_t>(lexed.size());
+    if (delta != 0) {
+        for (auto it = suffix; it != tokens.end(); ++it) it->shiftBy(delta);
+    }
+
+    return {first, last, lexed.size()};
+}
+
+std::optional<Token> Tokeniser::TokeniserWorker::lexToken() {
+    std::optional<Token> token;
+    while (!token && idx < str.length()) {
+        idx = Scanner::skipWhitespace(str, idx);
+        if (idx == str.length()) break;
+
         const std::size_t curr_idx = idx;
         char c = str[idx++];
-        if (DELIMITERS.contains(c)) continue;
+
+        if (c == '/' && (next_is('/') || next_is('*'))) {
+            if (next_is('/')) {
+                idx = Scanner::findNewline(str, idx + 1);
+            } else {
+                // An unterminated block comment runs to the end of the file
+                const std::size_t comment_end = Scanner::findCommentEnd(str, idx + 1);
+                idx = comment_end == str.length() ? comment_end : comment_end + 2;
+            }
+            continue;
+        }
+
+        if (const OperatorMatch match = matchOperator(str, curr_idx); match.length > 0) {
+            token.emplace(match.type, rangeAt(curr_idx, match.length));
+            idx = curr_idx + match.length;
+            continue;
+        }
 
         switch (c) {
-            case ':' :
-                tokens.emplace_back(TokenType::COLON, SourceRange{file_id, curr_idx});
-                break;
-            case ';' :
-                tokens.emplace_back(TokenType::SEMI_COLON, SourceRange{file_id, curr_idx});
-                break;
-            case ',' :
-                tokens.emplace_back(TokenType::COMMA, SourceRange{file_id, curr_idx});
-                break;
-            case '{' :
-                tokens.emplace_back(TokenType::LEFT_CURLY_BRACE, SourceRange{file_id, curr_idx});
-                break;
-            case '}' :
-                tokens.emplace_back(TokenType::RIGHT_CURLY_BRACE, SourceRange{file_id, curr_idx});
-                break;
-            case '(' :
-                tokens.emplace_back(TokenType::LEFT_PAREN, SourceRange{file_id, curr_idx});
-                break;
-            case ')' :
-                tokens.emplace_back(TokenType::RIGHT_PAREN, SourceRange{file_id, curr_idx});
-                break;
-            case '[' :
-                tokens.emplace_back(TokenType::LEFT_BRACKET, SourceRange{file_id, curr_idx});
-                break;
-            case ']' :
-                tokens.emplace_back(TokenType::RIGHT_BRACKET, SourceRange{file_id, curr_idx});
-                break;
-            case '=' :
-                if (next_is("=")) {
-                    tokens.emplace_back(TokenType::DOUBLE_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::EQUALS, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '<' :
-                if (next_is("<=")) {
-                    tokens.emplace_back(TokenType::LEFT_SHIFT_EQUALS, SourceRange{file_id, curr_idx, 3});
-                    idx += 2;
-                } else if (next_is("<")) {
-                    tokens.emplace_back(TokenType::LEFT_SHIFT, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::LESS_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::LESS, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '>' :
-                if (next_is(">=")) {
-                    tokens.emplace_back(TokenType::RIGHT_SHIFT_EQUALS, SourceRange{file_id, curr_idx, 3});
-                    idx += 2;
-                } else if (next_is(">")) {
-                    tokens.emplace_back(TokenType::RIGHT_SHIFT, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::GREATER_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::GREATER, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '!' :
-                if (next_is("=")) {
-                    tokens.emplace_back(TokenType::NOT_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::NOT, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '+' :
-                if (next_is("+")) {
-                    tokens.emplace_back(TokenType::INCREMENT, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::PLUS_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::PLUS, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '-' :
-                if (next_is("-")) {
-                    tokens.emplace_back(TokenType::DECREMENT, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::MINUS_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::MINUS, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '*' :
-                if (next_is("=")) {
-                    tokens.emplace_back(TokenType::STAR_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::STAR, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '/' :
-                if (next_is("/")) {
-                    idx++;
-                    // `idx < str.length()` to avoid infinite looping
-                    while (idx < str.length() && !next_is("\n")) { idx++; }
-                } else if (next_is("*")) {
-                    idx++;
-                    // `idx < str.length()` to avoid infinite looping
-                    while (idx < str.length()) {
-                        if (next_is("*/")) {
-                            idx += 2;
-                            break;
-                        }
-                        idx++;
-                    }
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::SLASH_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::SLASH, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '%' :
-                if (next_is("=")) {
-                    tokens.emplace_back(TokenType::MODULO_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::MODULO, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '&' :
-                if (next_is("&")) {
-                    tokens.emplace_back(TokenType::LOGICAL_AND, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::BITWISE_AND_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::BITWISE_AND, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '|' :
-                if (next_is("|")) {
-                    tokens.emplace_back(TokenType::LOGICAL_OR, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else if (next_is("=")) {
-                    tokens.emplace_back(TokenType::BITWISE_OR_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::BITWISE_OR, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '^' :
-                if (next_is("=")) {
-                    tokens.emplace_back(TokenType::BITWISE_XOR_EQUALS, SourceRange{file_id, curr_idx, 2});
-                    idx++;
-                } else {
-                    tokens.emplace_back(TokenType::BITWISE_XOR, SourceRange{file_id, curr_idx});
-                }
-                break;
-            case '?' :
-                tokens.emplace_back(TokenType::QUESTION, SourceRange{file_id, curr_idx});
-                break;
-            case '.' :
-                tokens.emplace_back(TokenType::DOT, SourceRange{file_id, curr_idx});
-                break;
             case '\"': {
                 if (auto maybeToken = tokeniseString(curr_idx)) {
-                    tokens.push_back(maybeToken.value());
+                    token = maybeToken;
                 } else {
-                    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceLocation{file_id, curr_idx}, toMsg(DiagnosticKind::UNTERMINATED_STRING_LITERAL));
-                    return tokens;
+                    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, rangeAt(curr_idx));
+                    idx = str.length();
+                    return std::nullopt;
                 }
                 break;
             }
             default:
                 if (std::isdigit(c)) {
                     idx--;
-                    std::string num_string_1 = getNumberString(curr_idx);
-                    if (next_is(".")) {
+                    const std::string_view num_string_1 = getNumberString();
+                    if (next_is('.')) {
                         idx++;
-                        std::string num_string_2 = getNumberString(curr_idx);
+                        const std::string_view num_string_2 = getNumberString();
                         if (num_string_2.empty()) {
-                            int num = std::stoi(num_string_1);
-                            tokens.emplace_back(TokenType::INTEGER, num, SourceRange{file_id, curr_idx, num_string_1.length()});
+                            int num = std::stoi(std::string{num_string_1});
+                            token.emplace(TokenType::INTEGER, num, rangeAt(curr_idx, num_string_1.length()));
                             idx--;
                         } else {
-                            std::string s = num_string_1;
-                            s.append(".");
-                            s.append(num_string_2);
-                            float num = std::stof(s);
+                            // Both halves and the '.' are contiguous in the source
+                            const std::string_view s = str.substr(curr_idx, idx - curr_idx);
+                            float num = std::stof(std::string{s});
 
-                            tokens.emplace_back(TokenType::FLOAT, num, SourceRange{file_id, curr_idx, s.length()});
+                            token.emplace(TokenType::FLOAT, num, rangeAt(curr_idx, s.length()));
                         }
                     } else {
-                        int num = std::stoi(num_string_1);
-                        tokens.emplace_back(TokenType::INTEGER, num, SourceRange{file_id, curr_idx, num_string_1.length()});
+                        int num = std::stoi(std::string{num_string_1});
+                        token.emplace(TokenType::INTEGER, num, rangeAt(curr_idx, num_string_1.length()));
                     }
                 } else if (std::isalpha(c) || c == '_') {
                     idx--;
-                    std::string identifier_like = extractIdentifierLike();
-                    if (TOKEN_MAP.contains(identifier_like)) {
-                        tokens.emplace_back(TOKEN_MAP.at(identifier_like), SourceRange{file_id, curr_idx, identifier_like.length()});
+                    const std::string_view identifier_like = extractIdentifierLike();
+                    if (const auto keyword = matchKeyword(identifier_like)) {
+                        token.emplace(*keyword, rangeAt(curr_idx, identifier_like.length()));
                     } else {
-                        tokens.emplace_back(TokenType::IDENTIFIER, identifier_like, SourceRange{file_id, curr_idx, identifier_like.length()});
+                        token.emplace(TokenType::IDENTIFIER, symbols.intern(identifier_like), tokenRangeAt(curr_idx, identifier_like.length()));
                     }
                 } else {
-                    tokens.emplace_back(TokenType::BAD, std::to_string(c), SourceRange{file_id, curr_idx});
-                    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{file_id, curr_idx}, toMsg(DiagnosticKind::UNRECOGNISED_TOKEN));
+                    token.emplace(TokenType::BAD, std::to_string(c), rangeAt(curr_idx));
+                    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, rangeAt(curr_idx));
                 }
         }
     }
 
-    return tokens;
+    return token;
 }
 
 
 std::optional<Token> Tokeniser::TokeniserWorker::tokeniseString(std::size_t curr_idx) {
-    std::string s;
-    while (idx < str.length()) {
-        char c = str[idx++];
-        if (c == '\"') {
-            return Token{TokenType::STRING_LITERAL, s, SourceRange{file_id, curr_idx, s.length() + 2}};
-        }
-        s += c;
+    const std::size_t closing_quote = Scanner::findQuote(str, idx);
+    if (closing_quote == str.length()) {
+        return std::nullopt;
     }
 
-    return std::nullopt;
-}
-
-std::string Tokeniser::TokeniserWorker::getNumberString(std::size_t curr_idx) {
-    std::string s = next([](char c) {
-            return !isdigit(c);
-        });
-    idx += s.length();
-    return s;
+    idx = closing_quote + 1;
+    const std::string_view s = str.substr(curr_idx + 1, closing_quote - curr_idx - 1);
+    return Token{TokenType::STRING_LITERAL, s, tokenRangeAt(curr_idx, s.length() + 2)};
 }
 
-std::string Tokeniser::TokeniserWorker::extractIdentifierLike() {
-    std::string s = std::string{str[idx++]};
-    const std::string rest_of_s = next([](char c){ return !(isalnum(c) || c == '_'); });
-    idx += rest_of_s.length();
-    s += rest_of_s;
-    return s;
+SourceRange Tokeniser::TokeniserWorker::tokenRangeAt(const std::size_t pos, std::size_t length) {
+    if (length > Token::MAX_LENGTH) {
+        diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::TOKEN_TOO_LONG, rangeAt(pos, length));
+        length = Token::MAX_LENGTH;
+    }
+    return rangeAt(pos, length);
 }
 
-bool Tokeniser::TokeniserWorker::next_is(const std::string &expected, const std::function<bool(char)> &until) const {
-    const auto nextString = next(expected.length(), until);
-    return nextString.size() == expected.length() && nextString == expected;
+std::string_view Tokeniser::TokeniserWorker::getNumberString() {
+    const std::size_t start = idx;
+    idx = Scanner::skipDigits(str, idx);
+    return str.substr(start, idx - start);
 }
 
-std::string Tokeniser::TokeniserWorker::next(const std::function<bool(char)> &until) const {
-    return next(str.length(), until);
+std::string_view Tokeniser::TokeniserWorker::extractIdentifierLike() {
+    const std::size_t start = idx;
+    idx = Scanner::skipIdentifierChars(str, idx + 1);
+    return str.substr(start, idx - start);
 }
 
-std::string Tokeniser::TokeniserWorker::next(std::size_t count, const std::function<bool(char)> &until) const {
-    std::string res;
-    std::size_t i = idx;
-    while (i < str.length() && count-- > 0) {
-        char c = str[i++];
-        if (!until(c)) {
-            res += c;
-        } else {
-            break;
-        }
-    }
-
-    return res;
+bool Tokeniser::TokeniserWorker::next_is(const char expected) const {
+    return idx < str.length() && str[idx] == expected;
 }
-
-const std::unordered_set<char> Tokeniser::TokeniserWorker::DELIMITERS{' ', '\t', '\r', '\n', '\f'};
-const std::unordered_map<std::string, TokenType> Tokeniser::TokeniserWorker::TOKEN_MAP{
-            {"class", TokenType::CLASS},
-            {"static", TokenType::STATIC},
-            {"public", TokenType::PUBLIC},
-            {"private", TokenType::PRIVATE},
-            {"protected", TokenType::PROTECTED},
-            {"open", TokenType::OPEN},
-            {"final", TokenType::FINAL},
-            {"abstract", TokenType::ABSTRACT},
-            {"interface", TokenType::INTERFACE},
-            {"typedef", TokenType::TYPEDEF},
-            {"return", TokenType::RETURN},
-            {"if", TokenType::IF},
-            {"else", TokenType::ELSE},
-            {"for", TokenType::FOR},
-            {"while", TokenType::WHILE},
-            {"break", TokenType::BREAK},
-            {"continue", TokenType::CONTINUE},
-            {"true", TokenType::TRUE},
-            {"false", TokenType::FALSE},
-            {"null", TokenType::NULL_LITERAL}
-};
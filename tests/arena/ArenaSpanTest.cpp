@@ -0,0 +1,48 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "../../include/arena/ArenaSpan.h"
+#include "../../include/arena/ArenaVector.h"
+
+TEST(ArenaSpanTest, CopiesIntoTheArena) {
+    Arena arena;
+    const std::vector<int> values{1, 2, 3};
+    const auto span = ArenaSpan<int>::copyOf(arena, values);
+
+    ASSERT_EQ(span.size(), 3);
+    EXPECT_NE(span.data(), values.data());
+    EXPECT_EQ(std::vector(span.begin(), span.end()), values);
+    EXPECT_EQ(span, ArenaSpan<int>::copyOf(arena, {1, 2, 3}));
+    EXPECT_NE(span, ArenaSpan<int>::copyOf(arena, {1, 2}));
+    EXPECT_EQ(arena.stats().bytes_used, 8 * sizeof(int));
+
+    // Empty spans take no arena memory
+    EXPECT_TRUE(ArenaSpan<int>::copyOf(arena, std::vector<int>{}).empty());
+    EXPECT_EQ(ArenaSpan<int>{}, ArenaSpan<int>::copyOf(arena, std::vector<int>{}));
+    EXPECT_EQ(arena.stats().bytes_used, 8 * sizeof(int));
+}
+
+TEST(ArenaSpanTest, VectorGrowsInTheArena) {
+    Arena arena;
+    ArenaVector<std::pair<int, double>> vector{arena};
+    EXPECT_TRUE(vector.span().empty());
+
+    for (int i = 0; i < 100; i++) vector.emplace_back(i, i * 0.5);
+    const auto span = vector.span();
+
+    ASSERT_EQ(span.size(), 100);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(span[i], (std::pair{i, i * 0.5}));
+    }
+
+    // Buffers of 4, 8, ..., 128 elements, each left behind when the next is made
+    EXPECT_EQ(arena.stats().bytes_used, (4 + 8 + 16 + 32 + 64 + 128) * sizeof(std::pair<int, double>));
+
+    // Later additions do not show up in a span already taken
+    vector.push_back({100, 50.0});
+    EXPECT_EQ(span.size(), 100);
+    EXPECT_EQ(vector.span().back(), (std::pair{100, 50.0}));
+}
@@ -0,0 +1,138 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "../../include/arena/Arena.h"
+
+TEST(ArenaTest, AllocationsAreAlignedAndDisjoint) {
+    Arena arena{256};
+    std::vector<std::pair<char*, std::size_t>> allocations;
+    for (std::size_t i = 0; i < 1000; i++) {
+        const std::size_t size = 1 + i % 61;
+        const std::size_t alignment = std::size_t{1} << (i % 5);
+        auto* ptr = static_cast<char*>(arena.allocate(size, alignment));
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+        std::fill_n(ptr, size, static_cast<char>(i));
+        allocations.emplace_back(ptr, size);
+    }
+    for (std::size_t i = 0; i < allocations.size(); i++) {
+        const auto [ptr, size] = allocations[i];
+        EXPECT_EQ(std::count(ptr, ptr + size, static_cast<char>(i)), size) << i;
+    }
+}
+
+TEST(ArenaTest, BlocksGrowGeometricallyUpToTheCap) {
+    Arena arena{Arena::Options{.block_size = 1024, .max_block_size = 8 * 1024}};
+    for (int i = 0; i < 62; i++) arena.allocate(512, 1);
+
+    // 1 + 2 + 4 + 8 + 8 + 8 KiB hold 2 + 4 + 8 + 16 + 16 + 16 allocations
+    const auto stats = arena.stats();
+    EXPECT_EQ(stats.bytes_used, 62 * 512);
+    EXPECT_EQ(stats.block_count, 6);
+    EXPECT_EQ(stats.bytes_reserved, (1 + 2 + 4 + 8 + 8 + 8) * 1024);
+
+    // Too big for any block size, gets a block of its own
+    arena.allocate(100'000);
+    EXPECT_EQ(arena.stats().block_count, 7);
+}
+
+TEST(ArenaTest, ResetKeepsBlocksForReuse) {
+    Arena arena{1024};
+    void* first = arena.allocate(16);
+    for (int i = 0; i < 100; i++) arena.allocate(100);
+    const auto before = arena.stats();
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(16), first);
+    for (int i = 0; i < 100; i++) arena.allocate(100);
+
+    const auto after = arena.stats();
+    EXPECT_EQ(after.block_count, before.block_count);
+    EXPECT_EQ(after.bytes_reserved, before.bytes_reserved);
+    EXPECT_EQ(after.bytes_used, before.bytes_used);
+    EXPECT_EQ(after.high_water_mark, before.bytes_used + before.bytes_padding);
+}
+
+TEST(ArenaTest, StatsCountPaddingAndHighWaterMark) {
+    Arena arena{4096};
+    arena.allocate(1, 1);
+    arena.allocate(8, 8);
+    arena.allocate(1, 1);
+    arena.allocate(16, 16);
+
+    auto stats = arena.stats();
+    EXPECT_EQ(stats.bytes_used, 26);
+    EXPECT_EQ(stats.bytes_padding, 7 + 15);
+    EXPECT_EQ(stats.high_water_mark, 48);
+
+    arena.reset();
+    arena.allocate(4, 1);
+    stats = arena.stats();
+    EXPECT_EQ(stats.bytes_used, 4);
+    EXPECT_EQ(stats.bytes_padding, 0);
+    EXPECT_EQ(stats.high_water_mark, 48);
+}
+
+TEST(ArenaTest, ClearFreesAllButTheFirstBlock) {
+    Arena arena{1024};
+    for (int i = 0; i < 100; i++) arena.allocate(100);
+    ASSERT_GT(arena.stats().block_count, 1);
+
+    arena.clear();
+    const auto stats = arena.stats();
+    EXPECT_EQ(stats.block_count, 1);
+    EXPECT_EQ(stats.bytes_reserved, 1024);
+    EXPECT_EQ(stats.bytes_used, 0);
+}
+
+TEST(ArenaTest, HugePageBlocksAreAligned) {
+    Arena arena{Arena::Options{.block_size = Arena::HUGE_PAGE_SIZE, .max_block_size = Arena::HUGE_PAGE_SIZE, .huge_pages = true}};
+    const auto* ptr = static_cast<char*>(arena.allocate(1, 1));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % Arena::HUGE_PAGE_SIZE, 0);
+    EXPECT_EQ(arena.stats().bytes_reserved, Arena::HUGE_PAGE_SIZE);
+}
+
+namespace {
+
+// Appends its id to `log` when destroyed
+struct Tracked {
+    std::vector<int>& log;
+    int id;
+    std::string payload = std::string(64, 'x'); // on the heap, so a missed destructor leaks
+
+    ~Tracked() { log.push_back(id); }
+};
+
+}
+
+TEST(ArenaTest, DestroysNonTrivialObjectsInReverseOrder) {
+    std::vector<int> log;
+    {
+        Arena arena{256};
+        for (int i = 0; i < 10; i++) arena.make<Tracked>(log, i);
+        arena.reset();
+        EXPECT_EQ(log, (std::vector{9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+
+        log.clear();
+        arena.make<Tracked>(log, 0);
+        arena.make<Tracked>(log, 1);
+        arena.clear();
+        EXPECT_EQ(log, (std::vector{1, 0}));
+
+        log.clear();
+        arena.make<Tracked>(log, 2);
+    }
+    EXPECT_EQ(log, std::vector{2});
+}
+
+TEST(ArenaTest, TriviallyDestructibleObjectsAreNotTracked) {
+    std::vector<int> log; // outlives the arena, which writes to it when destroyed
+    Arena arena{4096};
+    arena.make<std::uint64_t>(1);
+    EXPECT_EQ(arena.stats().bytes_used, sizeof(std::uint64_t));
+
+    arena.make<Tracked>(log, 0);
+    EXPECT_GT(arena.stats().bytes_used, sizeof(std::uint64_t) + sizeof(Tracked));
+}
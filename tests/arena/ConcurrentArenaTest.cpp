@@ -0,0 +1,123 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../../include/arena/ConcurrentArena.h"
+
+TEST(ConcurrentArenaTest, ThreadsGetAlignedDisjointMemory) {
+    ConcurrentArena arena{1024};
+    constexpr int threads = 8;
+    constexpr std::size_t per_thread = 2000;
+    std::vector<std::vector<std::pair<char*, std::size_t>>> allocations(threads);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = 0; i < per_thread; i++) {
+                const std::size_t size = 1 + i % 61;
+                const std::size_t alignment = std::size_t{1} << (i % 5);
+                auto* ptr = static_cast<char*>(arena.allocate(size, alignment));
+                ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+                std::fill_n(ptr, size, static_cast<char>(t));
+                allocations[t].emplace_back(ptr, size);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (int t = 0; t < threads; t++) {
+        for (const auto& [ptr, size] : allocations[t]) {
+            ASSERT_EQ(std::count(ptr, ptr + size, static_cast<char>(t)), size) << t;
+        }
+    }
+}
+
+TEST(ConcurrentArenaTest, ResetReusesChunks) {
+    ConcurrentArena arena{1024};
+    const auto fill = [&] {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&] { for (int i = 0; i < 100; i++) arena.allocate(100); });
+        }
+        for (auto& worker : workers) worker.join();
+    };
+
+    fill();
+    const std::size_t chunks = arena.chunkCount();
+    EXPECT_GE(chunks, 4 * 100 * 100 / 1024);
+
+    for (int round = 0; round < 5; round++) {
+        arena.reset();
+        fill();
+    }
+    EXPECT_EQ(arena.chunkCount(), chunks);
+
+    arena.clear();
+    EXPECT_EQ(arena.chunkCount(), 0);
+}
+
+TEST(ConcurrentArenaTest, CacheGoesStaleOnResetAndAcrossArenas) {
+    ConcurrentArena first{1024};
+    ConcurrentArena second{1024};
+    auto* a = static_cast<char*>(first.allocate(8));
+    auto* b = static_cast<char*>(second.allocate(8));
+    auto* c = static_cast<char*>(first.allocate(8));
+    EXPECT_NE(c, a);
+    EXPECT_EQ(first.chunkCount(), 2); // switching arenas abandoned the first chunk
+    EXPECT_EQ(second.chunkCount(), 1);
+    std::fill_n(b, 8, 'b');
+
+    first.reset();
+    first.allocate(8);
+    EXPECT_EQ(first.chunkCount(), 2);
+    EXPECT_EQ(std::count(b, b + 8, 'b'), 8);
+}
+
+TEST(ConcurrentArenaTest, OversizedAllocationsGetChunksOfTheirOwn) {
+    ConcurrentArena arena{1024};
+    auto* big = static_cast<char*>(arena.allocate(10'000, 64));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0);
+    std::fill_n(big, 10'000, 'x');
+    EXPECT_EQ(arena.chunkCount(), 0);
+}
+
+namespace {
+
+// Counts how many times it is destroyed
+struct Counted {
+    std::atomic<int>& destroyed;
+    std::string payload = std::string(64, 'x'); // on the heap, so a missed destructor leaks
+
+    ~Counted() { destroyed++; }
+};
+
+}
+
+TEST(ConcurrentArenaTest, DestroysEveryObjectOnce) {
+    std::atomic<int> destroyed = 0;
+    {
+        ConcurrentArena arena{4096};
+        const auto fill = [&] {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < 4; t++) {
+                workers.emplace_back([&] { for (int i = 0; i < 250; i++) arena.make<Counted>(destroyed); });
+            }
+            for (auto& worker : workers) worker.join();
+        };
+
+        fill();
+        arena.reset();
+        EXPECT_EQ(destroyed, 1000);
+
+        fill();
+        arena.clear();
+        EXPECT_EQ(destroyed, 2000);
+
+        fill();
+    }
+    EXPECT_EQ(destroyed, 3000);
+}
@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "../../include/diagnostics/DiagnosticEngine.h"
 
 class DiagnosticEngineTest : public testing::Test {
@@ -14,25 +17,271 @@ protected:
 };
 
 TEST_F(DiagnosticEngineTest, CanReportAndRetrieveDiagnosticsWithSourceLocation) {
-    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceLocation{5, 10}, "My message");
-    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{SourceLocation{5, 10}}, "My message");
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceLocation{510}, {Symbol::intern("My message")});
+    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{SourceLocation{510}}, DiagnosticArgs{Symbol::intern("My message")});
 
     ASSERT_EQ (diagnostic_engine.getAll(), diagnostics);
 
-    diagnostic_engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{10, 20}, "Another message");
-    diagnostics.emplace_back(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{10, 20}}, "Another message");
+    diagnostic_engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{1020}, {TokenType::SEMI_COLON, 42});
+    diagnostics.emplace_back(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{1020}}, DiagnosticArgs{TokenType::SEMI_COLON, 42});
 
     ASSERT_EQ (diagnostic_engine.getAll(), diagnostics);
 }
 
 TEST_F(DiagnosticEngineTest, CanReportAndRetrieveDiagnosticsWithSourceRange) {
-    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{5, 10, 20}, "My message");
-    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{5, 10, 20}, "My message");
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{SourceLocation{510}, 20}, {Symbol::intern("My message")});
+    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, SourceRange{SourceLocation{510}, 20}, DiagnosticArgs{Symbol::intern("My message")});
 
     ASSERT_EQ (diagnostic_engine.getAll(), diagnostics);
 
-    diagnostic_engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{10, 20, 120}, "Another message");
-    diagnostics.emplace_back(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{10, 20, 120}, "Another message");
+    diagnostic_engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{1020}, 120}, {TokenType::SEMI_COLON, 42});
+    diagnostics.emplace_back(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{1020}, 120}, DiagnosticArgs{TokenType::SEMI_COLON, 42});
 
     ASSERT_EQ (diagnostic_engine.getAll(), diagnostics);
-}
\ No newline at end of file
+}
+
+TEST_F(DiagnosticEngineTest, MessagesAreRenderedFromKindAndArgs) {
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{0});
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_SOMETHING, SourceLocation{1}, {TokenType::SEMI_COLON});
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_SOMETHING, SourceLocation{2}, {Symbol::intern("Foo")});
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_SOMETHING, SourceLocation{3}, {-7});
+    diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_RIGHT_CURLY_BRACE, SourceLocation{4});
+
+    const auto& all = diagnostic_engine.getAll();
+    ASSERT_EQ(all.size(), 5);
+    EXPECT_EQ(all[0].msg(), "Unrecognised token.");
+    EXPECT_EQ(all[1].msg(), "Expected ';'");
+    EXPECT_EQ(all[2].msg(), "Expected 'Foo'");
+    EXPECT_EQ(all[3].msg(), "Expected '-7'");
+    EXPECT_EQ(all[4].msg(), "Expected '}'");
+
+    EXPECT_EQ(all[1].args[0].tokenType(), TokenType::SEMI_COLON);
+    EXPECT_EQ(all[2].args[0].symbol(), Symbol::intern("Foo"));
+    EXPECT_EQ(all[3].args[0].integer(), -7);
+    EXPECT_NE(all[1], all[2]);
+    EXPECT_NE(all[2].args, DiagnosticArgs({Symbol::intern("Foo"), 1}));
+}
+
+TEST_F(DiagnosticEngineTest, ThreadsReportConcurrentlyWhileBeingRead) {
+    constexpr std::size_t threads = 8;
+    constexpr std::size_t per_thread = 5000;
+
+    std::atomic<bool> done{false};
+    std::thread reader{[&] {
+        // Each read sees a prefix of every thread's reports
+        while (!done.load()) {
+            const std::size_t seen = diagnostic_engine.getAll().size();
+            ASSERT_LE(seen, diagnostic_engine.count());
+        }
+    }};
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = 0; i < per_thread; i++) {
+                diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{i}, static_cast<uint32_t>(t)});
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    done.store(true);
+    reader.join();
+
+    const auto& all = diagnostic_engine.getAll();
+    ASSERT_EQ(all.size(), threads * per_thread);
+    ASSERT_EQ(diagnostic_engine.count(), threads * per_thread);
+    // Merged in report order, so every thread's diagnostics are in the order it reported them
+    std::vector<std::size_t> next(threads, 0);
+    for (const auto& diagnostic : all) {
+        const std::size_t t = diagnostic.source_range.length();
+        ASSERT_EQ(diagnostic.source_range.begin.offset, next[t]++);
+    }
+}
+
+TEST_F(DiagnosticEngineTest, ErrorsPastTheLimitAreDropped) {
+    DiagnosticEngine limited{3};
+    for (std::size_t i = 0; i < 5; i++) {
+        EXPECT_EQ(limited.limitReached(), i >= 3);
+        limited.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+        limited.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+    }
+
+    EXPECT_TRUE(limited.limitReached());
+    EXPECT_EQ(limited.stats().over_limit, 2);
+    EXPECT_EQ(std::ranges::count(limited.getAll(), DiagnosticSeverity::ERROR, &Diagnostic::severity), 3);
+    EXPECT_EQ(std::ranges::count(limited.getAll(), DiagnosticSeverity::WARNING, &Diagnostic::severity), 5);
+}
+
+TEST_F(DiagnosticEngineTest, ConcurrentErrorsStopAtTheLimit) {
+    DiagnosticEngine limited{1000};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; t++) {
+        workers.emplace_back([&] {
+            while (!limited.limitReached()) {
+                limited.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{0});
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    EXPECT_EQ(limited.getAll().size(), 1000);
+}
+
+TEST_F(DiagnosticEngineTest, ThreadCanAlternateBetweenEngines) {
+    DiagnosticEngine other;
+    for (std::size_t i = 0; i < 200; i++) {
+        diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+        other.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+        diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{i}});
+    }
+
+    EXPECT_EQ(diagnostic_engine.getAll(), diagnostics);
+    EXPECT_EQ(other.getAll().size(), 200);
+}
+
+TEST_F(DiagnosticEngineTest, CoalescesAdjacentDiagnosticsOfTheSameKind) {
+    DiagnosticEngine coalescing{DiagnosticOptions{.coalesce_gap = 1}};
+    const auto report = [&](const DiagnosticKind kind, const std::size_t begin, const DiagnosticArgs args = {}) {
+        coalescing.reportProblem(DiagnosticSeverity::ERROR, kind, SourceLocation{begin}, args);
+    };
+    // A run of bad bytes, some of them a space apart
+    for (const std::size_t begin : {10, 11, 12, 14, 15, 17}) report(DiagnosticKind::UNRECOGNISED_TOKEN, begin);
+    // Too far from the run
+    report(DiagnosticKind::UNRECOGNISED_TOKEN, 20);
+    // Another kind, or other args, break the run
+    report(DiagnosticKind::EXPECTED_DECLARATION, 21);
+    report(DiagnosticKind::UNRECOGNISED_TOKEN, 22);
+    report(DiagnosticKind::EXPECTED_SOMETHING, 23, {TokenType::SEMI_COLON});
+    report(DiagnosticKind::EXPECTED_SOMETHING, 24, {TokenType::COMMA});
+    // Warnings are kept apart from errors
+    coalescing.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::EXPECTED_SOMETHING, SourceLocation{25}, {TokenType::COMMA});
+
+    const std::vector<std::pair<std::size_t, std::size_t>> expected{
+        {10, 18}, {20, 21}, {21, 22}, {22, 23}, {23, 24}, {24, 25}, {25, 26},
+    };
+    const auto& all = coalescing.getAll();
+    ASSERT_EQ(all.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(all[i].source_range, SourceRange(SourceLocation{expected[i].first}, SourceLocation{expected[i].second})) << i;
+    }
+    EXPECT_EQ(coalescing.stats().coalesced, 5);
+
+    // Extending the last one is seen by the next read
+    coalescing.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::EXPECTED_SOMETHING, SourceRange{SourceLocation{26}, 2}, {TokenType::COMMA});
+    EXPECT_EQ(coalescing.getAll().size(), expected.size());
+    EXPECT_EQ(coalescing.getAll()[6].source_range.end, SourceLocation{28});
+}
+
+TEST_F(DiagnosticEngineTest, CoalescedAndSuppressedErrorsDoNotCountTowardsTheLimit) {
+    DiagnosticEngine engine{DiagnosticOptions{.error_limit = 2, .coalesce_gap = 0, .suppress_cascades = true}};
+    for (std::size_t i = 0; i < 100; i++) {
+        engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+    }
+    engine.beginRecovery();
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_IDENTIFIER, SourceLocation{200});
+    engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::EXPECTED_IDENTIFIER, SourceLocation{201});
+    engine.endRecovery();
+    EXPECT_FALSE(engine.limitReached());
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_IDENTIFIER, SourceLocation{300});
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, SourceLocation{400});
+
+    EXPECT_TRUE(engine.limitReached());
+    ASSERT_EQ(engine.getAll().size(), 3);
+    EXPECT_EQ(engine.getAll()[0].source_range, SourceRange(SourceLocation{0}, SourceLocation{100}));
+    EXPECT_EQ(engine.getAll()[1].severity, DiagnosticSeverity::WARNING);
+    const auto [coalesced, cascades, over_limit] = engine.stats();
+    EXPECT_EQ(coalesced, 99);
+    EXPECT_EQ(cascades, 1);
+    EXPECT_EQ(over_limit, 1);
+}
+
+TEST_F(DiagnosticEngineTest, ThreadsCoalesceAndRecoverIndependently) {
+    DiagnosticEngine engine{DiagnosticOptions{.coalesce_gap = 0, .suppress_cascades = true}};
+    constexpr std::size_t threads = 8;
+    constexpr std::size_t per_thread = 5000;
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            // Each thread's own run, in a range of its own
+            for (std::size_t i = 0; i < per_thread; i++) {
+                engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{t * per_thread * 2 + i});
+            }
+            engine.beginRecovery();
+            engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_IDENTIFIER, SourceLocation{0});
+            engine.endRecovery();
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    ASSERT_EQ(engine.getAll().size(), threads);
+    for (const auto& diagnostic : engine.getAll()) EXPECT_EQ(diagnostic.source_range.length(), per_thread);
+    EXPECT_EQ(engine.stats().coalesced, threads * (per_thread - 1));
+    EXPECT_EQ(engine.stats().cascades, threads);
+}
+
+TEST_F(DiagnosticEngineTest, NothingIsCoalescedOrSuppressedAcrossFiles) {
+    DiagnosticEngine engine{DiagnosticOptions{.coalesce_gap = 1, .suppress_cascades = true}};
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{9});
+    engine.beginRecovery();
+    // The next file starts a byte after the end of this one
+    engine.beginFile();
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{11});
+    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{12});
+
+    ASSERT_EQ(engine.getAll().size(), 2);
+    EXPECT_EQ(engine.getAll()[1].source_range, SourceRange(SourceLocation{11}, 2));
+}
+
+TEST_F(DiagnosticEngineTest, StreamsToASinkInsteadOfKeeping) {
+    CollectingSink sink;
+    {
+        DiagnosticEngine engine{DiagnosticOptions{.error_limit = 3, .coalesce_gap = 0, .sink = &sink}};
+        for (std::size_t i = 0; i < 10; i++) {
+            engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{i});
+        }
+        engine.reportProblem(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{20});
+        // Held back in case the next one extends it
+        EXPECT_EQ(sink.getAll().size(), 1);
+        engine.beginFile();
+        engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_IDENTIFIER, SourceLocation{30});
+        engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, SourceLocation{40});
+        engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_CLASS_NAME, SourceLocation{50});
+
+        EXPECT_EQ(engine.count(), 0);
+        EXPECT_TRUE(engine.getAll().empty());
+        EXPECT_EQ(engine.stats().coalesced, 9);
+        EXPECT_EQ(engine.stats().over_limit, 1);
+    }
+
+    // Whatever was held back is sent when the engine goes away
+    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{0}, 10});
+    diagnostics.emplace_back(DiagnosticSeverity::WARNING, DiagnosticKind::UNRECOGNISED_TOKEN, SourceRange{SourceLocation{20}});
+    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_IDENTIFIER, SourceRange{SourceLocation{30}});
+    diagnostics.emplace_back(DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, SourceRange{SourceLocation{40}});
+    EXPECT_EQ(sink.getAll(), diagnostics);
+}
+
+TEST_F(DiagnosticEngineTest, ThreadsStreamToASinkConcurrently) {
+    CollectingSink sink;
+    constexpr std::size_t threads = 8;
+    constexpr std::size_t per_thread = 5000;
+    {
+        DiagnosticEngine engine{DiagnosticOptions{.sink = &sink}};
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                for (std::size_t i = 0; i < per_thread; i++) {
+                    engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, SourceLocation{t * per_thread + i});
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    ASSERT_EQ(sink.getAll().size(), threads * per_thread);
+    std::vector<std::size_t> offsets;
+    for (const auto& diagnostic : sink.getAll()) offsets.push_back(diagnostic.source_range.begin.offset);
+    std::ranges::sort(offsets);
+    for (std::size_t i = 0; i < offsets.size(); i++) ASSERT_EQ(offsets[i], i);
+}
@@ -0,0 +1,130 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+
+#include "../../include/diagnostics/DiagnosticEngine.h"
+#include "../../include/diagnostics/JsonLinesWriter.h"
+#include "../../include/diagnostics/SarifWriter.h"
+
+class DiagnosticWriterTest : public testing::Test {
+protected:
+    std::filesystem::path dir;
+    SourceManager source_manager;
+    std::ostringstream out;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / ("kahwa_diagnostic_writer_test_" + std::to_string(getpid()));
+        std::filesystem::create_directories(dir);
+        std::ofstream{dir / "a.kahwa"} << "typedef A B;\n  ## x\n";
+        std::ofstream{dir / "b \"quoted\".kahwa"} << "class\n";
+        source_manager.addFile(dir / "a.kahwa");
+        source_manager.addFile(dir / "b \"quoted\".kahwa");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    [[nodiscard]] SourceRange range(const std::size_t file_id, const std::size_t begin, const std::size_t end) const {
+        return {source_manager.getLocation(file_id, begin), source_manager.getLocation(file_id, end)};
+    }
+
+    [[nodiscard]] std::string path(const std::size_t file_id) const {
+        std::string escaped;
+        for (const char c : source_manager.getPath(file_id).native()) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+};
+
+TEST_F(DiagnosticWriterTest, WritesOneJsonObjectPerLine) {
+    {
+        JsonLinesWriter writer{out, source_manager};
+        writer.consume({DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(0, 15, 17)});
+        writer.consume({DiagnosticSeverity::WARNING, DiagnosticKind::EXPECTED_SOMETHING, range(1, 5, 6), {TokenType::IDENTIFIER}});
+        EXPECT_EQ(writer.written(), 2);
+        EXPECT_EQ(writer.errors(), 1);
+    }
+
+    EXPECT_EQ(out.str(),
+        R"({"file":")" + path(0) + R"(","line":2,"column":3,"end_line":2,"end_column":5,"severity":"error","kind":"UNRECOGNISED_TOKEN","message":"Unrecognised token."})" "\n"
+        R"({"file":")" + path(1) + R"(","line":1,"column":6,"end_line":2,"end_column":1,"severity":"warning","kind":"EXPECTED_SOMETHING","message":"Expected 'IDENTIFIER'"})" "\n");
+}
+
+TEST_F(DiagnosticWriterTest, EscapesMessages) {
+    {
+        JsonLinesWriter writer{out, source_manager};
+        writer.consume({DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_SOMETHING, range(0, 0, 1), {Symbol::intern("\"\\\n\t\x01")}});
+    }
+    EXPECT_NE(out.str().find(R"("message":"Expected '\"\\\n\t\u0001'")"), std::string::npos) << out.str();
+}
+
+TEST_F(DiagnosticWriterTest, WritesACompleteSarifLog) {
+    {
+        SarifWriter writer{out, source_manager};
+        writer.consume({DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(0, 15, 17)});
+        writer.consume({DiagnosticSeverity::WEAK_WARNING, DiagnosticKind::EXPECTED_DECLARATION, range(1, 0, 5)});
+        writer.finish();
+        writer.finish();
+    }
+
+    const std::string log = out.str();
+    EXPECT_TRUE(log.starts_with(R"({"version":"2.1.0",)")) << log;
+    EXPECT_TRUE(log.ends_with("]}]}\n")) << log;
+    EXPECT_NE(log.find(
+        R"({"ruleId":"UNRECOGNISED_TOKEN","level":"error","message":{"text":"Unrecognised token."},)"
+        R"("locations":[{"physicalLocation":{"artifactLocation":{"uri":"file://)" + (dir / "a.kahwa").generic_string() + R"("},)"
+        R"("region":{"startLine":2,"startColumn":3,"endLine":2,"endColumn":5}}}]},)" "\n"
+        R"({"ruleId":"EXPECTED_DECLARATION","level":"note")"), std::string::npos) << log;
+}
+
+TEST_F(DiagnosticWriterTest, SarifUrisArePercentEncoded) {
+    {
+        SarifWriter writer{out, source_manager};
+        writer.consume({DiagnosticSeverity::ERROR, DiagnosticKind::EXPECTED_DECLARATION, range(1, 0, 5)});
+    }
+    const std::string uri = "file://" + dir.generic_string() + "/b%20%22quoted%22.kahwa";
+    EXPECT_NE(out.str().find(R"({"uri":")" + uri + R"("})"), std::string::npos) << out.str();
+}
+
+TEST_F(DiagnosticWriterTest, EmptySarifLogIsValid) {
+    { SarifWriter writer{out, source_manager}; }
+    EXPECT_TRUE(out.str().ends_with(R"("results":[)" "\n" "\n]}]}\n")) << out.str();
+}
+
+TEST_F(DiagnosticWriterTest, BuffersUpToTheBufferSize) {
+    const Diagnostic diagnostic{DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(0, 15, 17)};
+    std::ostringstream unbuffered;
+    JsonLinesWriter reference{unbuffered, source_manager, 0};
+    reference.consume(diagnostic);
+    const std::size_t line = unbuffered.str().size();
+
+    JsonLinesWriter writer{out, source_manager, line * 3};
+    for (int i = 0; i < 3; i++) writer.consume(diagnostic);
+    EXPECT_TRUE(out.str().empty());
+
+    // The fourth would overflow the buffer, so the first three are written out
+    writer.consume(diagnostic);
+    EXPECT_EQ(out.str().size(), line * 3);
+
+    writer.flush();
+    EXPECT_EQ(out.str().size(), line * 4);
+}
+
+TEST_F(DiagnosticWriterTest, EngineStreamsToAWriter) {
+    {
+        JsonLinesWriter writer{out, source_manager};
+        DiagnosticEngine engine{{.coalesce_gap = 1, .sink = &writer}};
+        for (std::size_t i = 15; i < 17; i++) engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, range(0, i, i + 1));
+        engine.flush();
+        EXPECT_EQ(writer.written(), 1);
+        EXPECT_EQ(engine.count(), 0);
+    }
+    EXPECT_NE(out.str().find(R"("line":2,"column":3,"end_line":2,"end_column":5,)"), std::string::npos) << out.str();
+}
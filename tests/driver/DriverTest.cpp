@@ -0,0 +1,213 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "../../include/driver/Driver.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+class DriverTest : public testing::Test {
+protected:
+    std::vector<std::string> storage;
+    std::vector<std::string_view> sources;
+
+    void SetUp() override {
+        for (int i = 0; i < 300; i++) {
+            const std::string n = std::to_string(i);
+            std::string src;
+            for (int j = 0; j < i % 7 + 1; j++) {
+                src += "public typedef Base" + n + " Alias" + n + "_" + std::to_string(j) + ";\n";
+            }
+            switch (i % 5) {
+                case 0: src += "typedef Missing;\n"; break;
+                case 1: src += "# stray\n"; break;
+                case 2: src += "typedef A B\n\"unterminated"; break;
+                default: break;
+            }
+            storage.push_back(std::move(src));
+        }
+        sources.assign(storage.begin(), storage.end());
+    }
+};
+
+TEST_F(DriverTest, MatchesSequentialParse) {
+    Arena arena;
+    DiagnosticEngine diagnostic_engine;
+    std::vector<KahwaFile*> expected_files;
+    std::size_t file_start = 0;
+    for (std::size_t file_id = 0; file_id < sources.size(); file_id++) {
+        const auto tokens = Tokeniser{diagnostic_engine}.tokenise(SourceLocation{file_start}, sources[file_id]);
+        expected_files.push_back(Parser{arena, diagnostic_engine}.parseFile(tokens));
+        file_start = SourceManager::nextFileStart(file_start, sources[file_id].length());
+    }
+
+    Driver driver{4};
+    const Project project = driver.parse(sources);
+
+    ASSERT_EQ(project.files.size(), expected_files.size());
+    for (std::size_t file_id = 0; file_id < sources.size(); file_id++) {
+        ASSERT_NE(project.files[file_id], nullptr);
+        EXPECT_EQ(*project.files[file_id], *expected_files[file_id]) << "file " << file_id;
+    }
+
+    // Same diagnostics, with the lexer's and the parser's merged by position within each file
+    std::vector<const Diagnostic*> expected;
+    for (const auto& diagnostic : diagnostic_engine.getAll()) expected.push_back(&diagnostic);
+    std::ranges::stable_sort(expected, {}, [](const Diagnostic* d) { return d->source_range.begin; });
+
+    ASSERT_EQ(project.diagnostics.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(project.diagnostics[i], *expected[i]) << "diagnostic " << i;
+    }
+}
+
+TEST_F(DriverTest, DiagnosticsAreDeterministicAcrossThreadCounts) {
+    const Project reference = Driver{1}.parse(sources);
+    EXPECT_FALSE(reference.diagnostics.empty());
+
+    for (const std::size_t threads : {2, 3, 8, 16}) {
+        for (int run = 0; run < 3; run++) {
+            const Project project = Driver{threads}.parse(sources);
+            EXPECT_EQ(project.diagnostics, reference.diagnostics) << threads << " threads";
+        }
+    }
+
+    for (std::size_t i = 1; i < reference.diagnostics.size(); i++) {
+        const auto& prev = reference.diagnostics[i - 1].source_range;
+        const auto& curr = reference.diagnostics[i].source_range;
+        EXPECT_LE(prev.begin, curr.begin);
+    }
+}
+
+TEST_F(DriverTest, StopsAtTheErrorLimit) {
+    const Project unlimited = Driver{1}.parse(sources);
+    const auto errors = [](const Project& project) {
+        return std::ranges::count(project.diagnostics, DiagnosticSeverity::ERROR, &Diagnostic::severity);
+    };
+    ASSERT_GT(errors(unlimited), 50);
+
+    const Project reference = Driver{1, {.error_limit = 50}}.parse(sources);
+    EXPECT_EQ(errors(reference), 50);
+    ASSERT_EQ(reference.files.size(), sources.size());
+    // The files after the limit was hit are left empty
+    EXPECT_TRUE(reference.files.back()->typedefDecls.empty());
+
+    // The same errors are kept however the files are spread over workers
+    for (int run = 0; run < 5; run++) {
+        const Project project = Driver{4, {.error_limit = 50}}.parse(sources);
+        EXPECT_EQ(project.diagnostics, reference.diagnostics);
+        EXPECT_EQ(project.dropped_diagnostics.over_limit, reference.dropped_diagnostics.over_limit);
+        ASSERT_EQ(project.files.size(), reference.files.size());
+        for (std::size_t i = 0; i < project.files.size(); i++) {
+            EXPECT_EQ(*project.files[i], *reference.files[i]) << "file " << i;
+        }
+    }
+}
+
+TEST_F(DriverTest, BoundedDiagnosticsAreDeterministicAcrossThreadCounts) {
+    // Runs of bad bytes, and declarations broken one after another
+    std::vector<std::string> broken;
+    for (int i = 0; i < 100; i++) {
+        broken.push_back("typedef A B;\n# # ## #\ntypedef ; typedef ; typedef C D;\n" + std::string(i % 3, '#'));
+    }
+    const std::vector<std::string_view> views(broken.begin(), broken.end());
+    constexpr DiagnosticOptions options{.coalesce_gap = 1, .suppress_cascades = true};
+
+    const Project reference = Driver{1, options}.parse(views);
+    const Project everything = Driver{1}.parse(views);
+    EXPECT_LT(reference.diagnostics.size(), everything.diagnostics.size());
+    EXPECT_EQ(reference.dropped_diagnostics.cascades, 100);
+    EXPECT_EQ(reference.diagnostics.size() + reference.dropped_diagnostics.coalesced + reference.dropped_diagnostics.cascades,
+        everything.diagnostics.size());
+
+    for (const std::size_t threads : {2, 4, 8}) {
+        const Project project = Driver{threads, options}.parse(views);
+        EXPECT_EQ(project.diagnostics, reference.diagnostics) << threads << " threads";
+    }
+}
+
+TEST_F(DriverTest, StreamsDiagnosticsToASink) {
+    const Project reference = Driver{1}.parse(sources);
+    ASSERT_FALSE(reference.diagnostics.empty());
+
+    for (const std::size_t threads : {1, 4}) {
+        CollectingSink sink;
+        const Project project = Driver{threads, {.sink = &sink}}.parse(sources);
+        EXPECT_TRUE(project.diagnostics.empty());
+
+        // In the order they were reported in, which is only the order of the files with one thread
+        std::vector<const Diagnostic*> streamed;
+        for (const auto& diagnostic : sink.getAll()) streamed.push_back(&diagnostic);
+        std::ranges::stable_sort(streamed, {}, [](const Diagnostic* d) { return d->source_range.begin.offset; });
+        ASSERT_EQ(streamed.size(), reference.diagnostics.size());
+        for (std::size_t i = 0; i < streamed.size(); i++) EXPECT_EQ(*streamed[i], reference.diagnostics[i]) << threads << " threads, " << i;
+    }
+}
+
+TEST_F(DriverTest, ParsesNoFiles) {
+    const Project project = Driver{2}.parse(std::vector<std::string_view>{});
+    EXPECT_TRUE(project.files.empty());
+    EXPECT_TRUE(project.diagnostics.empty());
+}
+
+TEST_F(DriverTest, ParseFileParallelMatchesSequentialParse) {
+    // Large enough for many chunks, with errors and unclosed braces that carry a declaration over chunk starts
+    std::string source;
+    for (int i = 0; i < 12'000; i++) {
+        const std::string n = std::to_string(i);
+        switch (i % 11) {
+            case 0: source += "x" + n + " class Foo" + n + " { int y; }\n"; break;
+            case 1: source += "typedef Missing;\n"; break;
+            case 2: source += "# stray " + n + "\n"; break;
+            case 3: if (i % 1000 == 3) source += "x class Open" + n + " {\n"; break;
+            case 4: if (i % 1500 == 4) source += "}\n"; break;
+            case 5: if (i % 2000 == 5) source += "x class Junk" + n + " { { } ; int z; }\n"; break;
+            default: source += "public typedef Base" + n + " Alias" + n + ";\n"; break;
+        }
+    }
+    source += "typedef A B\n\"unterminated";
+
+    const Project expected = Driver{1}.parse(std::vector<std::string_view>{source});
+    ASSERT_FALSE(expected.diagnostics.empty());
+
+    for (const std::size_t threads : {1, 2, 3, 8}) {
+        const Project project = Driver{threads}.parseFileParallel(source);
+        ASSERT_EQ(project.files.size(), 1);
+        EXPECT_EQ(*project.files[0], *expected.files[0]) << threads << " threads";
+        EXPECT_EQ(project.diagnostics, expected.diagnostics) << threads << " threads";
+    }
+}
+
+TEST_F(DriverTest, ParseFileParallelMatchesSequentialParseOfRandomTokens) {
+    // Wherever a chunk starts, inside a comment or string or a declaration being recovered from, it must end
+    // up the same as the sequential parse
+    const std::vector<std::string_view> words{
+        "typedef", "class", "public", "static", "A", "B", ";", "{", "}", "(", "1", "2.", "#", "/*", "*/", "//", "\"",
+    };
+    std::mt19937 random{99};
+    for (int file = 0; file < 5; file++) {
+        std::string source;
+        for (int i = 0; i < 80'000; i++) {
+            source += words[random() % words.size()];
+            source += random() % 8 == 0 ? "\n" : " ";
+        }
+
+        const Project expected = Driver{1}.parse(std::vector<std::string_view>{source});
+        const Project project = Driver{4}.parseFileParallel(source);
+        EXPECT_EQ(*project.files[0], *expected.files[0]) << "file " << file;
+        EXPECT_EQ(project.diagnostics, expected.diagnostics) << "file " << file;
+    }
+}
+
+TEST_F(DriverTest, ParseFileParallelHandlesSmallFiles) {
+    for (const std::string_view source : {std::string_view{}, std::string_view{"typedef A B;"}, std::string_view{"} } typedef"}}) {
+        const Project expected = Driver{1}.parse(std::vector{source});
+        const Project project = Driver{4}.parseFileParallel(source);
+        EXPECT_EQ(*project.files[0], *expected.files[0]) << source;
+        EXPECT_EQ(project.diagnostics, expected.diagnostics) << source;
+    }
+}
@@ -0,0 +1,54 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+
+#include "../../include/driver/ThreadPool.h"
+
+TEST(ThreadPoolTest, RunsEveryIndexExactlyOnce) {
+    ThreadPool pool{4};
+    std::vector<std::atomic<int>> runs(10'000);
+    std::vector<std::atomic<int>> per_worker(pool.size());
+
+    pool.parallelFor(runs.size(), [&](const std::size_t index, const std::size_t worker) {
+        ASSERT_LT(worker, pool.size());
+        runs[index]++;
+        per_worker[worker]++;
+    });
+
+    for (const auto& count : runs) EXPECT_EQ(count, 1);
+    int total = 0;
+    for (const auto& count : per_worker) total += count;
+    EXPECT_EQ(total, runs.size());
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealFromBusyOnes) {
+    ThreadPool pool{4};
+
+    // Index 0 blocks its worker until every other index has run, so the rest of its slice must be stolen
+    std::atomic<int> remaining = 99;
+    pool.parallelFor(100, [&](const std::size_t index, std::size_t) {
+        if (index == 0) {
+            while (remaining > 0) std::this_thread::yield();
+        } else {
+            remaining--;
+        }
+    });
+
+    EXPECT_EQ(remaining, 0);
+}
+
+TEST(ThreadPoolTest, RethrowsExceptionsAndStaysUsable) {
+    ThreadPool pool{3};
+    EXPECT_THROW(pool.parallelFor(50, [](const std::size_t index, std::size_t) {
+        if (index == 17) throw std::runtime_error("boom");
+    }), std::runtime_error);
+
+    std::atomic<int> runs = 0;
+    pool.parallelFor(50, [&](std::size_t, std::size_t) { runs++; });
+    EXPECT_EQ(runs, 50);
+
+    pool.parallelFor(0, [](std::size_t, std::size_t) { FAIL(); });
+}
@@ -0,0 +1,152 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+#include "../../include/parser/BinaryAst.h"
+#include "../../include/parser/Parser.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+class BinaryAstTest : public testing::Test {
+protected:
+    Arena arena;
+    Arena loaded_arena;
+    TypeTable loaded_types{loaded_arena};
+
+    SourceRange at(const std::size_t offset) {
+        return SourceRange{SourceLocation{offset}};
+    }
+
+    TypeRef* type(const std::string& identifier, const std::initializer_list<TypeRef*> args = {}) {
+        return arena.make<TypeRef>(Symbol::intern(identifier), ArenaSpan<TypeRef*>::copyOf(arena, args));
+    }
+
+    FieldDecl* field(const std::string& name, const std::size_t offset, TypeRef* fieldType) {
+        return arena.make<FieldDecl>(Symbol::intern(name), ArenaSpan<Modifier>::copyOf(arena, {Modifier::PRIVATE}), fieldType, at(offset), at(offset + 4), at(offset));
+    }
+
+    // A file with a node of every kind, null children included
+    const KahwaFile* everyKind() {
+        auto* alias = arena.make<TypedefDecl>(Symbol::intern("Alias"), ArenaSpan<Modifier>::copyOf(arena, {Modifier::PUBLIC, Modifier::STATIC}),
+            type("Map", {type("K"), type("V")}), at(3), at(10), SourceRange{SourceLocation{3}, SourceLocation{18}});
+        auto* method = arena.make<MethodDecl>(Symbol::intern("run"), ArenaSpan<Modifier>{}, type("void"),
+            ArenaSpan<std::pair<TypeRef*, Symbol>>::copyOf(arena, {std::pair{type("int"), Symbol::intern("n")}, std::pair{type("List", {type("int")}), Symbol::intern("xs")}}),
+            arena.make<Block>(ArenaSpan<Stmt*>::copyOf(arena, {arena.make<Stmt>(), arena.make<Stmt>()})), at(44), at(49), at(44));
+        auto* abstract = arena.make<MethodDecl>(Symbol::intern("stop"), ArenaSpan<Modifier>::copyOf(arena, {Modifier::ABSTRACT}), nullptr,
+            ArenaSpan<std::pair<TypeRef*, Symbol>>{}, nullptr, at(60), at(65), at(60));
+        auto* nested = arena.make<ClassDecl>(Symbol::intern("Inner"), at(70), at(76), at(70));
+        auto* decl = arena.make<ClassDecl>(Symbol::intern("Foo"), at(20), at(26), SourceRange{SourceLocation{20}, SourceLocation{90}},
+            ArenaSpan<Modifier>::copyOf(arena, {Modifier::OPEN}),
+            ArenaSpan<TypeRef*>::copyOf(arena, {type("Base"), nullptr}),
+            ArenaSpan<FieldDecl*>::copyOf(arena, {field("x", 35, type("int")), field("broken", 40, nullptr), nullptr}),
+            ArenaSpan<MethodDecl*>::copyOf(arena, {method, abstract}),
+            ArenaSpan<ClassDecl*>::copyOf(arena, {nested}));
+        return arena.make<KahwaFile>(ArenaSpan<TypedefDecl*>::copyOf(arena, {alias, nullptr}), ArenaSpan<ClassDecl*>::copyOf(arena, {decl}),
+            ArenaSpan<MethodDecl*>::copyOf(arena, {method}), ArenaSpan<FieldDecl*>::copyOf(arena, {field("global", 95, type("Map", {type("K"), type("V")}))}));
+    }
+};
+
+TEST_F(BinaryAstTest, RoundTripsEveryKindOfNode) {
+    const KahwaFile* file = everyKind();
+    const std::string image = BinaryAst::serialise(*file, SourceLocation{0});
+
+    const auto ast = BinaryAst::view(image);
+    ASSERT_TRUE(ast);
+    EXPECT_EQ(ast->size(), image.size());
+    EXPECT_EQ(*ast->load(loaded_arena, loaded_types, SourceLocation{0}), *file);
+}
+
+TEST_F(BinaryAstTest, RoundTripsAParsedFile) {
+    std::string source;
+    for (int i = 0; i < 500; i++) {
+        const std::string n = std::to_string(i);
+        source += "public typedef Base" + std::to_string(i % 13) + " Alias" + n + ";\n";
+    }
+    // Saved for a file at one location and loaded for it at another, as when the files before it change
+    constexpr SourceLocation saved_at{1000};
+    constexpr SourceLocation loaded_at{7};
+    DiagnosticEngine diagnostic_engine;
+    const KahwaFile* saved = Parser{arena, diagnostic_engine}.parseFile(Tokeniser{diagnostic_engine}.tokenise(saved_at, source));
+    const KahwaFile* expected = Parser{arena, diagnostic_engine}.parseFile(Tokeniser{diagnostic_engine}.tokenise(loaded_at, source));
+    ASSERT_EQ(diagnostic_engine.count(), 0);
+    ASSERT_EQ(saved->typedefDecls.size(), 500);
+
+    const std::string image = BinaryAst::serialise(*saved, saved_at);
+    const KahwaFile* loaded = BinaryAst::view(image)->load(loaded_arena, loaded_types, loaded_at);
+
+    EXPECT_EQ(*loaded, *expected);
+    // Types are interned again, so every mention of one is still the same node
+    EXPECT_EQ(loaded->typedefDecls[0]->referredType, loaded->typedefDecls[13]->referredType);
+    EXPECT_EQ(loaded_types.stats().unique, 13);
+}
+
+TEST_F(BinaryAstTest, WalksTheImageInPlace) {
+    const std::string image = BinaryAst::serialise(*everyKind(), SourceLocation{0});
+    const auto ast = BinaryAst::view(image);
+    ASSERT_TRUE(ast);
+    const binary_ast::KahwaFile& file = ast->file();
+
+    ASSERT_EQ(file.typedef_decls.size(), 2);
+    const auto& alias = *file.typedef_decls[0];
+    EXPECT_FALSE(file.typedef_decls[1]);
+    EXPECT_EQ(ast->str(alias.decl.name), "Alias");
+    EXPECT_EQ(alias.decl.name_range.begin, 10);
+    EXPECT_EQ(alias.decl.body_range.end, 18);
+    ASSERT_EQ(alias.decl.modifiers.size(), 2);
+    EXPECT_EQ(alias.decl.modifiers[1], Modifier::STATIC);
+    EXPECT_EQ(ast->str(alias.referred_type->identifier), "Map");
+    ASSERT_EQ(alias.referred_type->args.size(), 2);
+    EXPECT_EQ(ast->str(alias.referred_type->args[1]->identifier), "V");
+
+    const auto& decl = *file.class_decls[0];
+    EXPECT_EQ(ast->str(decl.decl.name), "Foo");
+    EXPECT_EQ(decl.fields.size(), 3);
+    EXPECT_FALSE(decl.fields[1]->type);
+    const auto& method = *decl.methods[0];
+    ASSERT_EQ(method.parameters.size(), 2);
+    EXPECT_EQ(ast->str(method.parameters[1].name), "xs");
+    EXPECT_EQ(method.block->stmts, 2);
+    EXPECT_FALSE(decl.methods[1]->block);
+    EXPECT_EQ(ast->str(decl.nested_classes[0]->decl.name), "Inner");
+}
+
+TEST_F(BinaryAstTest, RejectsWhatIsNotAnImageOfThisVersion) {
+    const std::string image = BinaryAst::serialise(*everyKind(), SourceLocation{0});
+    EXPECT_TRUE(BinaryAst::view(image));
+
+    EXPECT_FALSE(BinaryAst::view(std::string_view{}));
+    EXPECT_FALSE(BinaryAst::view(std::string_view{image}.substr(0, image.size() - 4)));
+
+    std::string other_version = image;
+    const std::uint32_t version = binary_ast::VERSION + 1;
+    std::memcpy(other_version.data() + offsetof(binary_ast::Header, version), &version, sizeof(version));
+    EXPECT_FALSE(BinaryAst::view(other_version));
+
+    std::string source = "typedef A B;";
+    source.resize(image.size());
+    EXPECT_FALSE(BinaryAst::view(source));
+}
+
+TEST_F(BinaryAstTest, LoadsAMappedImage) {
+    const auto path = std::filesystem::temp_directory_path() / ("kahwa_binary_ast_test_" + std::to_string(getpid()) + ".kast");
+    const KahwaFile* file = everyKind();
+    std::ofstream{path, std::ios::binary} << BinaryAst::serialise(*file, SourceLocation{0});
+
+    {
+        const MappedAst mapped{path};
+        const auto ast = mapped.ast();
+        ASSERT_TRUE(ast);
+        EXPECT_EQ(*ast->load(loaded_arena, loaded_types, SourceLocation{0}), *file);
+    }
+    std::ofstream{path, std::ios::trunc};
+    EXPECT_FALSE(MappedAst{path}.ast());
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(MappedAst{path}, std::filesystem::filesystem_error);
+}
@@ -0,0 +1,90 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "../../include/parser/FlatAst.h"
+
+class FlatAstTest : public testing::Test {
+protected:
+    Arena arena;
+
+    SourceRange at(const std::size_t offset) {
+        return SourceRange{SourceLocation{offset}};
+    }
+
+    TypeRef* type(const std::string& identifier, const std::initializer_list<TypeRef*> args = {}) {
+        return arena.make<TypeRef>(Symbol::intern(identifier), ArenaSpan<TypeRef*>::copyOf(arena, args));
+    }
+
+    FieldDecl* field(const std::string& name, const std::size_t offset, TypeRef* fieldType) {
+        return arena.make<FieldDecl>(Symbol::intern(name), ArenaSpan<Modifier>{}, fieldType, at(offset), at(offset), at(offset));
+    }
+};
+
+TEST_F(FlatAstTest, NumbersNodesBreadthFirst) {
+    auto* alias = arena.make<TypedefDecl>(Symbol::intern("Alias"), ArenaSpan<Modifier>{}, type("Map", {type("K"), type("V")}), at(3), at(10), at(3));
+    auto* method = arena.make<MethodDecl>(Symbol::intern("run"), ArenaSpan<Modifier>{}, type("void"),
+        ArenaSpan<std::pair<TypeRef*, Symbol>>::copyOf(arena, {std::pair{type("int"), Symbol::intern("n")}}),
+        arena.make<Block>(ArenaSpan<Stmt*>{}), at(44), at(49), at(44));
+    auto* decl = arena.make<ClassDecl>(Symbol::intern("Foo"), at(20), at(26), at(20), ArenaSpan<Modifier>{},
+        ArenaSpan<TypeRef*>::copyOf(arena, {type("Base")}),
+        ArenaSpan<FieldDecl*>::copyOf(arena, {field("x", 35, type("int"))}),
+        ArenaSpan<MethodDecl*>::copyOf(arena, {method}));
+    const auto* file = arena.make<KahwaFile>(ArenaSpan<TypedefDecl*>::copyOf(arena, {alias}), ArenaSpan<ClassDecl*>::copyOf(arena, {decl}));
+
+    const FlatAst ast{*file};
+
+    // 0 file; 1 Alias, 2 Foo; 3 Map, 4 Base, 5 x, 6 run; 7 K, 8 V, 9 int, 10 void, 11 int, 12 block
+    ASSERT_EQ(ast.size(), 13);
+    const std::vector<NodeKind> kinds{
+        NodeKind::FILE, NodeKind::TYPEDEF, NodeKind::CLASS, NodeKind::TYPE_REF, NodeKind::TYPE_REF,
+        NodeKind::FIELD, NodeKind::METHOD, NodeKind::TYPE_REF, NodeKind::TYPE_REF, NodeKind::TYPE_REF,
+        NodeKind::TYPE_REF, NodeKind::TYPE_REF, NodeKind::BLOCK,
+    };
+    const std::vector<NodeId> parents{FlatAst::NO_NODE, 0, 0, 1, 2, 2, 2, 3, 3, 5, 6, 6, 6};
+    for (NodeId id = 0; id < ast.size(); id++) {
+        EXPECT_EQ(ast.kind(id), kinds[id]) << id;
+        EXPECT_EQ(ast.parent(id), parents[id]) << id;
+        for (const NodeId child : ast.children(id)) EXPECT_EQ(ast.parent(child), id);
+    }
+
+    EXPECT_EQ(ast.children(FlatAst::ROOT).first, 1);
+    EXPECT_EQ(ast.children(FlatAst::ROOT).size(), 2);
+    EXPECT_EQ(ast.children(2).first, 4);
+    EXPECT_EQ(ast.children(2).size(), 3);
+    EXPECT_TRUE(ast.children(12).empty());
+
+    EXPECT_EQ(ast.name(FlatAst::ROOT), std::nullopt);
+    EXPECT_EQ(ast.name(6), Symbol::intern("run"));
+    EXPECT_EQ(ast.name(8), Symbol::intern("V"));
+    EXPECT_EQ(ast.name(12), std::nullopt);
+}
+
+TEST_F(FlatAstTest, TypesTakeTheirDeclarationsLocation) {
+    auto* first = field("a", 7, type("List", {type("int")}));
+    auto* second = field("b", 30, type("int"));
+    const auto* file = arena.make<KahwaFile>(ArenaSpan<TypedefDecl*>{}, ArenaSpan<ClassDecl*>{}, ArenaSpan<MethodDecl*>{},
+        ArenaSpan<FieldDecl*>::copyOf(arena, {first, second}));
+
+    const FlatAst ast{*file};
+    // 0 file; 1 a, 2 b; 3 List, 4 int; 5 int
+    EXPECT_EQ(ast.location(FlatAst::ROOT), SourceLocation{7});
+    EXPECT_EQ(ast.location(2), SourceLocation{30});
+    EXPECT_EQ(ast.location(3), SourceLocation{7});
+    EXPECT_EQ(ast.location(4), SourceLocation{30});
+    EXPECT_EQ(ast.location(5), SourceLocation{7});
+}
+
+TEST_F(FlatAstTest, ColdFieldsAreReadThroughThePointerNodes) {
+    auto* decl = arena.make<TypedefDecl>(Symbol::intern("Alias"), ArenaSpan<Modifier>::copyOf(arena, {Modifier::PUBLIC}), nullptr, at(0), at(15), at(0));
+    const auto* file = arena.make<KahwaFile>(ArenaSpan<TypedefDecl*>::copyOf(arena, {decl, nullptr}));
+
+    const FlatAst ast{*file};
+    // Missing nodes are skipped
+    ASSERT_EQ(ast.size(), 2);
+    EXPECT_EQ(&ast.node<KahwaFile>(FlatAst::ROOT), file);
+    EXPECT_EQ(&ast.node<TypedefDecl>(1), decl);
+    EXPECT_EQ(ast.node<TypedefDecl>(1).modifiers, ArenaSpan<Modifier>::copyOf(arena, {Modifier::PUBLIC}));
+}
@@ -0,0 +1,137 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "../../include/parser/IncrementalParser.h"
+
+class IncrementalParserTest : public testing::Test {
+protected:
+    static constexpr SourceLocation FILE_START{1000};
+
+    Arena arena;
+    IncrementalParser parser{arena, FILE_START};
+    std::string source;
+    const KahwaFile* file = nullptr;
+
+    void parse(std::string text) {
+        source = std::move(text);
+        file = parser.parse(source);
+    }
+
+    void edit(const std::size_t offset, const std::size_t removed, const std::string_view inserted) {
+        source.replace(offset, removed, inserted);
+        file = parser.reparse(file, source, TextEdit{offset, removed, inserted});
+    }
+
+    static std::string describe(const std::vector<Diagnostic>& diagnostics) {
+        std::string description;
+        for (const auto& diagnostic : diagnostics) {
+            description += std::string{magic_enum::enum_name(diagnostic.kind)} + "@" + std::to_string(diagnostic.source_range.begin.offset) +
+                "+" + std::to_string(diagnostic.source_range.length()) + " " + diagnostic.msg() + "\n";
+        }
+        return description;
+    }
+
+    // The incremental result must be exactly what parsing the text from scratch gives
+    void expectSameAsFullParse() const {
+        Arena full_arena;
+        IncrementalParser full{full_arena, FILE_START};
+        const KahwaFile* expected = full.parse(source);
+
+        ASSERT_EQ(parser.tokens().size(), full.tokens().size()) << source;
+        for (std::size_t i = 0; i < full.tokens().size(); i++) {
+            const Token& actual = parser.tokens()[i];
+            const Token& token = full.tokens()[i];
+            ASSERT_TRUE(actual.type == token.type && actual.getSourceRange() == token.getSourceRange() && toString(actual) == toString(token))
+                << i << ": " << toString(actual) << " vs " << toString(token) << "\n" << source;
+        }
+        ASSERT_EQ(describe(parser.diagnostics()), describe(full.diagnostics())) << source;
+        ASSERT_TRUE(*file == *expected) << source;
+    }
+};
+
+TEST_F(IncrementalParserTest, SingleCharacterEditReusesTheOtherDeclarations) {
+    std::string text;
+    for (int i = 0; i < 100; i++) text += "typedef Base" + std::to_string(i) + " Alias" + std::to_string(i) + ";\n";
+    parse(text);
+
+    // Inside the name of the 50th typedef
+    const std::size_t offset = source.find("Alias50") + 5;
+    edit(offset, 0, "x");
+    expectSameAsFullParse();
+    EXPECT_EQ(file->typedefDecls[50]->name, Symbol::intern("Aliasx50"));
+    EXPECT_EQ(parser.stats().tokens_relexed, 1);
+    EXPECT_LE(parser.stats().declarations_reparsed, 6);
+    EXPECT_EQ(parser.stats().declarations_reused + parser.stats().declarations_reparsed, 100);
+
+    edit(offset, 1, "");
+    expectSameAsFullParse();
+}
+
+TEST_F(IncrementalParserTest, EditsThatChangeDeclarationBoundaries) {
+    parse("typedef A B;\ntypedef C D;\npublic typedef E F;\ntypedef G H;\n");
+
+    // Merging two declarations by removing a semicolon
+    edit(source.find(';'), 1, "");
+    expectSameAsFullParse();
+
+    // And splitting them again
+    edit(source.find("\ntypedef C"), 0, ";");
+    expectSameAsFullParse();
+
+    // A modifier that now belongs to the declaration after it
+    edit(source.find("public"), 0, "static ");
+    expectSameAsFullParse();
+    EXPECT_EQ(file->typedefDecls[2]->modifiers, ArenaSpan<Modifier>::copyOf(arena, {Modifier::STATIC, Modifier::PUBLIC}));
+}
+
+TEST_F(IncrementalParserTest, EditsThatSwallowTheRestOfTheFile) {
+    parse("typedef A B;\ntypedef C D;\ntypedef E F;\n");
+
+    // Everything after an unterminated comment or string is gone
+    edit(source.find("typedef C"), 0, "/* ");
+    expectSameAsFullParse();
+    EXPECT_EQ(file->typedefDecls.size(), 1);
+
+    // Closing the comment brings it back
+    edit(source.find("typedef C"), 0, "*/ ");
+    expectSameAsFullParse();
+    EXPECT_EQ(file->typedefDecls.size(), 3);
+
+    edit(source.find("typedef E"), 0, "\"");
+    expectSameAsFullParse();
+    EXPECT_EQ(file->typedefDecls.size(), 2);
+}
+
+TEST_F(IncrementalParserTest, RandomEditsMatchAFullParse) {
+    std::string text;
+    for (int i = 0; i < 60; i++) {
+        const std::string n = std::to_string(i);
+        switch (i % 5) {
+            case 0: text += "typedef Base" + n + " Alias" + n + ";\n"; break;
+            case 1: text += "public static typedef T" + n + " U" + n + "; // trailing\n"; break;
+            case 2: text += "/* block " + n + " */ typedef Map M" + n + ";\n"; break;
+            case 3: text += "x" + n + " class Foo" + n + " { int y; }\n"; break;
+            default: text += "typedef \"str" + n + "\" 12 ;\n"; break;
+        }
+    }
+    parse(text);
+
+    const std::vector<std::string_view> snippets{
+        "a", "1", " ", "\n", ";", "{", "}", "/*", "*/", "//", "\"", "typedef ", "public ", "class ", "#", "Q R;",
+    };
+    std::mt19937 random{42};
+    for (int i = 0; i < 400; i++) {
+        const std::size_t offset = random() % (source.size() + 1);
+        const std::size_t removed = std::min<std::size_t>(random() % 4, source.size() - offset);
+        const std::string_view inserted = random() % 3 == 0 ? std::string_view{} : snippets[random() % snippets.size()];
+        edit(offset, removed, inserted);
+        SCOPED_TRACE("edit " + std::to_string(i));
+        expectSameAsFullParse();
+        if (HasFatalFailure()) return;
+    }
+}
@@ -0,0 +1,121 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../../include/parser/Parser.h"
+
+#ifdef KAHWA_SANITIZE
+#include <sanitizer/lsan_interface.h>
+#endif
+
+// Replaces the global allocation functions for the whole test binary, but only counts while a test asks
+// it to. The arena gets its blocks from malloc directly, so they are not counted.
+namespace {
+
+std::atomic<bool> counting = false;
+std::atomic<std::size_t> allocations = 0;
+
+void* countedAllocate(const std::size_t size) noexcept {
+    if (counting) allocations++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAllocateOrThrow(const std::size_t size) {
+    if (void* ptr = countedAllocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+}
+
+void* operator new(const std::size_t size) { return countedAllocateOrThrow(size); }
+void* operator new[](const std::size_t size) { return countedAllocateOrThrow(size); }
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+TEST(ParserAllocationTest, ParsingAllocatesOnlyInTheArena) {
+    std::string src;
+    for (int i = 0; i < 500; i++) {
+        const std::string n = std::to_string(i);
+        src += (i % 3 == 0 ? "public static typedef Base" : "typedef Base") + n + " Alias" + n + ";\n";
+    }
+
+    DiagnosticEngine diagnostic_engine;
+    const auto tokens = Tokeniser{diagnostic_engine}.tokenise(SourceLocation{0}, src);
+    // One block holds everything, the arena's own bookkeeping for a second one would count too
+    Arena arena{1024 * 1024};
+    Parser parser{arena, diagnostic_engine};
+
+    allocations = 0;
+    counting = true;
+    const KahwaFile* file = parser.parseFile(tokens);
+    counting = false;
+
+    EXPECT_EQ(allocations, 0);
+    ASSERT_EQ(file->typedefDecls.size(), 500);
+    EXPECT_EQ(file->typedefDecls[3]->modifiers, ArenaSpan<Modifier>::copyOf(arena, {Modifier::PUBLIC, Modifier::STATIC}));
+    EXPECT_TRUE(file->typedefDecls[4]->modifiers.empty());
+    EXPECT_TRUE(diagnostic_engine.getAll().empty());
+}
+
+// A long-running service parsing file after file into one arena. Once the arena has grown to fit the
+// largest file it should neither grow nor leak, which a KAHWA_SANITIZE build checks with LeakSanitizer.
+TEST(ParserAllocationTest, ReusedArenaNeitherGrowsNorLeaks) {
+    Arena arena;
+    std::size_t blocks = 0;
+    for (int i = 0; i < 10'000; i++) {
+        std::string src;
+        for (int j = 0; j < 20 + i % 50; j++) {
+            src += "private typedef T" + std::to_string(j) + " U" + std::to_string(i % 100) + ";\n";
+        }
+        src += "typedef ;"; // and one diagnostic
+
+        arena.reset();
+        DiagnosticEngine diagnostic_engine;
+        const auto tokens = Tokeniser{diagnostic_engine}.tokenise(SourceLocation{0}, src);
+        const KahwaFile* file = Parser{arena, diagnostic_engine}.parseFile(tokens);
+        ASSERT_EQ(file->typedefDecls.size(), 20 + i % 50);
+        ASSERT_EQ(diagnostic_engine.getAll().size(), 1);
+
+        if (i == 50) blocks = arena.stats().block_count;
+    }
+    EXPECT_EQ(arena.stats().block_count, blocks);
+
+#ifdef KAHWA_SANITIZE
+    EXPECT_EQ(__lsan_do_recoverable_leak_check(), 0);
+#endif
+}
+
+// Recovering from an error skips tokens through the stream's lookahead and looks the diagnostic kind up in a
+// table. Messages are rendered only when read, so the only allocations left are the engine's chunks
+TEST(ParserAllocationTest, ErrorRecoveryAllocatesOnlyForDiagnostics) {
+    std::string src;
+    for (int i = 0; i < 500; i++) {
+        src += i % 2 == 0 ? "typedef Base ; { } ( ) 1 ;\n" : "public typedef Base Alias\n";
+    }
+
+    DiagnosticEngine diagnostic_engine;
+    const auto tokens = Tokeniser{diagnostic_engine}.tokenise(SourceLocation{0}, src);
+    Arena arena{1024 * 1024};
+    Parser parser{arena, diagnostic_engine};
+
+    allocations = 0;
+    counting = true;
+    (void) parser.parseFile(tokens);
+    counting = false;
+
+    const std::size_t diagnostics = diagnostic_engine.getAll().size();
+    ASSERT_GE(diagnostics, 500);
+    // One per chunk of 64 diagnostics, and the thread's shard
+    EXPECT_LE(allocations, diagnostics / 64 + 4) << diagnostics << " diagnostics";
+}
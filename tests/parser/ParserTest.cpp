@@ -24,45 +24,50 @@ protected:
     }
 
     [[nodiscard]] KahwaFile* parseFile(const std::string &str) const {
-        return parser.parseFile(tokeniser.tokenise(0, str));
+        return parser.parseFile(tokeniser.tokenise(SourceLocation{0}, str));
     }
 
-    SourceRange dummy_source = {0, 0};
+    SourceRange dummy_source{SourceLocation{0}};
+
+    template <typename T>
+    ArenaSpan<T> copy(const std::vector<T>& values) {
+        return ArenaSpan<T>::copyOf(astArena, values);
+    }
 
     KahwaFile* createKahwaFile(const std::vector<TypedefDecl*> &typedefDecls = {},
         const std::vector<ClassDecl*> &classDecls = {},
         const std::vector<MethodDecl*> &functionDecls = {},
         const std::vector<FieldDecl*> &variableDecls = {}) {
-        return astArena.make<KahwaFile>(typedefDecls, classDecls, functionDecls, variableDecls);
+        return astArena.make<KahwaFile>(copy(typedefDecls), copy(classDecls), copy(functionDecls), copy(variableDecls));
     }
 
     TypedefDecl* createTypedefDecl(const std::string &name,
         const std::vector<Modifier>& modifiers = {},
         TypeRef* referredType = nullptr) {
-        return astArena.make<TypedefDecl>(name, modifiers, referredType, dummy_source, dummy_source, dummy_source);
+        return astArena.make<TypedefDecl>(Symbol::intern(name), copy(modifiers), referredType, dummy_source, dummy_source, dummy_source);
     }
 
     TypeRef* createTypeRef(const std::string& identifier,
         const std::vector<TypeRef*> &args = {}) {
-        return astArena.make<TypeRef>(identifier, args);
+        return astArena.make<TypeRef>(Symbol::intern(identifier), copy(args));
     }
 
     FieldDecl* createFieldDecl(const std::string& name,
         const std::vector<Modifier> &modifiers = {},
         TypeRef* type = nullptr) {
-        return astArena.make<FieldDecl>(name, modifiers, type, dummy_source, dummy_source, dummy_source);
+        return astArena.make<FieldDecl>(Symbol::intern(name), copy(modifiers), type, dummy_source, dummy_source, dummy_source);
     }
 
     MethodDecl* createMethodDecl(const std::string& name,
         const std::vector<Modifier> &modifiers = {},
         TypeRef* returnType = nullptr,
-        const std::vector<std::pair<TypeRef*, std::string>>& parameters = {},
+        const std::vector<std::pair<TypeRef*, Symbol>>& parameters = {},
         Block* block = nullptr) {
-        return astArena.make<MethodDecl>(name, modifiers, returnType, parameters, block, dummy_source, dummy_source, dummy_source);
+        return astArena.make<MethodDecl>(Symbol::intern(name), copy(modifiers), returnType, copy(parameters), block, dummy_source, dummy_source, dummy_source);
     }
 
     Block* createBlock(const std::vector<Stmt*>& stmts = {}) {
-        return astArena.make<Block>(stmts);
+        return astArena.make<Block>(copy(stmts));
     }
 
     ClassDecl* createClassDecl(const std::string& name,
@@ -71,7 +76,7 @@ protected:
         const std::vector<FieldDecl*> &fields = {},
         const std::vector<MethodDecl*> &methods = {},
         const std::vector<ClassDecl*> &nestedClasses = {}) {
-        return astArena.make<ClassDecl>(name, dummy_source, dummy_source, dummy_source, modifiers, superClasses, fields, methods, nestedClasses);
+        return astArena.make<ClassDecl>(Symbol::intern(name), dummy_source, dummy_source, dummy_source, copy(modifiers), copy(superClasses), copy(fields), copy(methods), copy(nestedClasses));
     }
 
     static bool declEqualIgnoreSourceRange(const Decl* d1, const Decl* d2) {
@@ -243,4 +248,42 @@ TEST_F(ParserTest, ParsesMultipleTypedefsCorrectly) {
     EXPECT_PRED2(kahwaFileEqualIgnoreSourceRange, parseFile(str1 + str3), createKahwaFile({typedefDecl1, typedefDecl3}));
     EXPECT_PRED2(kahwaFileEqualIgnoreSourceRange, parseFile(str2 + str3), createKahwaFile({typedefDecl2, typedefDecl3}));
     EXPECT_PRED2(kahwaFileEqualIgnoreSourceRange, parseFile(str1 + str2 + str3), createKahwaFile({typedefDecl1, typedefDecl2, typedefDecl3}));
-}
\ No newline at end of file
+}
+
+TEST_F(ParserTest, SuppressesCascadingErrorsUntilADeclarationParses) {
+    const std::string str = "typedef ; typedef ; typedef A B; typedef ;";
+
+    (void) parseFile(str);
+    EXPECT_EQ(diagnostic_engine.getAll().size(), 3);
+
+    DiagnosticEngine suppressing{DiagnosticOptions{.suppress_cascades = true}};
+    (void) Parser{astArena, suppressing}.parseFile(Tokeniser{suppressing}.tokenise(SourceLocation{0}, str));
+    const auto& diagnostics = suppressing.getAll();
+    ASSERT_EQ(diagnostics.size(), 2);
+    // The first and the last typedef, the second is a cascade of the first
+    EXPECT_EQ(diagnostics[0].source_range, SourceRange(SourceLocation{0}, 7));
+    EXPECT_EQ(diagnostics[1].source_range, SourceRange(SourceLocation{33}, 7));
+    EXPECT_EQ(suppressing.stats().cascades, 1);
+}
+
+TEST_F(ParserTest, KeepsLexicalErrorsWhileRecovering) {
+    // Lexed lazily, so the tokeniser reports from inside the parser's recovery regions
+    const std::string str = "typedef ; @ # typedef A ; \"unterminated";
+
+    DiagnosticEngine suppressing{DiagnosticOptions{.suppress_cascades = true}};
+    TokenStream tokens = Tokeniser{suppressing}.stream(SourceLocation{0}, str);
+    (void) Parser{astArena, suppressing}.parseFile(tokens);
+
+    std::vector<DiagnosticKind> kinds;
+    for (const auto& diagnostic : suppressing.getAll()) kinds.push_back(diagnostic.kind);
+    const std::vector expected{
+        DiagnosticKind::EXPECTED_IDENTIFIER,
+        DiagnosticKind::UNRECOGNISED_TOKEN,
+        DiagnosticKind::UNRECOGNISED_TOKEN,
+        DiagnosticKind::UNTERMINATED_STRING_LITERAL,
+    };
+    EXPECT_EQ(kinds, expected);
+    EXPECT_EQ(suppressing.getAll()[1].source_range.begin, SourceLocation{10});
+    // The second typedef's missing name is a cascade of the first error
+    EXPECT_EQ(suppressing.stats().cascades, 1);
+}
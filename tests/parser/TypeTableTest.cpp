@@ -0,0 +1,77 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "../../include/parser/Parser.h"
+#include "../../include/parser/TypeTable.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+class TypeTableTest : public testing::Test {
+protected:
+    Arena arena;
+    TypeTable types{arena};
+
+    const Symbol map = Symbol::intern("Map");
+    const Symbol string = Symbol::intern("String");
+    const Symbol integer = Symbol::intern("int");
+};
+
+TEST_F(TypeTableTest, IdenticalTypesShareANode) {
+    TypeRef* a = types.intern(map, {types.intern(string), types.intern(integer)});
+    TypeRef* b = types.intern(map, {types.intern(string), types.intern(integer)});
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a->identifier, map);
+    EXPECT_EQ(a->args, ArenaSpan<TypeRef*>::copyOf(arena, {types.intern(string), types.intern(integer)}));
+
+    EXPECT_EQ(types.stats().total, 8);
+    EXPECT_EQ(types.stats().unique, 3);
+}
+
+TEST_F(TypeTableTest, DifferentTypesGetDifferentNodes) {
+    TypeRef* str = types.intern(string);
+    TypeRef* num = types.intern(integer);
+    const std::vector distinct{
+        types.intern(map),
+        types.intern(map, {str}),
+        types.intern(map, {str, num}),
+        types.intern(map, {num, str}),
+        types.intern(map, {types.intern(map, {str})}),
+        types.intern(string, {str, num}),
+    };
+    for (std::size_t i = 0; i < distinct.size(); i++) {
+        for (std::size_t j = 0; j < i; j++) {
+            EXPECT_NE(distinct[i], distinct[j]) << i << " " << j;
+            EXPECT_NE(*distinct[i], *distinct[j]) << i << " " << j;
+        }
+    }
+}
+
+TEST_F(TypeTableTest, KeepsEveryTypeAcrossGrowth) {
+    std::vector<TypeRef*> interned;
+    for (int i = 0; i < 1000; i++) {
+        interned.push_back(types.intern(map, {types.intern(Symbol::intern("T" + std::to_string(i)))}));
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(types.intern(map, {types.intern(Symbol::intern("T" + std::to_string(i)))}), interned[i]) << i;
+    }
+    EXPECT_EQ(types.stats().unique, 2000);
+    EXPECT_EQ(types.stats().total, 4000);
+}
+
+TEST(TypeTableParserTest, ParserSharesTypesAcrossFiles) {
+    DiagnosticEngine diagnostic_engine;
+    Arena arena;
+    const Parser parser{arena, diagnostic_engine};
+    const Tokeniser tokeniser{diagnostic_engine};
+
+    const KahwaFile* first = parser.parseFile(tokeniser.tokenise(SourceLocation{0}, "typedef Map A; typedef List B; typedef Map C;"));
+    const KahwaFile* second = parser.parseFile(tokeniser.tokenise(SourceLocation{100}, "typedef List D;"));
+
+    EXPECT_EQ(first->typedefDecls[0]->referredType, first->typedefDecls[2]->referredType);
+    EXPECT_NE(first->typedefDecls[0]->referredType, first->typedefDecls[1]->referredType);
+    EXPECT_EQ(second->typedefDecls[0]->referredType, first->typedefDecls[1]->referredType);
+    EXPECT_EQ(parser.typeStats().total, 4);
+    EXPECT_EQ(parser.typeStats().unique, 2);
+}
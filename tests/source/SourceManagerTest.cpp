@@ -0,0 +1,152 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <thread>
+
+#include <sys/stat.h>
+
+#include "../../include/source/SourceManager.h"
+
+class SourceManagerTest : public testing::Test {
+protected:
+    std::filesystem::path dir;
+    SourceManager source_manager;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / ("kahwa_source_manager_test_" + std::to_string(getpid()));
+        std::filesystem::create_directories(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    [[nodiscard]] std::filesystem::path write(const std::string& name, const std::string& contents) const {
+        const auto path = dir / name;
+        std::ofstream{path} << contents;
+        return path;
+    }
+};
+
+TEST_F(SourceManagerTest, LoadsContents) {
+    const auto id = source_manager.addFile(write("a.kahwa", "typedef int myInt;\n"));
+    EXPECT_EQ(source_manager.getSource(id), "typedef int myInt;\n");
+    EXPECT_EQ(source_manager.getPath(id), std::filesystem::canonical(dir / "a.kahwa"));
+
+    const std::string large(100'000, 'y');
+    EXPECT_EQ(source_manager.getSource(source_manager.addFile(write("large.kahwa", large))), large);
+
+    const auto empty = source_manager.addFile(write("empty.kahwa", ""));
+    EXPECT_EQ(source_manager.getSource(empty), "");
+    EXPECT_EQ(source_manager.fileCount(), 3);
+}
+
+TEST_F(SourceManagerTest, SamePathGivesSameId) {
+    const auto path = write("a.kahwa", "a");
+    const auto id = source_manager.addFile(path);
+
+    std::filesystem::create_directories(dir / "sub");
+    EXPECT_EQ(source_manager.addFile(path), id);
+    EXPECT_EQ(source_manager.addFile(dir / "sub" / ".." / "." / "a.kahwa"), id);
+    EXPECT_NE(source_manager.addFile(write("b.kahwa", "a")), id);
+    EXPECT_EQ(source_manager.fileCount(), 2);
+}
+
+TEST_F(SourceManagerTest, ContentsNeverMove) {
+    const auto first = source_manager.addFile(write("first.kahwa", "first"));
+    const std::string_view view = source_manager.getSource(first);
+
+    for (int i = 0; i < 500; i++) {
+        source_manager.addFile(write(std::to_string(i) + ".kahwa", std::to_string(i)));
+    }
+
+    EXPECT_EQ(source_manager.getSource(first).data(), view.data());
+    EXPECT_EQ(view, "first");
+}
+
+TEST_F(SourceManagerTest, ReadsFifosIntoBuffers) {
+    const auto path = dir / "pipe.kahwa";
+    ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+
+    const std::string contents(200'000, 'x');
+    std::thread writer([&] { std::ofstream{path} << contents; });
+    const auto id = source_manager.addFile(path);
+    writer.join();
+
+    EXPECT_EQ(source_manager.getSource(id), contents);
+}
+
+TEST_F(SourceManagerTest, ThrowsForMissingFiles) {
+    EXPECT_THROW(source_manager.addFile(dir / "missing.kahwa"), std::filesystem::filesystem_error);
+}
+
+TEST_F(SourceManagerTest, MapsOffsetsToLinesAndColumns) {
+    const auto id = source_manager.addFile(write("lines.kahwa", "typedef A B;\r\n\nclass C {\n}"));
+
+    EXPECT_EQ(source_manager.lineCount(id), 4);
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 0)), (LineColumn{1, 1}));
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 8)), (LineColumn{1, 9}));
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 13)), (LineColumn{1, 14})); // the '\n'
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 14)), (LineColumn{2, 1}));
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 21)), (LineColumn{3, 7}));
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, 26)), (LineColumn{4, 2})); // end of file
+
+    EXPECT_EQ(source_manager.getLineText(id, 1), "typedef A B;");
+    EXPECT_EQ(source_manager.getLineText(id, 2), "");
+    EXPECT_EQ(source_manager.getLineText(id, 3), "class C {");
+    EXPECT_EQ(source_manager.getLineText(id, 4), "}");
+
+    const auto empty = source_manager.addFile(write("empty.kahwa", ""));
+    EXPECT_EQ(source_manager.lineCount(empty), 1);
+    EXPECT_EQ(source_manager.getLineColumn(source_manager.getLocation(empty, 0)), (LineColumn{1, 1}));
+    EXPECT_EQ(source_manager.getLineText(empty, 1), "");
+}
+
+TEST_F(SourceManagerTest, LineTablesMatchLinearScanOnLargeFiles) {
+    std::string contents;
+    for (int i = 0; i < 5000; i++) contents += std::string(i % 83, 'x') + "\n";
+    const auto id = source_manager.addFile(write("large.kahwa", contents));
+
+    LineColumn expected{1, 1};
+    for (std::size_t pos = 0; pos <= contents.size(); pos++) {
+        ASSERT_EQ(source_manager.getLineColumn(source_manager.getLocation(id, pos)), expected) << pos;
+        if (pos < contents.size() && contents[pos] == '\n') {
+            expected = {expected.line + 1, 1};
+        } else {
+            expected.column++;
+        }
+    }
+}
+
+TEST_F(SourceManagerTest, LaysFilesOutInOneLocationSpace) {
+    const std::vector<std::string> contents{"class A {}", "", std::string(20'000, 'z'), "typedef A B;\n"};
+    std::vector<std::size_t> ids;
+    for (std::size_t i = 0; i < contents.size(); i++) {
+        ids.push_back(source_manager.addFile(write("file" + std::to_string(i) + ".kahwa", contents[i])));
+    }
+
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < ids.size(); i++) {
+        EXPECT_EQ(source_manager.getFileStart(ids[i]), SourceLocation{start});
+        // Every offset of the file, its end included, maps back to it
+        for (const std::size_t pos : {std::size_t{0}, contents[i].length() / 2, contents[i].length()}) {
+            const SourceLocation location = source_manager.getLocation(ids[i], pos);
+            EXPECT_EQ(location, SourceLocation{start + pos});
+            EXPECT_EQ(source_manager.getFileId(location), ids[i]);
+            EXPECT_EQ(source_manager.getFileOffset(location), pos);
+        }
+        start += contents[i].length() + 1;
+    }
+    EXPECT_EQ(source_manager.endOffset(), start);
+
+    // Re-adding a file does not take up more of the space
+    source_manager.addFile(dir / "file0.kahwa");
+    EXPECT_EQ(source_manager.endOffset(), start);
+
+    const auto [line, column] = source_manager.getLineColumn(source_manager.getLocation(ids[3], 8));
+    EXPECT_EQ(line, 1);
+    EXPECT_EQ(column, 9);
+}
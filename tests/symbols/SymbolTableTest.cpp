@@ -0,0 +1,71 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "../../include/symbols/SymbolTable.h"
+
+class SymbolTableTest : public testing::Test {
+protected:
+    SymbolTable symbols;
+};
+
+TEST_F(SymbolTableTest, InterningSameStringGivesSameSymbol) {
+    const Symbol a = symbols.intern("myVariable");
+    const Symbol b = symbols.intern(std::string{"my"} + "Variable");
+    const Symbol c = symbols.intern("myOtherVariable");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(symbols.get(a), "myVariable");
+    EXPECT_EQ(symbols.get(c), "myOtherVariable");
+}
+
+TEST_F(SymbolTableTest, KeywordsArePreSeeded) {
+    for (const auto type : KEYWORD_TYPES) {
+        const auto symbol = symbols.find(keywordToString(type));
+        ASSERT_TRUE(symbol.has_value());
+        EXPECT_EQ(symbols.keyword(*symbol), type);
+    }
+
+    EXPECT_EQ(symbols.keyword(symbols.intern("_class")), std::nullopt);
+    EXPECT_EQ(symbols.find("notYetInterned"), std::nullopt);
+}
+
+TEST_F(SymbolTableTest, SymbolsStayValidWhileTableGrows) {
+    const Symbol first = symbols.intern("first");
+    const std::string& first_str = symbols.get(first);
+
+    std::vector<Symbol> interned;
+    for (int i = 0; i < 100'000; i++) {
+        interned.push_back(symbols.intern("identifier_" + std::to_string(i)));
+    }
+
+    EXPECT_EQ(&symbols.get(first), &first_str);
+    EXPECT_EQ(symbols.intern("first"), first);
+    for (int i = 0; i < 100'000; i++) {
+        EXPECT_EQ(symbols.get(interned[i]), "identifier_" + std::to_string(i));
+    }
+}
+
+TEST_F(SymbolTableTest, ConcurrentInterningAgreesOnSymbols) {
+    constexpr int THREADS = 8;
+    constexpr int N = 10'000;
+    std::vector<std::vector<Symbol>> results(THREADS);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < N; i++) {
+                results[t].push_back(symbols.intern("name" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int t = 1; t < THREADS; t++) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+}
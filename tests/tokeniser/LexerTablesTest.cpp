@@ -0,0 +1,88 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "../../include/tokeniser/LexerTables.h"
+#include "../../include/tokeniser/Tokeniser.h"
+#include "ReferenceTokeniser.h"
+#include "TokeniserCorpus.h"
+
+class LexerTablesTest : public testing::Test {
+protected:
+    // Same tokens, source ranges, payloads and diagnostics as the switch lexer
+    static void expectMatchesReference(const std::string& input) {
+        DiagnosticEngine expected_diagnostics;
+        const auto expected = ReferenceTokeniser{SourceLocation{0}, input, expected_diagnostics}.tokenise();
+
+        DiagnosticEngine actual_diagnostics;
+        const auto actual = Tokeniser{actual_diagnostics}.tokenise(SourceLocation{0}, input);
+
+        ASSERT_EQ(actual.size(), expected.size()) << "input: " << input;
+        for (std::size_t i = 0; i < actual.size(); i++) {
+            EXPECT_EQ(actual[i].type, expected[i].type) << "input: " << input << ", token " << i;
+            EXPECT_EQ(actual[i].getSourceRange(), expected[i].getSourceRange()) << "input: " << input << ", token " << i;
+            EXPECT_EQ(toString(actual[i]), toString(expected[i])) << "input: " << input << ", token " << i;
+        }
+        EXPECT_EQ(actual_diagnostics.getAll(), expected_diagnostics.getAll()) << "input: " << input;
+    }
+};
+
+TEST_F(LexerTablesTest, EverySpellingIsRecognised) {
+    for (const auto& [type, spelling] : TOKEN_SPELLINGS) {
+        if (isKeywordSpelling(spelling)) {
+            EXPECT_EQ(matchKeyword(spelling), type);
+        } else {
+            const OperatorMatch match = matchOperator(spelling, 0);
+            EXPECT_EQ(match.type, type);
+            EXPECT_EQ(match.length, spelling.length());
+        }
+    }
+
+    EXPECT_EQ(matchKeyword("classes"), std::nullopt);
+    EXPECT_EQ(matchKeyword("Class"), std::nullopt);
+    EXPECT_EQ(matchKeyword("x"), std::nullopt);
+    EXPECT_EQ(matchOperator("#", 0).length, 0);
+    EXPECT_EQ(matchOperator("", 0).length, 0);
+}
+
+TEST_F(LexerTablesTest, MatchesReferenceOnTokeniserTestCorpus) {
+    for (const auto& input : ROUND_TRIP_CORPUS) expectMatchesReference(input);
+    for (const auto& input : EDGE_CASE_CORPUS) expectMatchesReference(input);
+
+    for (int i = -1000; i < 1000; i++) expectMatchesReference(std::to_string(i));
+
+    std::mt19937 gen{7};
+    std::uniform_real_distribution<> dist(-100.0, 100.0);
+    for (int i = 0; i < 1000; i++) expectMatchesReference(std::to_string(static_cast<float>(dist(gen))));
+
+    for (const auto* str : {"\"abc\"", "\"\"", "\"abc123 \t 123 Weird char Φ abc\"", "\"a\" \"b"}) {
+        expectMatchesReference(str);
+    }
+}
+
+TEST_F(LexerTablesTest, MatchesReferenceOnSpellingCombinations) {
+    for (const auto& first : TOKEN_SPELLINGS) {
+        for (const auto& second : TOKEN_SPELLINGS) {
+            const std::string a{first.spelling};
+            const std::string b{second.spelling};
+            // Adjacent spellings exercise maximal munch and keyword prefixes
+            expectMatchesReference(a + b);
+            expectMatchesReference(a + " \n" + b + "\t\r" + a);
+        }
+    }
+}
+
+TEST_F(LexerTablesTest, MatchesReferenceOnRandomInput) {
+    constexpr std::string_view ALPHABET = "=<>!+-*/%&|^?.:;,{}[]() \n\t\"#_abcfiotnlsr019";
+    std::mt19937 gen{42};
+    for (int i = 0; i < 20'000; i++) {
+        std::string input;
+        for (std::size_t length = gen() % 40; length > 0; length--) {
+            input += ALPHABET[gen() % ALPHABET.size()];
+        }
+        expectMatchesReference(input);
+    }
+}
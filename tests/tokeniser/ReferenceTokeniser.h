@@ -0,0 +1,302 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef REFERENCETOKENISER_H
+#define REFERENCETOKENISER_H
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../../include/diagnostics/DiagnosticEngine.h"
+#include "../../include/symbols/SymbolTable.h"
+#include "../../include/tokeniser/Token.h"
+
+
+// The hand-written switch lexer the table-driven tokeniser replaced, kept verbatim (bar the helpers,
+// which no longer go through std::function, and locations, which are now global offsets) to cross-check
+// the generated tables against.
+class ReferenceTokeniser {
+public:
+    ReferenceTokeniser(const SourceLocation file_start, const std::string_view str, DiagnosticEngine& diagnostic_engine): file_start(file_start), str(str), diagnostic_engine(diagnostic_engine) {}
+
+    std::vector<Token> tokenise() {
+        std::vector<Token> tokens;
+        while (const auto token = lexToken()) {
+            tokens.push_back(*token);
+        }
+        return tokens;
+    }
+
+private:
+    std::size_t idx = 0;
+
+    const SourceLocation file_start;
+    const std::string_view str;
+    DiagnosticEngine& diagnostic_engine;
+
+    inline static const std::string DELIMITERS = " \t\r\n\f";
+
+    [[nodiscard]] SourceRange rangeAt(const std::size_t pos, const std::size_t length = 1) const {
+        return SourceRange{SourceLocation{file_start.offset + pos}, length};
+    }
+
+    std::optional<Token> lexToken() {
+        std::optional<Token> token;
+        while (!token && idx < str.length()) {
+            const std::size_t curr_idx = idx;
+            char c = str[idx++];
+            if (DELIMITERS.find(c) != std::string::npos) continue;
+
+            switch (c) {
+                case ':' :
+                    token.emplace(TokenType::COLON, rangeAt(curr_idx));
+                    break;
+                case ';' :
+                    token.emplace(TokenType::SEMI_COLON, rangeAt(curr_idx));
+                    break;
+                case ',' :
+                    token.emplace(TokenType::COMMA, rangeAt(curr_idx));
+                    break;
+                case '{' :
+                    token.emplace(TokenType::LEFT_CURLY_BRACE, rangeAt(curr_idx));
+                    break;
+                case '}' :
+                    token.emplace(TokenType::RIGHT_CURLY_BRACE, rangeAt(curr_idx));
+                    break;
+                case '(' :
+                    token.emplace(TokenType::LEFT_PAREN, rangeAt(curr_idx));
+                    break;
+                case ')' :
+                    token.emplace(TokenType::RIGHT_PAREN, rangeAt(curr_idx));
+                    break;
+                case '[' :
+                    token.emplace(TokenType::LEFT_BRACKET, rangeAt(curr_idx));
+                    break;
+                case ']' :
+                    token.emplace(TokenType::RIGHT_BRACKET, rangeAt(curr_idx));
+                    break;
+                case '=' :
+                    if (next_is("=")) {
+                        token.emplace(TokenType::DOUBLE_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::EQUALS, rangeAt(curr_idx));
+                    }
+                    break;
+                case '<' :
+                    if (next_is("<=")) {
+                        token.emplace(TokenType::LEFT_SHIFT_EQUALS, rangeAt(curr_idx, 3));
+                        idx += 2;
+                    } else if (next_is("<")) {
+                        token.emplace(TokenType::LEFT_SHIFT, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::LESS_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::LESS, rangeAt(curr_idx));
+                    }
+                    break;
+                case '>' :
+                    if (next_is(">=")) {
+                        token.emplace(TokenType::RIGHT_SHIFT_EQUALS, rangeAt(curr_idx, 3));
+                        idx += 2;
+                    } else if (next_is(">")) {
+                        token.emplace(TokenType::RIGHT_SHIFT, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::GREATER_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::GREATER, rangeAt(curr_idx));
+                    }
+                    break;
+                case '!' :
+                    if (next_is("=")) {
+                        token.emplace(TokenType::NOT_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::NOT, rangeAt(curr_idx));
+                    }
+                    break;
+                case '+' :
+                    if (next_is("+")) {
+                        token.emplace(TokenType::INCREMENT, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::PLUS_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::PLUS, rangeAt(curr_idx));
+                    }
+                    break;
+                case '-' :
+                    if (next_is("-")) {
+                        token.emplace(TokenType::DECREMENT, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::MINUS_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::MINUS, rangeAt(curr_idx));
+                    }
+                    break;
+                case '*' :
+                    if (next_is("=")) {
+                        token.emplace(TokenType::STAR_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::STAR, rangeAt(curr_idx));
+                    }
+                    break;
+                case '/' :
+                    if (next_is("/")) {
+                        idx++;
+                        // `idx < str.length()` to avoid infinite looping
+                        while (idx < str.length() && !next_is("\n")) { idx++; }
+                    } else if (next_is("*")) {
+                        idx++;
+                        // `idx < str.length()` to avoid infinite looping
+                        while (idx < str.length()) {
+                            if (next_is("*/")) {
+                                idx += 2;
+                                break;
+                            }
+                            idx++;
+                        }
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::SLASH_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::SLASH, rangeAt(curr_idx));
+                    }
+                    break;
+                case '%' :
+                    if (next_is("=")) {
+                        token.emplace(TokenType::MODULO_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::MODULO, rangeAt(curr_idx));
+                    }
+                    break;
+                case '&' :
+                    if (next_is("&")) {
+                        token.emplace(TokenType::LOGICAL_AND, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::BITWISE_AND_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::BITWISE_AND, rangeAt(curr_idx));
+                    }
+                    break;
+                case '|' :
+                    if (next_is("|")) {
+                        token.emplace(TokenType::LOGICAL_OR, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else if (next_is("=")) {
+                        token.emplace(TokenType::BITWISE_OR_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::BITWISE_OR, rangeAt(curr_idx));
+                    }
+                    break;
+                case '^' :
+                    if (next_is("=")) {
+                        token.emplace(TokenType::BITWISE_XOR_EQUALS, rangeAt(curr_idx, 2));
+                        idx++;
+                    } else {
+                        token.emplace(TokenType::BITWISE_XOR, rangeAt(curr_idx));
+                    }
+                    break;
+                case '?' :
+                    token.emplace(TokenType::QUESTION, rangeAt(curr_idx));
+                    break;
+                case '.' :
+                    token.emplace(TokenType::DOT, rangeAt(curr_idx));
+                    break;
+                case '\"': {
+                    if (auto maybeToken = tokeniseString(curr_idx)) {
+                        token = maybeToken;
+                    } else {
+                        diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNTERMINATED_STRING_LITERAL, rangeAt(curr_idx));
+                        idx = str.length();
+                        return std::nullopt;
+                    }
+                    break;
+                }
+                default:
+                    if (std::isdigit(c)) {
+                        idx--;
+                        std::string num_string_1 = getNumberString();
+                        if (next_is(".")) {
+                            idx++;
+                            std::string num_string_2 = getNumberString();
+                            if (num_string_2.empty()) {
+                                int num = std::stoi(num_string_1);
+                                token.emplace(TokenType::INTEGER, num, rangeAt(curr_idx, num_string_1.length()));
+                                idx--;
+                            } else {
+                                std::string s = num_string_1;
+                                s.append(".");
+                                s.append(num_string_2);
+                                float num = std::stof(s);
+
+                                token.emplace(TokenType::FLOAT, num, rangeAt(curr_idx, s.length()));
+                            }
+                        } else {
+                            int num = std::stoi(num_string_1);
+                            token.emplace(TokenType::INTEGER, num, rangeAt(curr_idx, num_string_1.length()));
+                        }
+                    } else if (std::isalpha(c) || c == '_') {
+                        idx--;
+                        const std::string_view identifier_like = extractIdentifierLike();
+                        const Symbol symbol = Symbol::intern(identifier_like);
+                        if (const auto keyword = SymbolTable::global().keyword(symbol)) {
+                            token.emplace(*keyword, rangeAt(curr_idx, identifier_like.length()));
+                        } else {
+                            token.emplace(TokenType::IDENTIFIER, symbol, rangeAt(curr_idx, identifier_like.length()));
+                        }
+                    } else {
+                        token.emplace(TokenType::BAD, std::to_string(c), rangeAt(curr_idx));
+                        diagnostic_engine.reportProblem(DiagnosticSeverity::ERROR, DiagnosticKind::UNRECOGNISED_TOKEN, rangeAt(curr_idx));
+                    }
+            }
+        }
+
+        return token;
+    }
+
+    std::optional<Token> tokeniseString(const std::size_t curr_idx) {
+        while (idx < str.length()) {
+            char c = str[idx++];
+            if (c == '\"') {
+                const std::string_view s = str.substr(curr_idx + 1, idx - curr_idx - 2);
+                return Token{TokenType::STRING_LITERAL, s, rangeAt(curr_idx, s.length() + 2)};
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string getNumberString() {
+        const std::size_t start = idx;
+        while (idx < str.length() && std::isdigit(str[idx])) idx++;
+        return std::string{str.substr(start, idx - start)};
+    }
+
+    std::string_view extractIdentifierLike() {
+        const std::size_t start = idx++;
+        while (idx < str.length() && (std::isalnum(static_cast<unsigned char>(str[idx])) || str[idx] == '_')) idx++;
+        return str.substr(start, idx - start);
+    }
+
+    [[nodiscard]] bool next_is(const std::string_view expected) const {
+        return str.substr(std::min(idx, str.length()), expected.length()) == expected;
+    }
+};
+
+
+
+#endif //REFERENCETOKENISER_H
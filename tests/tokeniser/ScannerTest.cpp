@@ -0,0 +1,97 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "../../include/tokeniser/Scanner.h"
+#include "../../include/tokeniser/Tokeniser.h"
+
+namespace {
+
+using ScanFunction = const char* (*)(const char*, const char*);
+
+std::vector<Scanner::Level> supportedLevels() {
+    std::vector<Scanner::Level> levels;
+    for (const auto level : {Scanner::Level::SCALAR, Scanner::Level::SSE2, Scanner::Level::AVX2}) {
+        if (Scanner::isSupported(level)) levels.push_back(level);
+    }
+    return levels;
+}
+
+// Every start offset, so runs straddle block boundaries and end in the scalar tail
+void expectMatchesScalar(const std::string& buffer, ScanFunction Scanner::Functions::* function) {
+    const ScanFunction scalar = Scanner::functionsFor(Scanner::Level::SCALAR).*function;
+    const char* end = buffer.data() + buffer.size();
+    for (const auto level : supportedLevels()) {
+        const ScanFunction vector = Scanner::functionsFor(level).*function;
+        for (std::size_t start = 0; start < buffer.size(); start++) {
+            const char* p = buffer.data() + start;
+            ASSERT_EQ(vector(p, end) - buffer.data(), scalar(p, end) - buffer.data())
+                << "level " << static_cast<int>(level) << ", start " << start;
+        }
+    }
+}
+
+// Long runs of each class of byte, with the occasional byte >= 0x80
+std::string randomBuffer(std::mt19937& rng, const std::size_t size) {
+    static constexpr std::string_view ALPHABETS[] = {
+        " \t\r\n\f", "abcxyzABCXYZ_0123456789", "0123456789", "*/*/ *", "\"\n\\", "{};=+-<>.\x80\xff",
+    };
+    std::string buffer;
+    while (buffer.size() < size) {
+        const std::string_view alphabet = ALPHABETS[rng() % std::size(ALPHABETS)];
+        for (std::size_t run = rng() % 48; run > 0 && buffer.size() < size; run--) {
+            buffer += alphabet[rng() % alphabet.size()];
+        }
+    }
+    return buffer;
+}
+
+}
+
+TEST(ScannerTest, ScalarIsAlwaysSupported) {
+    EXPECT_TRUE(Scanner::isSupported(Scanner::Level::SCALAR));
+    EXPECT_TRUE(Scanner::isSupported(Scanner::bestLevel()));
+}
+
+TEST(ScannerTest, FindsEndOfEachRun) {
+    const std::string str = "  \t\nname_1 42x // c\n/* a * / b */\"s\"";
+    EXPECT_EQ(Scanner::skipWhitespace(str, 0), 4);
+    EXPECT_EQ(Scanner::skipIdentifierChars(str, 4), 10);
+    EXPECT_EQ(Scanner::skipDigits(str, 11), 13);
+    EXPECT_EQ(Scanner::findNewline(str, 15), 19);
+    EXPECT_EQ(Scanner::findCommentEnd(str, 22), 31);
+    EXPECT_EQ(Scanner::findQuote(str, 34), 35);
+
+    EXPECT_EQ(Scanner::skipWhitespace(str, str.length()), str.length());
+    EXPECT_EQ(Scanner::findCommentEnd("/* never closed *", 2), 17);
+}
+
+TEST(ScannerTest, VectorLevelsMatchScalarOnRandomBuffers) {
+    std::mt19937 rng{42};
+    for (const std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 100, 517}) {
+        const std::string buffer = randomBuffer(rng, size);
+        expectMatchesScalar(buffer, &Scanner::Functions::skipWhitespace);
+        expectMatchesScalar(buffer, &Scanner::Functions::findNewline);
+        expectMatchesScalar(buffer, &Scanner::Functions::findCommentEnd);
+        expectMatchesScalar(buffer, &Scanner::Functions::findQuote);
+        expectMatchesScalar(buffer, &Scanner::Functions::skipIdentifierChars);
+        expectMatchesScalar(buffer, &Scanner::Functions::skipDigits);
+    }
+}
+
+TEST(ScannerTest, TokeniserSkipsLongCommentsAndWhitespace) {
+    DiagnosticEngine diagnostic_engine;
+    const std::string padding(200, ' ');
+    const std::string comment = "/*" + std::string(300, '*') + " // \"not a string\" */";
+    const std::string src = padding + "a" + comment + "\n\n" + padding + "// " + std::string(100, 'x') + "\n" + std::string(70, 'b') + padding;
+
+    const auto tokens = Tokeniser{diagnostic_engine}.tokenise(SourceLocation{0}, src);
+
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].getSourceRange(), SourceRange{SourceLocation{200}});
+    EXPECT_EQ(tokens[1].getSourceRange().length(), 70);
+    EXPECT_TRUE(diagnostic_engine.getAll().empty());
+}
@@ -0,0 +1,94 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#include <gtest/gtest.h>
+
+#include "../../include/tokeniser/TokenStream.h"
+#include "../../include/parser/Parser.h"
+
+class TokenStreamTest : public testing::Test {
+protected:
+    DiagnosticEngine diagnostic_engine;
+    Tokeniser tokeniser{diagnostic_engine};
+
+    static std::vector<TokenType> drain(TokenStream& stream) {
+        std::vector<TokenType> types;
+        while (!stream.atEnd()) types.push_back(stream.advance().type);
+        return types;
+    }
+
+    static std::vector<TokenType> toTokenType(const std::vector<Token>& tokens) {
+        std::vector<TokenType> types;
+        for (const auto& token : tokens) types.push_back(token.type);
+        return types;
+    }
+};
+
+TEST_F(TokenStreamTest, StreamYieldsSameTokensAsTokenise) {
+    std::string str;
+    for (int i = 0; i < 1000; i++) {
+        str += "public typedef Some" + std::to_string(i) + " Other /* comment */ ; x <<= 12 + 3.5; // done\n";
+    }
+
+    TokenStream stream = tokeniser.stream(SourceLocation{0}, str);
+    EXPECT_EQ(drain(stream), toTokenType(tokeniser.tokenise(SourceLocation{0}, str)));
+}
+
+TEST_F(TokenStreamTest, PeekLooksAheadWithoutConsuming) {
+    const std::string str = "class A { } ;";
+    TokenStream stream = tokeniser.stream(SourceLocation{0}, str);
+
+    ASSERT_NE(stream.peek(4), nullptr);
+    EXPECT_EQ(stream.peek(4)->type, TokenType::SEMI_COLON);
+    EXPECT_EQ(stream.peek(5), nullptr);
+    EXPECT_EQ(stream.peek(0)->type, TokenType::CLASS);
+
+    EXPECT_EQ(stream.advance().type, TokenType::CLASS);
+    EXPECT_EQ(stream.peek()->type, TokenType::IDENTIFIER);
+    EXPECT_EQ(*stream.peek()->getIf<std::string>(), "A");
+    EXPECT_EQ(stream.position(), 1);
+
+    EXPECT_EQ(drain(stream).size(), 4);
+    EXPECT_TRUE(stream.atEnd());
+    EXPECT_EQ(stream.peek(TokenStream::LOOKAHEAD - 1), nullptr);
+}
+
+TEST_F(TokenStreamTest, PeekIsBoundedByTheLookahead) {
+    std::string str;
+    for (std::size_t i = 0; i < TokenStream::LOOKAHEAD + 4; i++) str += "x" + std::to_string(i) + " ";
+    TokenStream stream = tokeniser.stream(SourceLocation{0}, str);
+
+    ASSERT_NE(stream.peek(TokenStream::LOOKAHEAD - 1), nullptr);
+    EXPECT_EQ(*stream.peek(TokenStream::LOOKAHEAD - 1)->getIf<std::string>(), "x" + std::to_string(TokenStream::LOOKAHEAD - 1));
+    EXPECT_THROW((void) stream.peek(TokenStream::LOOKAHEAD), std::out_of_range);
+
+    // The window is still intact after the overrun
+    EXPECT_EQ(*stream.advance().getIf<std::string>(), "x0");
+    EXPECT_EQ(*stream.peek(TokenStream::LOOKAHEAD - 1)->getIf<std::string>(), "x" + std::to_string(TokenStream::LOOKAHEAD));
+}
+
+TEST_F(TokenStreamTest, StreamOverMaterialisedTokens) {
+    const auto tokens = tokeniser.tokenise(SourceLocation{0}, "a b c");
+    TokenStream stream{tokens};
+
+    EXPECT_EQ(stream.peek(2)->getSourceRange().begin, SourceLocation{4});
+    EXPECT_EQ(drain(stream), toTokenType(tokens));
+}
+
+TEST_F(TokenStreamTest, ParserConsumesStreamDirectly) {
+    Arena arena;
+    const Parser parser{arena, diagnostic_engine};
+    const std::string str = "typedef int myInt; private typedef A B; typedef X;";
+
+    TokenStream stream = tokeniser.stream(SourceLocation{0}, str);
+    const KahwaFile* streamed = parser.parseFile(stream);
+    const auto streamed_diagnostics = diagnostic_engine.getAll();
+
+    DiagnosticEngine batch_diagnostics;
+    const KahwaFile* batch = Parser{arena, batch_diagnostics}.parseFile(tokeniser.tokenise(SourceLocation{0}, str));
+
+    EXPECT_EQ(*streamed, *batch);
+    EXPECT_EQ(streamed_diagnostics, batch_diagnostics.getAll());
+    EXPECT_EQ(streamed->typedefDecls.size(), 2);
+}
@@ -8,16 +8,16 @@
 
 class TokenTest : public testing::Test {
 protected:
-    SourceRange source_range = {0, 10, 5};
+    SourceRange source_range{SourceLocation{10}, 5};
 };
 
 TEST_F(TokenTest, CreateTokenWithoutData_ShouldHaveCorrectTypeAndSourceRange) {
     Token token(TokenType::COLON, source_range);
     
     EXPECT_EQ(token.type, TokenType::COLON);
-    EXPECT_EQ(token.source_range.file_id, 0);
-    EXPECT_EQ(token.source_range.pos, 10);
-    EXPECT_EQ(token.source_range.length, 5);
+    EXPECT_EQ(token.getSourceRange().begin, SourceLocation{10});
+    EXPECT_EQ(token.getSourceRange().end, SourceLocation{15});
+    EXPECT_EQ(token.getSourceRange().length(), 5);
 }
 
 TEST_F(TokenTest, CreateTokenWithStringData_ShouldStoreAndRetrieveCorrectly) {
@@ -78,27 +78,27 @@ TEST_F(TokenTest, TokenWithoutData_GetIfShouldReturnNull) {
 }
 
 TEST_F(TokenTest, TokenCannotBeCreatedWithWrongType) {
-    EXPECT_THROW((Token{TokenType::CHAR_LITERAL, "A string.", SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::CHAR_LITERAL, "A string.", SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::FLOAT, "Another string.", SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::FLOAT, "Another string.", SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::EQUALS, "Yet string.", SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::EQUALS, "Yet string.", SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::FLOAT, 1, SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::FLOAT, 1, SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::INTEGER, 1.0f, SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::INTEGER, 1.0f, SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::STRING_LITERAL, 1, SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::STRING_LITERAL, 1, SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
-    EXPECT_THROW((Token{TokenType::DOUBLE_EQUALS, 1, SourceRange{0, 0}}), std::invalid_argument);
+    EXPECT_THROW((Token{TokenType::DOUBLE_EQUALS, 1, SourceRange{SourceLocation{0}}}), std::invalid_argument);
 
     for (auto type: std::unordered_set{TokenType::IDENTIFIER, TokenType::STRING_LITERAL, TokenType::CHAR_LITERAL, TokenType::INTEGER, TokenType::FLOAT}) {
-        EXPECT_THROW((Token{type, SourceRange{0, 0}}), std::invalid_argument);
+        EXPECT_THROW((Token{type, SourceRange{SourceLocation{0}}}), std::invalid_argument);
     }
 
     for (auto type: KEYWORD_TYPES) {
-        EXPECT_THROW((Token{type, "Yet Yet string.", SourceRange{0, 0}}), std::invalid_argument);
-        EXPECT_THROW((Token{type, 1, SourceRange{0, 0}}), std::invalid_argument);
-        EXPECT_THROW((Token{type, 1.0f, SourceRange{0, 0}}), std::invalid_argument);
+        EXPECT_THROW((Token{type, "Yet Yet string.", SourceRange{SourceLocation{0}}}), std::invalid_argument);
+        EXPECT_THROW((Token{type, 1, SourceRange{SourceLocation{0}}}), std::invalid_argument);
+        EXPECT_THROW((Token{type, 1.0f, SourceRange{SourceLocation{0}}}), std::invalid_argument);
     }
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+//
+// Created by Agamjeet Singh on 17/10/26.
+//
+
+#ifndef TOKENISERCORPUS_H
+#define TOKENISERCORPUS_H
+#include <string>
+#include <vector>
+
+
+// Inputs whose tokens, laid back out at their source ranges, reproduce the input exactly
+inline const std::vector<std::string> ROUND_TRIP_CORPUS = {
+    // Basic tokens
+    "( ) { } [ ]",
+    ": ; ,",
+    "+ - * / %",
+    "< > = !",
+    "| ^ ? .",
+    
+    // Multi-character operators
+    "== != <= >=",
+    "+= -= *= /= %=",
+    "&= |= ^= <<= >>=",
+    "++ -- && ||",
+    "<< >>",
+    
+    // Keywords
+    "class interface",
+    "if else for while",
+    "return",
+    "true false null",
+    "public private protected",
+    "static final open abstract",
+
+    // Identifiers and literals
+    "abc _var var123 _123",
+    "MyClass someFunction CONSTANT",
+    "123 456 789",
+    "12.34 0.0 999.999",
+    R"("hello" "world with spaces")",
+
+    // Mixed expressions
+    "x = 42",
+    "array[index]",
+    "obj.method()",
+    "a + b * c",
+    "if (x > 0) return true",
+    "class MyClass : BaseClass",
+    "function foo() { return 42 }",
+    "var x = \"hello world\"",
+    "a += b++",
+    "x << 2 | y",
+    "!valid && ready",
+    
+    // Numeric edge cases
+    "0 1 999",
+    // "0.0 1.5 123.456",
+    "-42 +17",
+    // "1 + 2.0",
+
+    // String and character literals
+    R"("" "a" "longer string")",
+    R"("string")",
+    
+    // Operator combinations
+    "x++ + ++y",
+    "a-- - --b",
+    "x && y || z",
+    "a << b >> c",
+    "x ? y : z",
+    
+    // Function and class syntax
+    "class A { }",
+    "function f() { return 0 }",
+    "var arr = [ 1 , 2 , 3 ]",
+    "obj . prop = value",
+    "func ( arg1 , arg2 )",
+    
+    // Control flow
+    "if ( condition ) { }",
+    "for ( i = 0 ; i < 10 ; i++ )",
+    "while ( running ) continue",
+    "switch ( value ) { case 1 : break }",
+    
+    // Single characters that could be confused
+    "a b c",
+    "1 2 3",
+    ". , ;",
+    "( ) { } [ ]",
+    
+    // Empty and minimal cases
+    "x",
+    "42",
+    "\"\"",
+    "true",
+    
+    // Boundary cases
+    "+ +",
+    "- -",
+    "< <",
+    "> >",
+    "= =",
+    "! !",
+    "& &",
+    "| |",
+
+    // Multi space
+    "a   b",
+    "a   b  c d  e"
+};
+
+// The remaining hand-written inputs from TokeniserTest: comments, diagnostics and literal edge cases
+inline const std::vector<std::string> EDGE_CASE_CORPUS = {
+    "1.0",
+    "1.",
+    "1.a abc",
+    "\" Unterminated string! Oh no! \n \t \r",
+    "# Weird char",
+    "abc123 234 abc _123 123_",
+    "class MyClass : SomeOtherClass {\n void foo() { } \n}",
+    "class _class for for-who for() if",
+    "// This is a comment",
+    "// This is a comment \n tokenise normally",
+    "// This is a comment \t This too is part of the comment \n123456 // Comment can begin after something too",
+    "/ / This is not a comment",
+    "/* This is a multi-line comment \n \n Part of comment \n */ tokenise normally",
+    "/*/ Doesn't close comment",
+    "class A /* Multi-line comments can begin after // \n \n // \n /* 123.456",
+    "/* Comment /* */ comment ended",
+    "/**/",
+    "//**/ A single line comment",
+};
+
+
+
+#endif //TOKENISERCORPUS_H